@@ -24,12 +24,16 @@
 #include "Job.h"
 #include "SessionsManager.h"
 
-#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QBuffer>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDir>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QSaveFile>
 #include <QtCore/QTextStream>
+#include <QtCore/QVarLengthArray>
 
 namespace Otter
 {
@@ -39,11 +43,11 @@ QHash<QString, AdblockContentFiltersProfile::RuleOption> AdblockContentFiltersPr
 QHash<NetworkManager::ResourceType, AdblockContentFiltersProfile::RuleOption> AdblockContentFiltersProfile::m_resourceTypes({{NetworkManager::ImageType, ImageOption}, {NetworkManager::ScriptType, ScriptOption}, {NetworkManager::StyleSheetType, StyleSheetOption}, {NetworkManager::ObjectType, ObjectOption}, {NetworkManager::XmlHttpRequestType, XmlHttpRequestOption}, {NetworkManager::SubFrameType, SubDocumentOption},{NetworkManager::PopupType, PopupOption}, {NetworkManager::ObjectSubrequestType, ObjectSubRequestOption}, {NetworkManager::WebSocketType, WebSocketOption}});
 
 AdblockContentFiltersProfile::AdblockContentFiltersProfile(const ContentFiltersProfile::ProfileSummary &profileSummary, const QStringList &languages, ContentFiltersProfile::ProfileFlags flags, QObject *parent) : ContentFiltersProfile(parent),
-	m_root(nullptr),
 	m_dataFetchJob(nullptr),
 	m_profileSummary(profileSummary),
 	m_error(NoError),
 	m_flags(flags),
+	m_rulesGeneration(0),
 	m_wasLoaded(false)
 {
 	if (languages.isEmpty())
@@ -70,16 +74,87 @@ void AdblockContentFiltersProfile::clear()
 		return;
 	}
 
-	if (m_root)
+	++m_rulesGeneration;
+
+	m_compiledRules.reset();
+	m_wasLoaded = false;
+
+	emit rulesChanged();
+}
+
+void AdblockContentFiltersProfile::loadRules()
+{
+	if (m_wasLoaded)
+	{
+		return;
+	}
+
+	const QString path(getPath());
+
+	m_error = NoError;
+
+	if (!QFile::exists(path) && !m_profileSummary.updateUrl.isEmpty())
+	{
+		update();
+
+		return;
+	}
+
+	m_wasLoaded = true;
+
+	if (!m_compiledRules)
 	{
-		QtConcurrent::run(this, &AdblockContentFiltersProfile::deleteNode, m_root);
+		m_compiledRules = loadCompiledRules(m_profileSummary, path, getCompiledRulesPath());
+
+		if (m_compiledRules)
+		{
+			emit rulesChanged();
+
+			return;
+		}
 	}
 
-	m_cosmeticFiltersRules.clear();
-	m_cosmeticFiltersDomainExceptions.clear();
-	m_cosmeticFiltersDomainRules.clear();
+	const int rulesGeneration(m_rulesGeneration);
+	QFutureWatcher<LoadingResult> *watcher(new QFutureWatcher<LoadingResult>(this));
+
+	connect(watcher, &QFutureWatcher<LoadingResult>::finished, this, [=]()
+	{
+		const LoadingResult result(watcher->result());
+
+		watcher->deleteLater();
+
+		if (rulesGeneration != m_rulesGeneration)
+		{
+			return;
+		}
+
+		if (result.error != NoError)
+		{
+			raiseError(result.message, result.error);
+		}
+		else if (!result.message.isEmpty())
+		{
+			Console::addMessage(result.message, Console::OtherCategory, Console::WarningLevel, getCompiledRulesPath());
+		}
+
+		if (result.rules)
+		{
+			m_compiledRules = result.rules;
+
+			emit rulesChanged();
+		}
+	});
+
+	watcher->setFuture(QtConcurrent::run(&AdblockContentFiltersProfile::createRules, m_profileSummary, path, getCompiledRulesPath()));
+}
+
+void AdblockContentFiltersProfile::reloadRules()
+{
+	++m_rulesGeneration;
 
 	m_wasLoaded = false;
+
+	loadRules();
 }
 
 void AdblockContentFiltersProfile::loadHeader()
@@ -122,7 +197,7 @@ void AdblockContentFiltersProfile::loadHeader()
 	}
 }
 
-void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
+void AdblockContentFiltersProfile::parseRuleLine(const QString &rule, const ProfileSummary &profileSummary, CompilationData &data)
 {
 	if (rule.isEmpty() || rule.startsWith(QLatin1Char('!')))
 	{
@@ -131,9 +206,9 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 
 	if (rule.startsWith(QLatin1String("##")))
 	{
-		if (m_profileSummary.cosmeticFiltersMode == ContentFiltersManager::AllFilters)
+		if (profileSummary.cosmeticFiltersMode == ContentFiltersManager::AllFilters)
 		{
-			m_cosmeticFiltersRules.append(rule.mid(2));
+			data.cosmeticFiltersRules.append(rule.mid(2));
 		}
 
 		return;
@@ -141,9 +216,9 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 
 	if (rule.contains(QLatin1String("##")))
 	{
-		if (m_profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
+		if (profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
 		{
-			parseStyleSheetRule(rule.split(QLatin1String("##")), m_cosmeticFiltersDomainRules);
+			parseStyleSheetRule(rule.split(QLatin1String("##")), data.cosmeticFiltersDomainRules);
 		}
 
 		return;
@@ -151,9 +226,9 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 
 	if (rule.contains(QLatin1String("#@#")))
 	{
-		if (m_profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
+		if (profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
 		{
-			parseStyleSheetRule(rule.split(QLatin1String("#@#")), m_cosmeticFiltersDomainExceptions);
+			parseStyleSheetRule(rule.split(QLatin1String("#@#")), data.cosmeticFiltersDomainExceptions);
 		}
 
 		return;
@@ -178,37 +253,37 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 		line = line.mid(1);
 	}
 
-	if (!m_profileSummary.areWildcardsEnabled && line.contains(QLatin1Char('*')))
+	if (!profileSummary.areWildcardsEnabled && line.contains(QLatin1Char('*')))
 	{
 		return;
 	}
 
-	Node::Rule *definition(new Node::Rule());
-	definition->rule = rule;
-	definition->isException = line.startsWith(QLatin1String("@@"));
+	Rule definition;
+	definition.rule = rule;
+	definition.isException = line.startsWith(QLatin1String("@@"));
 
-	if (definition->isException)
+	if (definition.isException)
 	{
 		line = line.mid(2);
 	}
 
-	definition->needsDomainCheck = line.startsWith(QLatin1String("||"));
+	definition.needsDomainCheck = line.startsWith(QLatin1String("||"));
 
-	if (definition->needsDomainCheck)
+	if (definition.needsDomainCheck)
 	{
 		line = line.mid(2);
 	}
 
 	if (line.startsWith(QLatin1Char('|')))
 	{
-		definition->ruleMatch = StartMatch;
+		definition.ruleMatch = StartMatch;
 
 		line = line.mid(1);
 	}
 
 	if (line.endsWith(QLatin1Char('|')))
 	{
-		definition->ruleMatch = ((definition->ruleMatch == StartMatch) ? ExactMatch : EndMatch);
+		definition.ruleMatch = ((definition.ruleMatch == StartMatch) ? ExactMatch : EndMatch);
 
 		line = line.left(line.length() - 1);
 	}
@@ -222,18 +297,18 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 		{
 			const RuleOption option(m_options.value(optionName));
 
-			if ((!definition->isException || optionException) && (option == ElementHideOption || option == GenericHideOption))
+			if ((!definition.isException || optionException) && (option == ElementHideOption || option == GenericHideOption))
 			{
 				continue;
 			}
 
 			if (!optionException)
 			{
-				definition->ruleOptions |= option;
+				definition.ruleOptions |= option;
 			}
 			else if (option != WebSocketOption && option != PopupOption)
 			{
-				definition->ruleExceptions |= option;
+				definition.ruleExceptions |= option;
 			}
 		}
 		else if (optionName.startsWith(QLatin1String("domain")))
@@ -244,12 +319,12 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 			{
 				if (parsedDomains.at(j).startsWith(QLatin1Char('~')))
 				{
-					definition->allowedDomains.append(parsedDomains.at(j).mid(1));
+					definition.allowedDomains.append(parsedDomains.at(j).mid(1));
 
 					continue;
 				}
 
-				definition->blockedDomains.append(parsedDomains.at(j));
+				definition.blockedDomains.append(parsedDomains.at(j));
 			}
 		}
 		else
@@ -258,46 +333,9 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 		}
 	}
 
-	Node *node(m_root);
-
-	for (int i = 0; i < line.length(); ++i)
-	{
-		const QChar value(line.at(i));
-		bool childrenExists(false);
-
-		for (int j = 0; j < node->children.count(); ++j)
-		{
-			Node *nextNode(node->children.at(j));
-
-			if (nextNode->value == value)
-			{
-				node = nextNode;
-
-				childrenExists = true;
-
-				break;
-			}
-		}
-
-		if (!childrenExists)
-		{
-			Node *newNode(new Node());
-			newNode->value = value;
-
-			if (value == QLatin1Char('^'))
-			{
-				node->children.insert(0, newNode);
-			}
-			else
-			{
-				node->children.append(newNode);
-			}
-
-			node = newNode;
-		}
-	}
+	definition.pattern = line;
 
-	node->rules.append(definition);
+	data.rules.append(definition);
 }
 
 void AdblockContentFiltersProfile::parseStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list)
@@ -310,257 +348,6 @@ void AdblockContentFiltersProfile::parseStyleSheetRule(const QStringList &line,
 	}
 }
 
-void AdblockContentFiltersProfile::deleteNode(Node *node) const
-{
-	for (int i = 0; i < node->children.count(); ++i)
-	{
-		deleteNode(node->children.at(i));
-	}
-
-	for (int i = 0; i < node->rules.count(); ++i)
-	{
-		delete node->rules.at(i);
-	}
-
-	delete node;
-}
-
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstring(const Node *node, const QString &subString, QString currentRule, const Request &request) const
-{
-	ContentFiltersManager::CheckResult result;
-	ContentFiltersManager::CheckResult currentResult;
-
-	for (int i = 0; i < subString.length(); ++i)
-	{
-		const QChar treeChar(subString.at(i));
-		bool childrenExists(false);
-
-		currentResult = evaluateNodeRules(node, currentRule, request);
-
-		if (currentResult.isBlocked)
-		{
-			result = currentResult;
-		}
-		else if (currentResult.isException)
-		{
-			return currentResult;
-		}
-
-		for (int j = 0; j < node->children.count(); ++j)
-		{
-			const Node *nextNode(node->children.at(j));
-
-			if (nextNode->value == QLatin1Char('*'))
-			{
-				const QString wildcardSubString(subString.mid(i));
-
-				for (int k = 0; k < wildcardSubString.length(); ++k)
-				{
-					currentResult = checkUrlSubstring(nextNode, wildcardSubString.right(wildcardSubString.length() - k), (currentRule + wildcardSubString.left(k)), request);
-
-					if (currentResult.isBlocked)
-					{
-						result = currentResult;
-					}
-					else if (currentResult.isException)
-					{
-						return currentResult;
-					}
-				}
-			}
-
-			if (nextNode->value == QLatin1Char('^') && !treeChar.isDigit() && !treeChar.isLetter() && !m_separators.contains(treeChar))
-			{
-				currentResult = checkUrlSubstring(nextNode, subString.mid(i), currentRule, request);
-
-				if (currentResult.isBlocked)
-				{
-					result = currentResult;
-				}
-				else if (currentResult.isException)
-				{
-					return currentResult;
-				}
-			}
-
-			if (nextNode->value == treeChar)
-			{
-				node = nextNode;
-
-				childrenExists = true;
-
-				break;
-			}
-		}
-
-		if (!childrenExists)
-		{
-			return result;
-		}
-
-		currentRule += treeChar;
-	}
-
-	currentResult = evaluateNodeRules(node, currentRule, request);
-
-	if (currentResult.isBlocked)
-	{
-		result = currentResult;
-	}
-	else if (currentResult.isException)
-	{
-		return currentResult;
-	}
-
-	for (int i = 0; i < node->children.count(); ++i)
-	{
-		if (node->children.at(i)->value == QLatin1Char('^'))
-		{
-			currentResult = evaluateNodeRules(node, currentRule, request);
-
-			if (currentResult.isBlocked)
-			{
-				result = currentResult;
-			}
-			else if (currentResult.isException)
-			{
-				return currentResult;
-			}
-		}
-	}
-
-	return result;
-}
-
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(const Node::Rule *rule, const QString &currentRule, const Request &request) const
-{
-	switch (rule->ruleMatch)
-	{
-		case StartMatch:
-			if (!request.requestUrl.startsWith(currentRule))
-			{
-				return {};
-			}
-
-			break;
-		case EndMatch:
-			if (!request.requestUrl.endsWith(currentRule))
-			{
-				return {};
-			}
-
-			break;
-		case ExactMatch:
-			if (request.requestUrl != currentRule)
-			{
-				return {};
-			}
-
-			break;
-		default:
-			if (!request.requestUrl.contains(currentRule))
-			{
-				return {};
-			}
-
-			break;
-	}
-
-	const QStringList requestSubdomainList(ContentFiltersManager::createSubdomainList(request.requestHost));
-
-	if (rule->needsDomainCheck && !requestSubdomainList.contains(currentRule.left(currentRule.indexOf(m_domainExpression))))
-	{
-		return {};
-	}
-
-	const bool hasBlockedDomains(!rule->blockedDomains.isEmpty());
-	const bool hasAllowedDomains(!rule->allowedDomains.isEmpty());
-	bool isBlocked(true);
-
-	if (hasBlockedDomains)
-	{
-		isBlocked = resolveDomainExceptions(request.baseHost, rule->blockedDomains);
-
-		if (!isBlocked)
-		{
-			return {};
-		}
-	}
-
-	isBlocked = (hasAllowedDomains ? !resolveDomainExceptions(request.baseHost, rule->allowedDomains) : isBlocked);
-
-	if (rule->ruleOptions.testFlag(ThirdPartyOption) || rule->ruleExceptions.testFlag(ThirdPartyOption))
-	{
-		if (request.baseHost.isEmpty() || requestSubdomainList.contains(request.baseHost))
-		{
-			isBlocked = rule->ruleExceptions.testFlag(ThirdPartyOption);
-		}
-		else if (!hasBlockedDomains && !hasAllowedDomains)
-		{
-			isBlocked = rule->ruleOptions.testFlag(ThirdPartyOption);
-		}
-	}
-
-	if (rule->ruleOptions != NoOption || rule->ruleExceptions != NoOption)
-	{
-		QHash<NetworkManager::ResourceType, RuleOption>::const_iterator iterator;
-
-		for (iterator = m_resourceTypes.constBegin(); iterator != m_resourceTypes.constEnd(); ++iterator)
-		{
-			const bool supportsException(iterator.value() != WebSocketOption && iterator.value() != PopupOption);
-
-			if (rule->ruleOptions.testFlag(iterator.value()) || (supportsException && rule->ruleExceptions.testFlag(iterator.value())))
-			{
-				if (request.resourceType == iterator.key())
-				{
-					isBlocked = (isBlocked ? rule->ruleOptions.testFlag(iterator.value()) : isBlocked);
-				}
-				else if (supportsException)
-				{
-					isBlocked = (isBlocked ? rule->ruleExceptions.testFlag(iterator.value()) : isBlocked);
-				}
-				else
-				{
-					isBlocked = false;
-				}
-			}
-		}
-	}
-	else if (request.resourceType == NetworkManager::PopupType)
-	{
-		isBlocked = false;
-	}
-
-	if (isBlocked)
-	{
-		ContentFiltersManager::CheckResult result;
-		result.rule = rule->rule;
-
-		if (rule->isException)
-		{
-			result.isBlocked = false;
-			result.isException = true;
-
-			if (rule->ruleOptions.testFlag(ElementHideOption))
-			{
-				result.comesticFiltersMode = ContentFiltersManager::NoFilters;
-			}
-			else if (rule->ruleOptions.testFlag(GenericHideOption))
-			{
-				result.comesticFiltersMode = ContentFiltersManager::DomainOnlyFilters;
-			}
-
-			return result;
-		}
-
-		result.isBlocked = true;
-
-		return result;
-	}
-
-	return {};
-}
-
 void AdblockContentFiltersProfile::raiseError(const QString &message, ProfileError error)
 {
 	m_error = error;
@@ -578,6 +365,8 @@ void AdblockContentFiltersProfile::handleJobFinished(bool isSuccess)
 	}
 
 	QIODevice *device(m_dataFetchJob->getData());
+	const QUrl url(m_dataFetchJob->getUrl());
+	const bool isNotModified(m_dataFetchJob->isNotModified());
 
 	m_dataFetchJob->deleteLater();
 	m_dataFetchJob = nullptr;
@@ -589,6 +378,15 @@ void AdblockContentFiltersProfile::handleJobFinished(bool isSuccess)
 		return;
 	}
 
+	if (isNotModified)
+	{
+		m_profileSummary.lastUpdate = QDateTime::currentDateTimeUtc();
+
+		emit profileModified();
+
+		return;
+	}
+
 	QBuffer buffer;
 	buffer.setData(device->readAll());
 	buffer.open(QIODevice::ReadOnly | QIODevice::Text);
@@ -619,17 +417,24 @@ void AdblockContentFiltersProfile::handleJobFinished(bool isSuccess)
 
 	m_profileSummary.lastUpdate = QDateTime::currentDateTimeUtc();
 
-	if (!file.commit())
+	if (file.commit())
+	{
+		DataFetchJob::commitValidators(url);
+	}
+	else
 	{
 		Console::addMessage(QCoreApplication::translate("main", "Failed to update content blocking profile: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
 	}
 
-	clear();
 	loadHeader();
 
 	if (m_wasLoaded)
 	{
-		loadRules();
+		reloadRules();
+	}
+	else
+	{
+		QtConcurrent::run(&AdblockContentFiltersProfile::createRules, m_profileSummary, getPath(), getCompiledRulesPath());
 	}
 
 	emit profileModified();
@@ -650,9 +455,9 @@ void AdblockContentFiltersProfile::setProfileSummary(const ContentFiltersProfile
 
 	m_profileSummary = profileSummary;
 
-	if (needsReload)
+	if (needsReload && m_wasLoaded)
 	{
-		clear();
+		reloadRules();
 	}
 
 	emit profileModified();
@@ -673,6 +478,11 @@ QString AdblockContentFiltersProfile::getPath() const
 	return SessionsManager::getWritableDataPath(QLatin1String("contentBlocking/%1.txt")).arg(m_profileSummary.name);
 }
 
+QString AdblockContentFiltersProfile::getCompiledRulesPath() const
+{
+	return SessionsManager::getWritableDataPath(QLatin1String("contentBlocking/%1.dat")).arg(m_profileSummary.name);
+}
+
 QDateTime AdblockContentFiltersProfile::getLastUpdate() const
 {
 	return m_profileSummary.lastUpdate;
@@ -683,124 +493,268 @@ QUrl AdblockContentFiltersProfile::getUpdateUrl() const
 	return m_profileSummary.updateUrl;
 }
 
-AdblockContentFiltersProfile::HeaderInformation AdblockContentFiltersProfile::loadHeader(QIODevice *rulesDevice)
+QByteArray AdblockContentFiltersProfile::createCompiledRules(const CompilationData &data, quint32 parsingFlags, const QByteArray &sourceHash, qint64 sourceSize, qint64 sourceModificationTime)
 {
-	HeaderInformation information;
-	QTextStream stream(rulesDevice);
-	stream.setCodec("UTF-8");
-
-	const QString header(stream.readLine());
+	QVector<CompiledToken> tokens;
+	QVector<CompiledRule> rules;
+	QVector<CompiledString> domains;
+	QVector<CompiledString> cosmeticRules;
+	QVector<CompiledCosmeticRule> cosmeticDomainRules;
+	QVector<CompiledCosmeticRule> cosmeticDomainExceptions;
+	QVector<QVector<quint32> > rulesTokens;
+	QHash<quint32, int> tokensFrequency;
+	QHash<QString, CompiledString> stringsCache;
+	QString strings;
+	const auto addString([&](const QString &string) -> CompiledString
+	{
+		if (stringsCache.contains(string))
+		{
+			return stringsCache[string];
+		}
 
-	if (!header.contains(QLatin1String("[Adblock"), Qt::CaseInsensitive))
-	{
-		information.errorString = QCoreApplication::translate("main", "Failed to update content blocking profile: invalid header");
-		information.error = ParseError;
+		CompiledString compiledString;
+		compiledString.offset = static_cast<quint32>(strings.length());
+		compiledString.length = static_cast<quint32>(string.length());
 
-		return information;
-	}
+		strings.append(string);
 
-	int lineNumber(1);
+		stringsCache[string] = compiledString;
 
-	while (!stream.atEnd())
+		return compiledString;
+	});
+	const auto addDomains([&](const QStringList &domainsList) -> CompiledSection
 	{
-		const QString line(stream.readLine().trimmed());
+		CompiledSection section;
+		section.offset = static_cast<quint32>(domains.count());
+		section.amount = static_cast<quint32>(domainsList.count());
 
-		if (line.startsWith(QLatin1String("! Title: ")))
+		for (int i = 0; i < domainsList.count(); ++i)
 		{
-			information.title = line.section(QLatin1Char(':'), 1).trimmed();
-
-			continue;
+			domains.append(addString(domainsList.at(i)));
 		}
 
-		if (lineNumber > 50)
+		return section;
+	});
+	const auto addCosmeticDomainRules([&](const QMultiHash<QString, QString> &source, QVector<CompiledCosmeticRule> &target)
+	{
+		QVector<QPair<QString, QString> > entries;
+		entries.reserve(source.count());
+
+		QMultiHash<QString, QString>::const_iterator iterator;
+
+		for (iterator = source.constBegin(); iterator != source.constEnd(); ++iterator)
 		{
-			break;
+			entries.append({iterator.key(), iterator.value()});
 		}
 
-		++lineNumber;
-	}
+		std::stable_sort(entries.begin(), entries.end(), [&](const QPair<QString, QString> &first, const QPair<QString, QString> &second)
+		{
+			return (first.first < second.first);
+		});
 
-	return information;
-}
+		target.reserve(entries.count());
 
-ContentFiltersProfile::ProfileSummary AdblockContentFiltersProfile::getProfileSummary() const
-{
-	return m_profileSummary;
-}
+		for (int i = 0; i < entries.count(); ++i)
+		{
+			CompiledCosmeticRule rule;
+			rule.domain = addString(entries.at(i).first);
+			rule.selector = addString(entries.at(i).second);
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::evaluateNodeRules(const Node *node, const QString &currentRule, const Request &request) const
-{
-	ContentFiltersManager::CheckResult result;
+			target.append(rule);
+		}
+	});
 
-	for (int i = 0; i < node->rules.count(); ++i)
+	rules.reserve(data.rules.count());
+	rulesTokens.reserve(data.rules.count());
+
+	for (int i = 0; i < data.rules.count(); ++i)
 	{
-		if (node->rules.at(i))
+		const QVector<quint32> ruleTokens(createPatternTokens(data.rules.at(i)));
+
+		for (int j = 0; j < ruleTokens.count(); ++j)
 		{
-			ContentFiltersManager::CheckResult currentResult(checkRuleMatch(node->rules.at(i), currentRule, request));
+			++tokensFrequency[ruleTokens.at(j)];
+		}
 
-			if (currentResult.isBlocked)
+		rulesTokens.append(ruleTokens);
+	}
+
+	tokens.reserve(data.rules.count());
+
+	for (int i = 0; i < data.rules.count(); ++i)
+	{
+		const Rule &rule(data.rules.at(i));
+		const QVector<quint32> &ruleTokens(rulesTokens.at(i));
+		CompiledToken token;
+		token.rule = static_cast<quint32>(i);
+
+		for (int j = 0; j < ruleTokens.count(); ++j)
+		{
+			if (token.hash == 0 || tokensFrequency.value(ruleTokens.at(j)) < tokensFrequency.value(token.hash))
 			{
-				result = currentResult;
+				token.hash = ruleTokens.at(j);
 			}
-			else if (currentResult.isException)
+		}
+
+		int domainLength(0);
+
+		if (rule.needsDomainCheck)
+		{
+			while (domainLength < rule.pattern.length() && !QString(QLatin1String(":?&/=^*|")).contains(rule.pattern.at(domainLength)))
 			{
-				return currentResult;
+				++domainLength;
 			}
 		}
+
+		CompiledRule compiledRule;
+		compiledRule.rule = addString(rule.rule);
+		compiledRule.pattern = addString(rule.pattern);
+		compiledRule.blockedDomains = addDomains(rule.blockedDomains);
+		compiledRule.allowedDomains = addDomains(rule.allowedDomains);
+		compiledRule.domainLength = static_cast<quint32>(domainLength);
+		compiledRule.ruleOptions = static_cast<quint16>(rule.ruleOptions);
+		compiledRule.ruleExceptions = static_cast<quint16>(rule.ruleExceptions);
+		compiledRule.ruleMatch = static_cast<quint8>(rule.ruleMatch);
+		compiledRule.isException = rule.isException;
+		compiledRule.needsDomainCheck = rule.needsDomainCheck;
+
+		rules.append(compiledRule);
+		tokens.append(token);
 	}
 
-	return result;
-}
+	std::stable_sort(tokens.begin(), tokens.end(), [&](const CompiledToken &first, const CompiledToken &second)
+	{
+		return (first.hash < second.hash);
+	});
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType)
-{
-	ContentFiltersManager::CheckResult result;
+	cosmeticRules.reserve(data.cosmeticFiltersRules.count());
 
-	if (!m_wasLoaded && !loadRules())
+	for (int i = 0; i < data.cosmeticFiltersRules.count(); ++i)
 	{
-		return result;
+		cosmeticRules.append(addString(data.cosmeticFiltersRules.at(i)));
 	}
 
-	const Request request(baseUrl, requestUrl, resourceType);
+	addCosmeticDomainRules(data.cosmeticFiltersDomainRules, cosmeticDomainRules);
+	addCosmeticDomainRules(data.cosmeticFiltersDomainExceptions, cosmeticDomainExceptions);
 
-	for (int i = 0; i < request.requestUrl.length(); ++i)
+	CompiledHeader header;
+	header.magic = CompiledRulesMagic;
+	header.version = CompiledRulesVersion;
+	header.sourceModificationTime = sourceModificationTime;
+	header.sourceSize = sourceSize;
+	header.parsingFlags = parsingFlags;
+
+	for (int i = 0; i < qMin(sourceHash.size(), static_cast<int>(sizeof(header.sourceHash))); ++i)
 	{
-		const ContentFiltersManager::CheckResult currentResult(checkUrlSubstring(m_root, request.requestUrl.right(request.requestUrl.length() - i), {}, request));
+		header.sourceHash[i] = sourceHash.at(i);
+	}
 
-		if (currentResult.isBlocked)
-		{
-			result = currentResult;
-		}
-		else if (currentResult.isException)
+	QByteArray compiledData(sizeof(CompiledHeader), 0);
+	const auto appendSection([&](const void *sectionData, int amount, int itemSize) -> CompiledSection
+	{
+		while ((compiledData.size() % 8) != 0)
 		{
-			return currentResult;
+			compiledData.append('\0');
 		}
-	}
 
-	return result;
+		CompiledSection section;
+		section.offset = static_cast<quint32>(compiledData.size());
+		section.amount = static_cast<quint32>(amount);
+
+		compiledData.append(static_cast<const char*>(sectionData), (amount * itemSize));
+
+		return section;
+	});
+
+	header.tokens = appendSection(tokens.constData(), tokens.count(), sizeof(CompiledToken));
+	header.rules = appendSection(rules.constData(), rules.count(), sizeof(CompiledRule));
+	header.domains = appendSection(domains.constData(), domains.count(), sizeof(CompiledString));
+	header.cosmeticRules = appendSection(cosmeticRules.constData(), cosmeticRules.count(), sizeof(CompiledString));
+	header.cosmeticDomainRules = appendSection(cosmeticDomainRules.constData(), cosmeticDomainRules.count(), sizeof(CompiledCosmeticRule));
+	header.cosmeticDomainExceptions = appendSection(cosmeticDomainExceptions.constData(), cosmeticDomainExceptions.count(), sizeof(CompiledCosmeticRule));
+	header.strings = appendSection(strings.constData(), strings.length(), sizeof(QChar));
+
+	compiledData.replace(0, sizeof(CompiledHeader), reinterpret_cast<const char*>(&header), sizeof(CompiledHeader));
+
+	return compiledData;
 }
 
-ContentFiltersManager::CosmeticFiltersResult AdblockContentFiltersProfile::getCosmeticFilters(const QStringList &domains, bool isDomainOnly)
+QByteArray AdblockContentFiltersProfile::createSourceHash(QIODevice *device)
 {
-	if (!m_wasLoaded)
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(device);
+
+	return hash.result();
+}
+
+QByteArray AdblockContentFiltersProfile::compileRules(const ProfileSummary &profileSummary, QFile *file)
+{
+	const QByteArray sourceHash(createSourceHash(file));
+	const qint64 sourceModificationTime(QFileInfo(*file).lastModified().toMSecsSinceEpoch());
+	CompilationData data;
+
+	file->reset();
+
+	QTextStream stream(file);
+	stream.setCodec("UTF-8");
+	stream.readLine(); // header
+
+	while (!stream.atEnd())
 	{
-		loadRules();
+		parseRuleLine(stream.readLine(), profileSummary, data);
 	}
 
-	ContentFiltersManager::CosmeticFiltersResult result;
+	return createCompiledRules(data, getParsingFlags(profileSummary), sourceHash, file->size(), sourceModificationTime);
+}
 
-	if (!isDomainOnly)
+AdblockContentFiltersProfile::HeaderInformation AdblockContentFiltersProfile::loadHeader(QIODevice *rulesDevice)
+{
+	HeaderInformation information;
+	QTextStream stream(rulesDevice);
+	stream.setCodec("UTF-8");
+
+	const QString header(stream.readLine());
+
+	if (!header.contains(QLatin1String("[Adblock"), Qt::CaseInsensitive))
 	{
-		result.rules = m_cosmeticFiltersRules;
+		information.errorString = QCoreApplication::translate("main", "Failed to update content blocking profile: invalid header");
+		information.error = ParseError;
+
+		return information;
 	}
 
-	for (int i = 0; i < domains.count(); ++i)
+	int lineNumber(1);
+
+	while (!stream.atEnd())
 	{
-		result.rules.append(m_cosmeticFiltersDomainRules.values(domains.at(i)));
-		result.exceptions.append(m_cosmeticFiltersDomainExceptions.values(domains.at(i)));
+		const QString line(stream.readLine().trimmed());
+
+		if (line.startsWith(QLatin1String("! Title: ")))
+		{
+			information.title = line.section(QLatin1Char(':'), 1).trimmed();
+
+			continue;
+		}
+
+		if (lineNumber > 50)
+		{
+			break;
+		}
+
+		++lineNumber;
 	}
 
-	return result;
+	return information;
+}
+
+ContentFiltersProfile::ProfileSummary AdblockContentFiltersProfile::getProfileSummary() const
+{
+	return m_profileSummary;
+}
+
+std::shared_ptr<const ContentFiltersRules> AdblockContentFiltersProfile::getRules() const
+{
+	return m_compiledRules;
 }
 
 QHash<AdblockContentFiltersProfile::RuleType, quint32> AdblockContentFiltersProfile::loadRulesInformation(const ContentFiltersProfile::ProfileSummary &profileSummary, QIODevice *rulesDevice)
@@ -900,6 +854,85 @@ ContentFiltersProfile::ProfileFlags AdblockContentFiltersProfile::getFlags() con
 	return m_flags;
 }
 
+QVector<quint32> AdblockContentFiltersProfile::createPatternTokens(const Rule &rule)
+{
+	QVector<quint32> tokens;
+	const QString &pattern(rule.pattern);
+	int tokenStart(-1);
+
+	for (int i = 0; i <= pattern.length(); ++i)
+	{
+		if (i < pattern.length() && isTokenCharacter(pattern.at(i)))
+		{
+			if (tokenStart < 0)
+			{
+				tokenStart = i;
+			}
+
+			continue;
+		}
+
+		if (tokenStart >= 0 && (i - tokenStart) > 1)
+		{
+			const bool hasStartBoundary((tokenStart > 0) ? (pattern.at(tokenStart - 1) != QLatin1Char('*')) : (rule.needsDomainCheck || rule.ruleMatch == StartMatch || rule.ruleMatch == ExactMatch));
+			const bool hasEndBoundary((i < pattern.length()) ? (pattern.at(i) != QLatin1Char('*')) : (rule.ruleMatch == EndMatch || rule.ruleMatch == ExactMatch));
+
+			if (hasStartBoundary && hasEndBoundary)
+			{
+				const quint32 hash(createTokenHash((pattern.constData() + tokenStart), (i - tokenStart)));
+
+				if (!tokens.contains(hash))
+				{
+					tokens.append(hash);
+				}
+			}
+		}
+
+		tokenStart = -1;
+	}
+
+	return tokens;
+}
+
+quint32 AdblockContentFiltersProfile::createTokenHash(const QChar *data, int length)
+{
+	quint32 hash(2166136261u);
+
+	for (int i = 0; i < length; ++i)
+	{
+		hash ^= data[i].toLower().unicode();
+		hash *= 16777619u;
+	}
+
+	return ((hash == 0) ? 1 : hash);
+}
+
+quint32 AdblockContentFiltersProfile::getParsingFlags(const ProfileSummary &profileSummary)
+{
+	quint32 flags(NoParsingFlags);
+
+	switch (profileSummary.cosmeticFiltersMode)
+	{
+		case ContentFiltersManager::AllFilters:
+			flags |= (DomainCosmeticFiltersFlag | GenericCosmeticFiltersFlag);
+
+			break;
+		case ContentFiltersManager::DomainOnlyFilters:
+			flags |= DomainCosmeticFiltersFlag;
+
+			break;
+		default:
+			break;
+	}
+
+	if (profileSummary.areWildcardsEnabled)
+	{
+		flags |= WildcardsFlag;
+	}
+
+	return flags;
+}
+
 int AdblockContentFiltersProfile::getUpdateInterval() const
 {
 	return m_profileSummary.updateInterval;
@@ -957,44 +990,89 @@ bool AdblockContentFiltersProfile::create(const ContentFiltersProfile::ProfileSu
 	return true;
 }
 
-bool AdblockContentFiltersProfile::loadRules()
+AdblockContentFiltersProfile::LoadingResult AdblockContentFiltersProfile::createRules(const ProfileSummary &profileSummary, const QString &path, const QString &compiledPath)
 {
-	const QString path(getPath());
+	LoadingResult result;
+	result.rules = loadCompiledRules(profileSummary, path, compiledPath);
 
-	m_error = NoError;
+	if (result.rules)
+	{
+		return result;
+	}
 
-	if (!QFile::exists(path) && !m_profileSummary.updateUrl.isEmpty())
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
 	{
-		update();
+		result.message = QCoreApplication::translate("main", "Failed to open content blocking profile file: %1").arg(file.errorString());
+		result.error = ReadError;
 
-		return false;
+		return result;
 	}
 
-	m_wasLoaded = true;
+	const QByteArray data(compileRules(profileSummary, &file));
+
+	file.close();
 
-	if (m_domainExpression.pattern().isEmpty())
+	if (!SessionsManager::isReadOnly())
 	{
-		m_domainExpression = QRegularExpression(QLatin1String("[:\?&/=]"));
-		m_domainExpression.optimize();
+		QSaveFile compiledFile(compiledPath);
+
+		if (compiledFile.open(QIODevice::WriteOnly) && compiledFile.write(data) == data.size() && compiledFile.commit())
+		{
+			result.rules = loadCompiledRules(profileSummary, path, compiledPath);
+
+			if (result.rules)
+			{
+				return result;
+			}
+		}
+		else
+		{
+			result.message = QCoreApplication::translate("main", "Failed to save compiled content blocking profile: %1").arg(compiledFile.errorString());
+		}
 	}
 
-	QFile file(path);
-	file.open(QIODevice::ReadOnly | QIODevice::Text);
+	std::shared_ptr<CompiledRules> rules(std::make_shared<CompiledRules>());
 
-	QTextStream stream(&file);
-	stream.setCodec("UTF-8");
-	stream.readLine(); // header
+	if (rules->setData(data))
+	{
+		result.rules = rules;
+	}
+
+	return result;
+}
 
-	m_root = new Node();
+std::shared_ptr<const AdblockContentFiltersProfile::CompiledRules> AdblockContentFiltersProfile::loadCompiledRules(const ProfileSummary &profileSummary, const QString &path, const QString &compiledPath)
+{
+	QFile *file(new QFile(compiledPath));
 
-	while (!stream.atEnd())
+	if (!file->open(QIODevice::ReadOnly))
+	{
+		delete file;
+
+		return nullptr;
+	}
+
+	const QFileInfo sourceInformation(path);
+	std::shared_ptr<CompiledRules> rules(std::make_shared<CompiledRules>());
+
+	if (!rules->setFile(file) || rules->getHeader()->parsingFlags != getParsingFlags(profileSummary) || rules->getHeader()->sourceSize != sourceInformation.size())
 	{
-		parseRuleLine(stream.readLine());
+		return nullptr;
 	}
 
-	file.close();
+	if (rules->getHeader()->sourceModificationTime != sourceInformation.lastModified().toMSecsSinceEpoch())
+	{
+		QFile sourceFile(path);
 
-	return true;
+		if (!sourceFile.open(QIODevice::ReadOnly) || createSourceHash(&sourceFile) != QByteArray(rules->getHeader()->sourceHash, sizeof(rules->getHeader()->sourceHash)))
+		{
+			return nullptr;
+		}
+	}
+
+	return rules;
 }
 
 bool AdblockContentFiltersProfile::update(const QUrl &url)
@@ -1021,6 +1099,7 @@ bool AdblockContentFiltersProfile::update(const QUrl &url)
 	}
 
 	m_dataFetchJob = new DataFetchJob(updateUrl, this);
+	m_dataFetchJob->setConditional(updateUrl == m_profileSummary.updateUrl && QFile::exists(getPath()));
 
 	connect(m_dataFetchJob, &Job::jobFinished, this, &AdblockContentFiltersProfile::handleJobFinished);
 	connect(m_dataFetchJob, &Job::progressChanged, this, &AdblockContentFiltersProfile::updateProgressChanged);
@@ -1043,6 +1122,8 @@ bool AdblockContentFiltersProfile::remove()
 		m_dataFetchJob = nullptr;
 	}
 
+	QFile::remove(getCompiledRulesPath());
+
 	if (QFile::exists(path))
 	{
 		return QFile::remove(path);
@@ -1051,34 +1132,536 @@ bool AdblockContentFiltersProfile::remove()
 	return true;
 }
 
-bool AdblockContentFiltersProfile::resolveDomainExceptions(const QString &url, const QStringList &ruleList) const
+bool AdblockContentFiltersProfile::matchesPattern(const QString &pattern, const QString &url, int position, bool needsEndMatch)
 {
-	for (int i = 0; i < ruleList.count(); ++i)
+	int patternIndex(0);
+	int urlIndex(position);
+	int wildcardPatternIndex(-1);
+	int wildcardUrlIndex(-1);
+
+	while (true)
 	{
-		if (url.contains(ruleList.at(i)))
+		if (patternIndex == pattern.length())
 		{
-			return true;
+			if (!needsEndMatch || urlIndex == url.length())
+			{
+				return true;
+			}
 		}
-	}
+		else
+		{
+			const QChar character(pattern.at(patternIndex));
 
-	return false;
-}
+			if (character == QLatin1Char('*'))
+			{
+				wildcardPatternIndex = patternIndex;
+				wildcardUrlIndex = urlIndex;
 
-bool AdblockContentFiltersProfile::areWildcardsEnabled() const
-{
-	return m_profileSummary.areWildcardsEnabled;
-}
+				++patternIndex;
 
-bool AdblockContentFiltersProfile::isFraud(const QUrl &url)
-{
-	Q_UNUSED(url)
+				continue;
+			}
 
-	return false;
-}
+			if (character == QLatin1Char('^') && urlIndex == url.length())
+			{
+				++patternIndex;
 
-bool AdblockContentFiltersProfile::isUpdating() const
-{
-	return (m_dataFetchJob != nullptr);
+				continue;
+			}
+
+			if (urlIndex < url.length() && ((character == QLatin1Char('^')) ? isSeparator(url.at(urlIndex)) : (character == url.at(urlIndex))))
+			{
+				++patternIndex;
+				++urlIndex;
+
+				continue;
+			}
+		}
+
+		if (wildcardPatternIndex < 0 || wildcardUrlIndex >= url.length())
+		{
+			return false;
+		}
+
+		++wildcardUrlIndex;
+
+		patternIndex = (wildcardPatternIndex + 1);
+		urlIndex = wildcardUrlIndex;
+	}
+}
+
+bool AdblockContentFiltersProfile::areWildcardsEnabled() const
+{
+	return m_profileSummary.areWildcardsEnabled;
+}
+
+bool AdblockContentFiltersProfile::isFraud(const QUrl &url)
+{
+	Q_UNUSED(url)
+
+	return false;
+}
+
+bool AdblockContentFiltersProfile::isUpdating() const
+{
+	return (m_dataFetchJob != nullptr);
+}
+
+bool AdblockContentFiltersProfile::isSeparator(QChar character)
+{
+	return (!character.isDigit() && !character.isLetter() && !m_separators.contains(character));
+}
+
+bool AdblockContentFiltersProfile::isTokenCharacter(QChar character)
+{
+	return (character.isLetterOrNumber() || character == QLatin1Char('%'));
+}
+
+AdblockContentFiltersProfile::CompiledRules::CompiledRules() : ContentFiltersRules(),
+	m_file(nullptr),
+	m_header(nullptr),
+	m_tokens(nullptr),
+	m_rules(nullptr),
+	m_domains(nullptr),
+	m_cosmeticRules(nullptr),
+	m_cosmeticDomainRules(nullptr),
+	m_cosmeticDomainExceptions(nullptr),
+	m_strings(nullptr)
+{
+}
+
+AdblockContentFiltersProfile::CompiledRules::~CompiledRules()
+{
+	delete m_file;
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::CompiledRules::checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType) const
+{
+	ContentFiltersManager::CheckResult result;
+
+	if (!m_header)
+	{
+		return result;
+	}
+
+	const Request request(baseUrl, requestUrl, resourceType);
+	QVarLengthArray<quint32, 64> hashes;
+	hashes.append(0);
+
+	int tokenStart(-1);
+
+	for (int i = 0; i <= request.requestUrl.length(); ++i)
+	{
+		if (i < request.requestUrl.length() && isTokenCharacter(request.requestUrl.at(i)))
+		{
+			if (tokenStart < 0)
+			{
+				tokenStart = i;
+			}
+
+			continue;
+		}
+
+		if (tokenStart >= 0 && (i - tokenStart) > 1)
+		{
+			const quint32 hash(createTokenHash((request.requestUrl.constData() + tokenStart), (i - tokenStart)));
+
+			if (std::find(hashes.begin(), hashes.end(), hash) == hashes.end())
+			{
+				hashes.append(hash);
+			}
+		}
+
+		tokenStart = -1;
+	}
+
+	const CompiledToken *tokensBegin(m_tokens);
+	const CompiledToken *tokensEnd(m_tokens + m_header->tokens.amount);
+
+	for (int i = 0; i < hashes.count(); ++i)
+	{
+		const quint32 hash(hashes.at(i));
+		const CompiledToken *token(std::lower_bound(tokensBegin, tokensEnd, hash, [&](const CompiledToken &compiledToken, quint32 value)
+		{
+			return (compiledToken.hash < value);
+		}));
+
+		while (token != tokensEnd && token->hash == hash)
+		{
+			const ContentFiltersManager::CheckResult currentResult(checkRuleMatch(&m_rules[token->rule], request));
+
+			if (currentResult.isBlocked)
+			{
+				result = currentResult;
+			}
+			else if (currentResult.isException)
+			{
+				return currentResult;
+			}
+
+			++token;
+		}
+	}
+
+	return result;
+}
+
+ContentFiltersManager::CosmeticFiltersResult AdblockContentFiltersProfile::CompiledRules::getCosmeticFilters(const QStringList &domains, bool isDomainOnly) const
+{
+	ContentFiltersManager::CosmeticFiltersResult result;
+
+	if (!m_header)
+	{
+		return result;
+	}
+
+	if (!isDomainOnly)
+	{
+		result.rules.reserve(static_cast<int>(m_header->cosmeticRules.amount));
+
+		for (quint32 i = 0; i < m_header->cosmeticRules.amount; ++i)
+		{
+			result.rules.append(getString(m_cosmeticRules[i]));
+		}
+	}
+
+	for (int i = 0; i < domains.count(); ++i)
+	{
+		result.rules.append(getCosmeticDomainRules(m_cosmeticDomainRules, m_header->cosmeticDomainRules.amount, domains.at(i)));
+		result.exceptions.append(getCosmeticDomainRules(m_cosmeticDomainExceptions, m_header->cosmeticDomainExceptions.amount, domains.at(i)));
+	}
+
+	return result;
+}
+
+QStringList AdblockContentFiltersProfile::CompiledRules::getCosmeticDomainRules(const CompiledCosmeticRule *rules, quint32 amount, const QString &domain) const
+{
+	const CompiledCosmeticRule *end(rules + amount);
+	const CompiledCosmeticRule *iterator(std::lower_bound(rules, end, domain, [&](const CompiledCosmeticRule &rule, const QString &value)
+	{
+		return (getRawString(rule.domain) < value);
+	}));
+	QStringList selectors;
+
+	while (iterator != end && getRawString(iterator->domain) == domain)
+	{
+		selectors.append(getString(iterator->selector));
+
+		++iterator;
+	}
+
+	return selectors;
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::CompiledRules::checkRuleMatch(const CompiledRule *rule, const Request &request) const
+{
+	if (!matchesPattern(rule, request))
+	{
+		return {};
+	}
+
+	const RuleOptions ruleOptions(QFlag(rule->ruleOptions));
+	const RuleOptions ruleExceptions(QFlag(rule->ruleExceptions));
+	const bool hasBlockedDomains(rule->blockedDomains.amount > 0);
+	const bool hasAllowedDomains(rule->allowedDomains.amount > 0);
+	bool isBlocked(true);
+
+	if (hasBlockedDomains)
+	{
+		isBlocked = resolveDomainExceptions(request.baseHost, rule->blockedDomains);
+
+		if (!isBlocked)
+		{
+			return {};
+		}
+	}
+
+	isBlocked = (hasAllowedDomains ? !resolveDomainExceptions(request.baseHost, rule->allowedDomains) : isBlocked);
+
+	if (ruleOptions.testFlag(ThirdPartyOption) || ruleExceptions.testFlag(ThirdPartyOption))
+	{
+		if (request.baseHost.isEmpty() || request.requestSubdomains.contains(request.baseHost))
+		{
+			isBlocked = ruleExceptions.testFlag(ThirdPartyOption);
+		}
+		else if (!hasBlockedDomains && !hasAllowedDomains)
+		{
+			isBlocked = ruleOptions.testFlag(ThirdPartyOption);
+		}
+	}
+
+	if (ruleOptions != NoOption || ruleExceptions != NoOption)
+	{
+		QHash<NetworkManager::ResourceType, RuleOption>::const_iterator iterator;
+
+		for (iterator = m_resourceTypes.constBegin(); iterator != m_resourceTypes.constEnd(); ++iterator)
+		{
+			const bool supportsException(iterator.value() != WebSocketOption && iterator.value() != PopupOption);
+
+			if (ruleOptions.testFlag(iterator.value()) || (supportsException && ruleExceptions.testFlag(iterator.value())))
+			{
+				if (request.resourceType == iterator.key())
+				{
+					isBlocked = (isBlocked ? ruleOptions.testFlag(iterator.value()) : isBlocked);
+				}
+				else if (supportsException)
+				{
+					isBlocked = (isBlocked ? ruleExceptions.testFlag(iterator.value()) : isBlocked);
+				}
+				else
+				{
+					isBlocked = false;
+				}
+			}
+		}
+	}
+	else if (request.resourceType == NetworkManager::PopupType)
+	{
+		isBlocked = false;
+	}
+
+	if (isBlocked)
+	{
+		ContentFiltersManager::CheckResult result;
+		result.rule = getString(rule->rule);
+
+		if (rule->isException)
+		{
+			result.isBlocked = false;
+			result.isException = true;
+
+			if (ruleOptions.testFlag(ElementHideOption))
+			{
+				result.comesticFiltersMode = ContentFiltersManager::NoFilters;
+			}
+			else if (ruleOptions.testFlag(GenericHideOption))
+			{
+				result.comesticFiltersMode = ContentFiltersManager::DomainOnlyFilters;
+			}
+
+			return result;
+		}
+
+		result.isBlocked = true;
+
+		return result;
+	}
+
+	return {};
+}
+
+QString AdblockContentFiltersProfile::CompiledRules::getString(const CompiledString &string) const
+{
+	return QString(m_strings + string.offset, static_cast<int>(string.length));
+}
+
+QString AdblockContentFiltersProfile::CompiledRules::getRawString(const CompiledString &string) const
+{
+	return QString::fromRawData(m_strings + string.offset, static_cast<int>(string.length));
+}
+
+const AdblockContentFiltersProfile::CompiledHeader* AdblockContentFiltersProfile::CompiledRules::getHeader() const
+{
+	return m_header;
+}
+
+bool AdblockContentFiltersProfile::CompiledRules::setData(const QByteArray &data)
+{
+	m_buffer = data;
+
+	return map(reinterpret_cast<const uchar*>(m_buffer.constData()), m_buffer.size());
+}
+
+bool AdblockContentFiltersProfile::CompiledRules::setFile(QFile *file)
+{
+	m_file = file;
+
+	const uchar *data(m_file->map(0, m_file->size()));
+
+	if (!data)
+	{
+		m_buffer = m_file->readAll();
+
+		m_file->close();
+
+		return map(reinterpret_cast<const uchar*>(m_buffer.constData()), m_buffer.size());
+	}
+
+	return map(data, m_file->size());
+}
+
+bool AdblockContentFiltersProfile::CompiledRules::map(const uchar *data, qint64 size)
+{
+	if (!data || size < static_cast<qint64>(sizeof(CompiledHeader)))
+	{
+		return false;
+	}
+
+	const CompiledHeader *header(reinterpret_cast<const CompiledHeader*>(data));
+
+	if (header->magic != CompiledRulesMagic || header->version != CompiledRulesVersion)
+	{
+		return false;
+	}
+
+	const auto isSectionValid([&](const CompiledSection &section, int itemSize)
+	{
+		return ((section.offset % 8) == 0 && (static_cast<qint64>(section.offset) + (static_cast<qint64>(section.amount) * itemSize)) <= size);
+	});
+
+	if (!isSectionValid(header->tokens, sizeof(CompiledToken)) || !isSectionValid(header->rules, sizeof(CompiledRule)) || !isSectionValid(header->domains, sizeof(CompiledString)) || !isSectionValid(header->cosmeticRules, sizeof(CompiledString)) || !isSectionValid(header->cosmeticDomainRules, sizeof(CompiledCosmeticRule)) || !isSectionValid(header->cosmeticDomainExceptions, sizeof(CompiledCosmeticRule)) || !isSectionValid(header->strings, sizeof(QChar)))
+	{
+		return false;
+	}
+
+	const CompiledToken *tokens(reinterpret_cast<const CompiledToken*>(data + header->tokens.offset));
+	const CompiledRule *rules(reinterpret_cast<const CompiledRule*>(data + header->rules.offset));
+	const CompiledString *domains(reinterpret_cast<const CompiledString*>(data + header->domains.offset));
+	const CompiledString *cosmeticRules(reinterpret_cast<const CompiledString*>(data + header->cosmeticRules.offset));
+	const CompiledCosmeticRule *cosmeticDomainRules(reinterpret_cast<const CompiledCosmeticRule*>(data + header->cosmeticDomainRules.offset));
+	const CompiledCosmeticRule *cosmeticDomainExceptions(reinterpret_cast<const CompiledCosmeticRule*>(data + header->cosmeticDomainExceptions.offset));
+	const auto isStringValid([&](const CompiledString &string)
+	{
+		return ((static_cast<quint64>(string.offset) + string.length) <= header->strings.amount);
+	});
+	const auto isDomainsSectionValid([&](const CompiledSection &section)
+	{
+		return ((static_cast<quint64>(section.offset) + section.amount) <= header->domains.amount);
+	});
+	const auto areCosmeticRulesValid([&](const CompiledCosmeticRule *compiledRules, quint32 amount)
+	{
+		for (quint32 i = 0; i < amount; ++i)
+		{
+			if (!isStringValid(compiledRules[i].domain) || !isStringValid(compiledRules[i].selector))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	});
+
+	for (quint32 i = 0; i < header->tokens.amount; ++i)
+	{
+		if (tokens[i].rule >= header->rules.amount)
+		{
+			return false;
+		}
+	}
+
+	for (quint32 i = 0; i < header->rules.amount; ++i)
+	{
+		const CompiledRule &rule(rules[i]);
+
+		if (!isStringValid(rule.rule) || !isStringValid(rule.pattern) || !isDomainsSectionValid(rule.blockedDomains) || !isDomainsSectionValid(rule.allowedDomains) || rule.domainLength > rule.pattern.length || rule.ruleMatch > ExactMatch)
+		{
+			return false;
+		}
+	}
+
+	for (quint32 i = 0; i < header->domains.amount; ++i)
+	{
+		if (!isStringValid(domains[i]))
+		{
+			return false;
+		}
+	}
+
+	for (quint32 i = 0; i < header->cosmeticRules.amount; ++i)
+	{
+		if (!isStringValid(cosmeticRules[i]))
+		{
+			return false;
+		}
+	}
+
+	if (!areCosmeticRulesValid(cosmeticDomainRules, header->cosmeticDomainRules.amount) || !areCosmeticRulesValid(cosmeticDomainExceptions, header->cosmeticDomainExceptions.amount))
+	{
+		return false;
+	}
+
+	m_header = header;
+	m_tokens = tokens;
+	m_rules = rules;
+	m_domains = domains;
+	m_cosmeticRules = cosmeticRules;
+	m_cosmeticDomainRules = cosmeticDomainRules;
+	m_cosmeticDomainExceptions = cosmeticDomainExceptions;
+	m_strings = reinterpret_cast<const QChar*>(data + header->strings.offset);
+
+	return true;
+}
+
+bool AdblockContentFiltersProfile::CompiledRules::matchesPattern(const CompiledRule *rule, const Request &request) const
+{
+	const QString pattern(getRawString(rule->pattern));
+	const RuleMatch ruleMatch(static_cast<RuleMatch>(rule->ruleMatch));
+	const bool needsEndMatch(ruleMatch == EndMatch || ruleMatch == ExactMatch);
+
+	if (rule->needsDomainCheck)
+	{
+		const QString domain(pattern.left(static_cast<int>(rule->domainLength)));
+
+		if (request.hostPosition < 0 || domain.isEmpty() || !request.requestSubdomains.contains(domain))
+		{
+			return false;
+		}
+
+		return AdblockContentFiltersProfile::matchesPattern(pattern, request.requestUrl, (request.hostPosition + request.requestHost.length() - domain.length()), needsEndMatch);
+	}
+
+	if (ruleMatch == StartMatch || ruleMatch == ExactMatch)
+	{
+		return AdblockContentFiltersProfile::matchesPattern(pattern, request.requestUrl, 0, needsEndMatch);
+	}
+
+	int literalLength(0);
+
+	while (literalLength < pattern.length() && pattern.at(literalLength) != QLatin1Char('*') && pattern.at(literalLength) != QLatin1Char('^'))
+	{
+		++literalLength;
+	}
+
+	if (literalLength == 0)
+	{
+		for (int i = 0; i <= request.requestUrl.length(); ++i)
+		{
+			if (AdblockContentFiltersProfile::matchesPattern(pattern, request.requestUrl, i, needsEndMatch))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	const QStringRef literal(pattern.leftRef(literalLength));
+	int position(request.requestUrl.indexOf(literal));
+
+	while (position >= 0)
+	{
+		if (AdblockContentFiltersProfile::matchesPattern(pattern, request.requestUrl, position, needsEndMatch))
+		{
+			return true;
+		}
+
+		position = request.requestUrl.indexOf(literal, (position + 1));
+	}
+
+	return false;
+}
+
+bool AdblockContentFiltersProfile::CompiledRules::resolveDomainExceptions(const QString &url, const CompiledSection &domains) const
+{
+	for (quint32 i = 0; i < domains.amount; ++i)
+	{
+		if (url.contains(getRawString(m_domains[domains.offset + i])))
+		{
+			return true;
+		}
+	}
+
+	return false;
 }
 
 }
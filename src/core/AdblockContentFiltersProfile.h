@@ -24,7 +24,7 @@
 
 #include "ContentFiltersManager.h"
 
-#include <QtCore/QRegularExpression>
+#include <QtCore/QFile>
 
 namespace Otter
 {
@@ -55,6 +55,7 @@ public:
 	explicit AdblockContentFiltersProfile(const ProfileSummary &profileSummary, const QStringList &languages, ProfileFlags flags, QObject *parent = nullptr);
 
 	void clear() override;
+	void loadRules() override;
 	void setProfileSummary(const ProfileSummary &profileSummary) override;
 	QString getName() const override;
 	QString getTitle() const override;
@@ -63,8 +64,7 @@ public:
 	QDateTime getLastUpdate() const override;
 	static HeaderInformation loadHeader(QIODevice *rulesDevice);
 	ProfileSummary getProfileSummary() const override;
-	ContentFiltersManager::CheckResult checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType) override;
-	ContentFiltersManager::CosmeticFiltersResult getCosmeticFilters(const QStringList &domains, bool isDomainOnly) override;
+	std::shared_ptr<const ContentFiltersRules> getRules() const override;
 	static QHash<RuleType, quint32> loadRulesInformation(const ProfileSummary &profileSummary, QIODevice *rulesDevice);
 	QVector<QLocale::Language> getLanguages() const override;
 	ProfileCategory getCategory() const override;
@@ -108,23 +108,95 @@ protected:
 		ExactMatch
 	};
 
-	struct Node final
+	enum CompiledRulesFormat : quint32
 	{
-		struct Rule final
-		{
-			QString rule;
-			QStringList blockedDomains;
-			QStringList allowedDomains;
-			RuleOptions ruleOptions = NoOption;
-			RuleOptions ruleExceptions = NoOption;
-			RuleMatch ruleMatch = ContainsMatch;
-			bool isException = false;
-			bool needsDomainCheck = false;
-		};
+		CompiledRulesMagic = 0x4F414246,
+		CompiledRulesVersion = 2
+	};
+
+	enum ParsingFlag
+	{
+		NoParsingFlags = 0,
+		DomainCosmeticFiltersFlag = 1,
+		GenericCosmeticFiltersFlag = 2,
+		WildcardsFlag = 4
+	};
+
+	struct Rule final
+	{
+		QString rule;
+		QString pattern;
+		QStringList blockedDomains;
+		QStringList allowedDomains;
+		RuleOptions ruleOptions = NoOption;
+		RuleOptions ruleExceptions = NoOption;
+		RuleMatch ruleMatch = ContainsMatch;
+		bool isException = false;
+		bool needsDomainCheck = false;
+	};
+
+	struct CompilationData final
+	{
+		QVector<Rule> rules;
+		QStringList cosmeticFiltersRules;
+		QMultiHash<QString, QString> cosmeticFiltersDomainRules;
+		QMultiHash<QString, QString> cosmeticFiltersDomainExceptions;
+	};
+
+	struct CompiledString final
+	{
+		quint32 offset = 0;
+		quint32 length = 0;
+	};
+
+	struct CompiledSection final
+	{
+		quint32 offset = 0;
+		quint32 amount = 0;
+	};
+
+	struct CompiledHeader final
+	{
+		quint32 magic = 0;
+		quint32 version = 0;
+		qint64 sourceModificationTime = 0;
+		qint64 sourceSize = 0;
+		char sourceHash[20] = {};
+		quint32 parsingFlags = NoParsingFlags;
+		CompiledSection tokens;
+		CompiledSection rules;
+		CompiledSection domains;
+		CompiledSection cosmeticRules;
+		CompiledSection cosmeticDomainRules;
+		CompiledSection cosmeticDomainExceptions;
+		CompiledSection strings;
+	};
 
-		QChar value = 0;
-		QVarLengthArray<Node*, 1> children;
-		QVarLengthArray<Rule*, 1> rules;
+	struct CompiledToken final
+	{
+		quint32 hash = 0;
+		quint32 rule = 0;
+	};
+
+	struct CompiledRule final
+	{
+		CompiledString rule;
+		CompiledString pattern;
+		CompiledSection blockedDomains;
+		CompiledSection allowedDomains;
+		quint32 domainLength = 0;
+		quint16 ruleOptions = NoOption;
+		quint16 ruleExceptions = NoOption;
+		quint8 ruleMatch = ContainsMatch;
+		quint8 isException = false;
+		quint8 needsDomainCheck = false;
+		quint8 padding = 0;
+	};
+
+	struct CompiledCosmeticRule final
+	{
+		CompiledString domain;
+		CompiledString selector;
 	};
 
 	struct Request final
@@ -132,42 +204,95 @@ protected:
 		QString baseHost;
 		QString requestHost;
 		QString requestUrl;
+		QStringList requestSubdomains;
 		NetworkManager::ResourceType resourceType = NetworkManager::OtherType;
+		int hostPosition = -1;
 
-		explicit Request(const QUrl &baseUrlValue, const QUrl &requestUrlValue, NetworkManager::ResourceType resourceTypeValue) : baseHost(baseUrlValue.host()), requestHost(requestUrlValue.host()), requestUrl(requestUrlValue.toString()), resourceType(resourceTypeValue)
+		explicit Request(const QUrl &baseUrlValue, const QUrl &requestUrlValue, NetworkManager::ResourceType resourceTypeValue) : baseHost(baseUrlValue.host()), requestHost(requestUrlValue.host()), requestUrl(requestUrlValue.toString()), requestSubdomains(ContentFiltersManager::createSubdomainList(requestHost)), resourceType(resourceTypeValue)
 		{
 			if (requestUrl.startsWith(QLatin1String("//")))
 			{
 				requestUrl = requestUrl.mid(2);
 			}
+
+			const int schemeSeparator(requestUrl.indexOf(QLatin1String("://")));
+
+			hostPosition = (requestHost.isEmpty() ? -1 : requestUrl.indexOf(requestHost, ((schemeSeparator >= 0) ? (schemeSeparator + 3) : 0)));
 		}
 	};
 
+	class CompiledRules final : public ContentFiltersRules
+	{
+	public:
+		CompiledRules();
+		~CompiledRules();
+
+		ContentFiltersManager::CheckResult checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType) const override;
+		ContentFiltersManager::CosmeticFiltersResult getCosmeticFilters(const QStringList &domains, bool isDomainOnly) const override;
+		const CompiledHeader* getHeader() const;
+		bool setData(const QByteArray &data);
+		bool setFile(QFile *file);
+
+	protected:
+		ContentFiltersManager::CheckResult checkRuleMatch(const CompiledRule *rule, const Request &request) const;
+		QString getString(const CompiledString &string) const;
+		QString getRawString(const CompiledString &string) const;
+		QStringList getCosmeticDomainRules(const CompiledCosmeticRule *rules, quint32 amount, const QString &domain) const;
+		bool map(const uchar *data, qint64 size);
+		bool matchesPattern(const CompiledRule *rule, const Request &request) const;
+		bool resolveDomainExceptions(const QString &url, const CompiledSection &domains) const;
+
+	private:
+		QFile *m_file;
+		QByteArray m_buffer;
+		const CompiledHeader *m_header;
+		const CompiledToken *m_tokens;
+		const CompiledRule *m_rules;
+		const CompiledString *m_domains;
+		const CompiledString *m_cosmeticRules;
+		const CompiledCosmeticRule *m_cosmeticDomainRules;
+		const CompiledCosmeticRule *m_cosmeticDomainExceptions;
+		const QChar *m_strings;
+
+		Q_DISABLE_COPY(CompiledRules)
+	};
+
+	struct LoadingResult final
+	{
+		std::shared_ptr<const CompiledRules> rules;
+		QString message;
+		ProfileError error = NoError;
+	};
+
 	void loadHeader();
-	void parseRuleLine(const QString &rule);
-	void parseStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list);
-	void deleteNode(Node *node) const;
-	ContentFiltersManager::CheckResult checkUrlSubstring(const Node *node, const QString &subString, QString currentRule, const Request &request) const;
-	ContentFiltersManager::CheckResult checkRuleMatch(const Node::Rule *rule, const QString &currentRule, const Request &request) const;
-	ContentFiltersManager::CheckResult evaluateNodeRules(const Node *node, const QString &currentRule, const Request &request) const;
-	bool loadRules();
-	bool resolveDomainExceptions(const QString &url, const QStringList &ruleList) const;
+	void reloadRules();
+	QString getCompiledRulesPath() const;
+	static void parseRuleLine(const QString &rule, const ProfileSummary &profileSummary, CompilationData &data);
+	static void parseStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list);
+	static QByteArray createCompiledRules(const CompilationData &data, quint32 parsingFlags, const QByteArray &sourceHash, qint64 sourceSize, qint64 sourceModificationTime);
+	static QByteArray createSourceHash(QIODevice *device);
+	static QByteArray compileRules(const ProfileSummary &profileSummary, QFile *file);
+	static QVector<quint32> createPatternTokens(const Rule &rule);
+	static LoadingResult createRules(const ProfileSummary &profileSummary, const QString &path, const QString &compiledPath);
+	static std::shared_ptr<const CompiledRules> loadCompiledRules(const ProfileSummary &profileSummary, const QString &path, const QString &compiledPath);
+	static quint32 createTokenHash(const QChar *data, int length);
+	static quint32 getParsingFlags(const ProfileSummary &profileSummary);
+	static bool matchesPattern(const QString &pattern, const QString &url, int position, bool needsEndMatch);
+	static bool isSeparator(QChar character);
+	static bool isTokenCharacter(QChar character);
 
 protected slots:
 	void raiseError(const QString &message, ProfileError error);
 	void handleJobFinished(bool isSuccess);
 
 private:
-	Node *m_root;
 	DataFetchJob *m_dataFetchJob;
+	std::shared_ptr<const CompiledRules> m_compiledRules;
 	ProfileSummary m_profileSummary;
-	QRegularExpression m_domainExpression;
-	QStringList m_cosmeticFiltersRules;
 	QVector<QLocale::Language> m_languages;
-	QMultiHash<QString, QString> m_cosmeticFiltersDomainRules;
-	QMultiHash<QString, QString> m_cosmeticFiltersDomainExceptions;
 	ProfileError m_error;
 	ProfileFlags m_flags;
+	int m_rulesGeneration;
 	bool m_wasLoaded;
 
 	static QVector<QChar> m_separators;
@@ -104,7 +104,7 @@ void AddressCompletionModel::updateModel()
 
 	if (m_types.testFlag(BookmarksCompletionType))
 	{
-		const QVector<BookmarksModel::BookmarkMatch> bookmarks(BookmarksManager::findBookmarks(m_filter));
+		const QVector<BookmarksModel::BookmarkMatch> bookmarks(BookmarksManager::findBookmarks(m_filter, 20));
 
 		if (m_showCompletionCategories && !bookmarks.isEmpty())
 		{
@@ -154,7 +154,7 @@ void AddressCompletionModel::updateModel()
 
 	if (m_types.testFlag(HistoryCompletionType))
 	{
-		const QVector<HistoryModel::HistoryEntryMatch> entries(HistoryManager::findEntries(m_filter));
+		const QVector<HistoryModel::HistoryEntryMatch> entries(HistoryManager::findEntries(m_filter, false, 20));
 
 		if (m_showCompletionCategories && !entries.isEmpty())
 		{
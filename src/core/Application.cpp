@@ -26,7 +26,9 @@
 #include "GesturesManager.h"
 #include "HandlersManager.h"
 #include "HistoryManager.h"
+#include "HostLookupManager.h"
 #include "LongTermTimer.h"
+#include "MemoryPressureManager.h"
 #include "Migrator.h"
 #include "NetworkManagerFactory.h"
 #include "NotesManager.h"
@@ -34,6 +36,7 @@
 #include "PasswordsManager.h"
 #include "PlatformIntegration.h"
 #include "SearchEnginesManager.h"
+#include "SearchSuggester.h"
 #include "SettingsManager.h"
 #include "SpellCheckManager.h"
 #include "TasksManager.h"
@@ -258,6 +261,11 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 			{
 				reportOptions |= SettingsReport;
 			}
+
+			if (rawReportOptions.contains(QLatin1String("statistics")))
+			{
+				reportOptions |= StatisticsReport;
+			}
 		}
 
 		if (rawReportOptions.contains(QLatin1String("dialog")))
@@ -423,6 +431,10 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	HistoryManager::createInstance();
 
+	HostLookupManager::createInstance();
+
+	MemoryPressureManager::createInstance();
+
 	NetworkManagerFactory::createInstance();
 
 	NotesManager::createInstance();
@@ -1446,7 +1458,11 @@ QString Application::createReport(ReportOptions options)
 		stream << QLatin1String("\n\t");
 		stream.setFieldWidth(20);
 		stream << QLatin1String("History");
-		stream << SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.json"));
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+		stream << SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.sqlite"));
+#else
+		stream << SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.dat"));
+#endif
 		stream.setFieldWidth(0);
 		stream << QLatin1String("\n\t");
 		stream.setFieldWidth(20);
@@ -1466,6 +1482,11 @@ QString Application::createReport(ReportOptions options)
 		stream << ActionsManager::createReport();
 	}
 
+	if (options.testFlag(StatisticsReport))
+	{
+		stream << SearchSuggester::createReport();
+	}
+
 	return report.remove(QRegularExpression(QLatin1String(" +$"), QRegularExpression::MultilineOption));
 }
 
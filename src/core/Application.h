@@ -51,8 +51,9 @@ public:
 		KeyboardShortcutsReport = 2,
 		PathsReport = 4,
 		SettingsReport = 8,
-		StandardReport = (EnvironmentReport | PathsReport | SettingsReport),
-		FullReport = (EnvironmentReport | KeyboardShortcutsReport | PathsReport | SettingsReport)
+		StatisticsReport = 16,
+		StandardReport = (EnvironmentReport | PathsReport | SettingsReport | StatisticsReport),
+		FullReport = (EnvironmentReport | KeyboardShortcutsReport | PathsReport | SettingsReport | StatisticsReport)
 	};
 
 	Q_DECLARE_FLAGS(ReportOptions, ReportOption)
@@ -179,11 +179,11 @@ QStringList BookmarksManager::getKeywords()
 	return m_model->getKeywords();
 }
 
-QVector<BookmarksModel::BookmarkMatch> BookmarksManager::findBookmarks(const QString &prefix)
+QVector<BookmarksModel::BookmarkMatch> BookmarksManager::findBookmarks(const QString &prefix, int limit)
 {
 	ensureInitialized();
 
-	return m_model->findBookmarks(prefix);
+	return m_model->findBookmarks(prefix, limit);
 }
 
 bool BookmarksManager::hasBookmark(const QUrl &url)
@@ -44,7 +44,7 @@ public:
 	static BookmarksModel::Bookmark* getBookmark(quint64 identifier);
 	static BookmarksModel::Bookmark* getLastUsedFolder();
 	static QStringList getKeywords();
-	static QVector<BookmarksModel::BookmarkMatch> findBookmarks(const QString &prefix);
+	static QVector<BookmarksModel::BookmarkMatch> findBookmarks(const QString &prefix, int limit = 0);
 	static bool hasBookmark(const QUrl &url);
 	static bool hasKeyword(const QString &keyword);
 
@@ -868,6 +868,8 @@ void BookmarksModel::removeBookmarkUrl(Bookmark *bookmark)
 					{
 						m_urls.remove(url);
 					}
+
+					updateIndex(url);
 				}
 			}
 
@@ -899,6 +901,8 @@ void BookmarksModel::readdBookmarkUrl(Bookmark *bookmark)
 					}
 
 					m_urls[url].append(bookmark);
+
+					updateIndex(url);
 				}
 			}
 
@@ -1034,6 +1038,38 @@ void BookmarksModel::handleUrlChanged(Bookmark *bookmark, const QUrl &newUrl, co
 
 		m_urls[newUrl].append(bookmark);
 	}
+
+	updateIndex(oldUrl);
+	updateIndex(newUrl);
+}
+
+void BookmarksModel::updateIndex(const QUrl &url)
+{
+	const QVector<Bookmark*> bookmarks(m_urls.value(url));
+
+	if (bookmarks.isEmpty())
+	{
+		m_index.removeEntry(url);
+
+		return;
+	}
+
+	QDateTime timeVisited;
+	int visits(0);
+
+	for (int i = 0; i < bookmarks.count(); ++i)
+	{
+		const QDateTime bookmarkTimeVisited(bookmarks.at(i)->getTimeVisited());
+
+		if (bookmarkTimeVisited.isValid() && (!timeVisited.isValid() || bookmarkTimeVisited > timeVisited))
+		{
+			timeVisited = bookmarkTimeVisited;
+		}
+
+		visits += bookmarks.at(i)->getVisits();
+	}
+
+	m_index.setEntry(url, bookmarks.first(), bookmarks.first()->getTitle(), UrlCompletionIndex::calculateScore(visits, timeVisited));
 }
 
 void BookmarksModel::notifyBookmarkModified(const QModelIndex &index)
@@ -1253,11 +1289,10 @@ QStringList BookmarksModel::getKeywords() const
 	return m_keywords.keys();
 }
 
-QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QString &prefix) const
+QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QString &prefix, int limit) const
 {
 	QVector<Bookmark*> matchedBookmarks;
 	QVector<BookmarkMatch> allMatches;
-	QVector<BookmarkMatch> currentMatches;
 	QMultiMap<QDateTime, BookmarkMatch> matchesMap;
 	QHash<QString, Bookmark*>::const_iterator keywordsIterator;
 
@@ -1275,49 +1310,41 @@ QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QStri
 		}
 	}
 
-	currentMatches = matchesMap.values().toVector();
-
-	matchesMap.clear();
+	const QVector<BookmarkMatch> keywordMatches(matchesMap.values().toVector());
 
-	allMatches.reserve(currentMatches.count());
+	allMatches.reserve(keywordMatches.count());
 
-	for (int i = (currentMatches.count() - 1); i >= 0; --i)
+	for (int i = (keywordMatches.count() - 1); i >= 0; --i)
 	{
-		allMatches.append(currentMatches.at(i));
+		if (limit > 0 && allMatches.count() >= limit)
+		{
+			return allMatches;
+		}
+
+		allMatches.append(keywordMatches.at(i));
 	}
 
-	QHash<QUrl, QVector<Bookmark*> >::const_iterator urlsIterator;
+	const QVector<UrlCompletionIndex::Match> indexMatches(m_index.findEntries(prefix, ((limit > 0) ? (limit + matchedBookmarks.count()) : 0)));
 
-	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+	for (int i = 0; i < indexMatches.count(); ++i)
 	{
-		if (urlsIterator.value().isEmpty() || matchedBookmarks.contains(urlsIterator.value().value(0)))
+		if (limit > 0 && allMatches.count() >= limit)
 		{
-			continue;
+			break;
 		}
 
-		const QString result(Utils::matchUrl(urlsIterator.key(), prefix));
+		Bookmark *bookmark(static_cast<Bookmark*>(indexMatches.at(i).item));
 
-		if (!result.isEmpty())
+		if (!matchedBookmarks.contains(bookmark))
 		{
 			BookmarkMatch match;
-			match.bookmark = urlsIterator.value().value(0);
-			match.match = result;
-
-			matchesMap.insert(match.bookmark->getTimeVisited(), match);
+			match.bookmark = bookmark;
+			match.match = indexMatches.at(i).match;
 
-			matchedBookmarks.append(match.bookmark);
+			allMatches.append(match);
 		}
 	}
 
-	currentMatches = matchesMap.values().toVector();
-
-	matchesMap.clear();
-
-	for (int i = (currentMatches.count() - 1); i >= 0; --i)
-	{
-		allMatches.append(currentMatches.at(i));
-	}
-
 	return allMatches;
 }
 
@@ -1552,6 +1579,18 @@ bool BookmarksModel::setData(const QModelIndex &index, const QVariant &value, in
 
 	bookmark->setItemData(value, role);
 
+	switch (role)
+	{
+		case TitleRole:
+		case TimeVisitedRole:
+		case VisitsRole:
+			updateIndex(Utils::normalizeUrl(bookmark->getUrl()));
+
+			break;
+		default:
+			break;
+	}
+
 	switch (role)
 	{
 		case TitleRole:
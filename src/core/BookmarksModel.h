@@ -21,6 +21,8 @@
 #ifndef OTTER_BOOKMARKSMODEL_H
 #define OTTER_BOOKMARKSMODEL_H
 
+#include "UrlCompletionIndex.h"
+
 #include <QtCore/QUrl>
 #include <QtCore/QXmlStreamReader>
 #include <QtCore/QXmlStreamWriter>
@@ -124,7 +126,7 @@ public:
 	QMimeData* mimeData(const QModelIndexList &indexes) const override;
 	QStringList mimeTypes() const override;
 	QStringList getKeywords() const;
-	QVector<BookmarkMatch> findBookmarks(const QString &prefix) const;
+	QVector<BookmarkMatch> findBookmarks(const QString &prefix, int limit = 0) const;
 	QVector<Bookmark*> findUrls(const QUrl &url, QStandardItem *branch = nullptr) const;
 	QVector<Bookmark*> getBookmarks(const QUrl &url) const;
 	FormatMode getFormatMode() const;
@@ -148,6 +150,7 @@ protected:
 	void setupFeed(Bookmark *bookmark);
 	void handleKeywordChanged(Bookmark *bookmark, const QString &newKeyword, const QString &oldKeyword = {});
 	void handleUrlChanged(Bookmark *bookmark, const QUrl &newUrl, const QUrl &oldUrl = {});
+	void updateIndex(const QUrl &url);
 	static QDateTime readDateTime(QXmlStreamReader *reader, const QString &attribute);
 
 protected slots:
@@ -158,6 +161,7 @@ private:
 	Bookmark *m_rootItem;
 	Bookmark *m_trashItem;
 	Bookmark *m_importTargetItem;
+	UrlCompletionIndex m_index;
 	QHash<Bookmark*, QPair<QModelIndex, int> > m_trash;
 	QHash<QUrl, QVector<Bookmark*> > m_feeds;
 	QHash<QUrl, QVector<Bookmark*> > m_urls;
@@ -28,14 +28,21 @@
 #include <QtCore/QDir>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
 #include <QtCore/QTimer>
 
+#include <atomic>
+
 namespace Otter
 {
 
 ContentFiltersManager* ContentFiltersManager::m_instance(nullptr);
 QVector<ContentFiltersProfile*> ContentFiltersManager::m_contentBlockingProfiles;
 QVector<ContentFiltersProfile*> ContentFiltersManager::m_fraudCheckingProfiles;
+std::shared_ptr<const QVector<ContentFiltersManager::ProfileSnapshot> > ContentFiltersManager::m_snapshot;
+QHash<QVector<int>, ContentFiltersManager::GenericCosmeticFilters> ContentFiltersManager::m_genericCosmeticFilters;
+QHash<QString, ContentFiltersManager::DomainCosmeticFilters> ContentFiltersManager::m_domainCosmeticFilters;
 
 ContentFiltersManager::ContentFiltersManager(QObject *parent) : QObject(parent),
 	m_saveTimer(0)
@@ -171,13 +178,18 @@ void ContentFiltersManager::initialize()
 
 		connect(profile, &ContentFiltersProfile::profileModified, profile, [=]()
 		{
+			updateSnapshot();
+
 			m_instance->scheduleSave();
 
 			emit m_instance->profileModified(profile->getName());
 		});
+		connect(profile, &ContentFiltersProfile::rulesChanged, m_instance, &ContentFiltersManager::updateSnapshot);
 	}
 
 	m_contentBlockingProfiles.squeeze();
+
+	updateSnapshot();
 }
 
 void ContentFiltersManager::timerEvent(QTimerEvent *event)
@@ -272,6 +284,28 @@ void ContentFiltersManager::scheduleSave()
 	}
 }
 
+void ContentFiltersManager::updateSnapshot()
+{
+	std::shared_ptr<QVector<ProfileSnapshot> > snapshot(std::make_shared<QVector<ProfileSnapshot> >());
+	snapshot->reserve(m_contentBlockingProfiles.count());
+
+	for (int i = 0; i < m_contentBlockingProfiles.count(); ++i)
+	{
+		const ContentFiltersProfile *profile(m_contentBlockingProfiles.at(i));
+		ProfileSnapshot profileSnapshot;
+		profileSnapshot.name = profile->getName();
+		profileSnapshot.title = profile->getTitle();
+		profileSnapshot.rules = profile->getRules();
+
+		snapshot->append(profileSnapshot);
+	}
+
+	std::atomic_store(&m_snapshot, std::shared_ptr<const QVector<ProfileSnapshot> >(snapshot));
+
+	m_genericCosmeticFilters.clear();
+	m_domainCosmeticFilters.clear();
+}
+
 void ContentFiltersManager::addProfile(ContentFiltersProfile *profile)
 {
 	if (!profile)
@@ -299,11 +333,15 @@ void ContentFiltersManager::addProfile(ContentFiltersProfile *profile)
 		m_contentBlockingProfiles.append(profile);
 	}
 
+	updateSnapshot();
+
 	m_instance->scheduleSave();
 
 	emit m_instance->profileAdded(profile->getName());
 
+	connect(profile, &ContentFiltersProfile::profileModified, m_instance, &ContentFiltersManager::updateSnapshot);
 	connect(profile, &ContentFiltersProfile::profileModified, m_instance, &ContentFiltersManager::scheduleSave);
+	connect(profile, &ContentFiltersProfile::rulesChanged, m_instance, &ContentFiltersManager::updateSnapshot);
 }
 
 void ContentFiltersManager::removeProfile(ContentFiltersProfile *profile, bool removeFile)
@@ -337,6 +375,8 @@ void ContentFiltersManager::removeProfile(ContentFiltersProfile *profile, bool r
 
 	m_contentBlockingProfiles.removeAll(profile);
 
+	updateSnapshot();
+
 	profile->deleteLater();
 
 	emit m_instance->profileRemoved(name);
@@ -397,14 +437,21 @@ ContentFiltersManager::CheckResult ContentFiltersManager::checkUrl(const QVector
 		return {};
 	}
 
+	const std::shared_ptr<const QVector<ProfileSnapshot> > snapshot(std::atomic_load(&m_snapshot));
+
+	if (!snapshot)
+	{
+		return {};
+	}
+
 	CheckResult result;
 	result.isFraud = ((resourceType == NetworkManager::MainFrameType || resourceType == NetworkManager::SubFrameType) ? isFraud(requestUrl) : false);
 
 	for (int i = 0; i < profiles.count(); ++i)
 	{
-		if (profiles.at(i) >= 0 && profiles.at(i) < m_contentBlockingProfiles.count())
+		if (profiles.at(i) >= 0 && profiles.at(i) < snapshot->count() && snapshot->at(profiles.at(i)).rules)
 		{
-			CheckResult currentResult(m_contentBlockingProfiles.at(profiles.at(i))->checkUrl(baseUrl, requestUrl, resourceType));
+			CheckResult currentResult(snapshot->at(profiles.at(i)).rules->checkUrl(baseUrl, requestUrl, resourceType));
 			currentResult.profile = profiles.at(i);
 			currentResult.isFraud = result.isFraud;
 
@@ -422,7 +469,7 @@ ContentFiltersManager::CheckResult ContentFiltersManager::checkUrl(const QVector
 	return result;
 }
 
-ContentFiltersManager::CosmeticFiltersResult ContentFiltersManager::getCosmeticFilters(const QVector<int> &profiles, const QUrl &requestUrl)
+ContentFiltersManager::CosmeticFiltersStyleSheet ContentFiltersManager::getCosmeticFiltersStyleSheet(const QVector<int> &profiles, const QUrl &requestUrl)
 {
 	if (profiles.isEmpty())
 	{
@@ -436,23 +483,157 @@ ContentFiltersManager::CosmeticFiltersResult ContentFiltersManager::getCosmeticF
 		return {};
 	}
 
-	CosmeticFiltersResult result;
-	const QStringList domains(createSubdomainList(requestUrl.host()));
+	const std::shared_ptr<const QVector<ProfileSnapshot> > snapshot(std::atomic_load(&m_snapshot));
+
+	if (!snapshot)
+	{
+		return {};
+	}
+
+	const QString host(requestUrl.host());
+	QString key(QString::number(mode) + QLatin1Char('/') + host);
 
 	for (int i = 0; i < profiles.count(); ++i)
 	{
-		const int index(profiles.at(i));
+		key.append(QLatin1Char('/') + QString::number(profiles.at(i)));
+	}
 
-		if (index >= 0 && index < m_contentBlockingProfiles.count())
+	if (mode == AllFilters && !m_genericCosmeticFilters.contains(profiles))
+	{
+		GenericCosmeticFilters genericFilters;
+
+		for (int i = 0; i < profiles.count(); ++i)
 		{
-			const CosmeticFiltersResult profileResult(m_contentBlockingProfiles.at(index)->getCosmeticFilters(domains, (mode == DomainOnlyFilters)));
+			const int index(profiles.at(i));
 
-			result.rules.append(profileResult.rules);
-			result.exceptions.append(profileResult.exceptions);
+			if (index >= 0 && index < snapshot->count() && snapshot->at(index).rules)
+			{
+				genericFilters.selectors.append(snapshot->at(index).rules->getCosmeticFilters({}, false).rules);
+			}
 		}
+
+		genericFilters.styleSheet = createStyleSheet(genericFilters.selectors);
+
+		m_genericCosmeticFilters[profiles] = genericFilters;
 	}
 
-	return result;
+	if (!m_domainCosmeticFilters.contains(key))
+	{
+		const QStringList domains(createSubdomainList(host));
+		QStringList domainRules;
+		QSet<QString> exceptions;
+
+		for (int i = 0; i < profiles.count(); ++i)
+		{
+			const int index(profiles.at(i));
+
+			if (index >= 0 && index < snapshot->count() && snapshot->at(index).rules)
+			{
+				const CosmeticFiltersResult profileResult(snapshot->at(index).rules->getCosmeticFilters(domains, true));
+
+				domainRules.append(profileResult.rules);
+
+				for (int j = 0; j < profileResult.exceptions.count(); ++j)
+				{
+					exceptions.insert(profileResult.exceptions.at(j));
+				}
+			}
+		}
+
+		DomainCosmeticFilters domainFilters;
+
+		if (!exceptions.isEmpty())
+		{
+			QStringList::iterator iterator(domainRules.begin());
+
+			while (iterator != domainRules.end())
+			{
+				if (exceptions.contains(*iterator))
+				{
+					iterator = domainRules.erase(iterator);
+				}
+				else
+				{
+					++iterator;
+				}
+			}
+
+			if (mode == AllFilters)
+			{
+				const QStringList genericSelectors(m_genericCosmeticFilters.value(profiles).selectors);
+
+				for (int i = 0; i < genericSelectors.count(); ++i)
+				{
+					if (exceptions.contains(genericSelectors.at(i)))
+					{
+						domainFilters.genericExceptions.insert(genericSelectors.at(i));
+					}
+				}
+			}
+		}
+
+		domainFilters.styleSheet = createStyleSheet(domainRules);
+
+		if (m_domainCosmeticFilters.count() >= 100)
+		{
+			m_domainCosmeticFilters.clear();
+		}
+
+		m_domainCosmeticFilters[key] = domainFilters;
+	}
+
+	const DomainCosmeticFilters domainFilters(m_domainCosmeticFilters.value(key));
+	CosmeticFiltersStyleSheet styleSheet;
+	styleSheet.domainStyleSheet = domainFilters.styleSheet;
+
+	if (mode == AllFilters)
+	{
+		const GenericCosmeticFilters genericFilters(m_genericCosmeticFilters.value(profiles));
+
+		if (domainFilters.genericExceptions.isEmpty())
+		{
+			styleSheet.genericStyleSheet = genericFilters.styleSheet;
+		}
+		else
+		{
+			QStringList selectors;
+			selectors.reserve(genericFilters.selectors.count());
+
+			for (int i = 0; i < genericFilters.selectors.count(); ++i)
+			{
+				if (!domainFilters.genericExceptions.contains(genericFilters.selectors.at(i)))
+				{
+					selectors.append(genericFilters.selectors.at(i));
+				}
+			}
+
+			styleSheet.genericStyleSheet = createStyleSheet(selectors);
+		}
+	}
+
+	return styleSheet;
+}
+
+QString ContentFiltersManager::createStyleSheet(const QStringList &selectors)
+{
+	const QLatin1String declaration("{display:none !important;}");
+	QString styleSheet;
+	int length(0);
+
+	for (int i = 0; i < selectors.count(); ++i)
+	{
+		length += (selectors.at(i).length() + declaration.size());
+	}
+
+	styleSheet.reserve(length);
+
+	for (int i = 0; i < selectors.count(); ++i)
+	{
+		styleSheet.append(selectors.at(i));
+		styleSheet.append(declaration);
+	}
+
+	return styleSheet;
 }
 
 QStringList ContentFiltersManager::createSubdomainList(const QString &domain)
@@ -473,6 +654,18 @@ QStringList ContentFiltersManager::createSubdomainList(const QString &domain)
 	return subdomainList;
 }
 
+QString ContentFiltersManager::getProfileTitle(int identifier)
+{
+	const std::shared_ptr<const QVector<ProfileSnapshot> > snapshot(std::atomic_load(&m_snapshot));
+
+	if (!snapshot || identifier < 0 || identifier >= snapshot->count())
+	{
+		return {};
+	}
+
+	return snapshot->at(identifier).title;
+}
+
 QStringList ContentFiltersManager::getProfileNames()
 {
 	initialize();
@@ -504,16 +697,33 @@ QVector<ContentFiltersProfile*> ContentFiltersManager::getFraudCheckingProfiles(
 
 QVector<int> ContentFiltersManager::getProfileIdentifiers(const QStringList &names)
 {
-	initialize();
+	const bool isMainThread(m_instance && m_instance->thread() == QThread::currentThread());
 
+	if (isMainThread)
+	{
+		initialize();
+	}
+
+	const std::shared_ptr<const QVector<ProfileSnapshot> > snapshot(std::atomic_load(&m_snapshot));
 	QVector<int> identifiers;
+
+	if (!snapshot)
+	{
+		return identifiers;
+	}
+
 	identifiers.reserve(names.count());
 
-	for (int i = 0; i < m_contentBlockingProfiles.count(); ++i)
+	for (int i = 0; i < snapshot->count(); ++i)
 	{
-		if (names.contains(m_contentBlockingProfiles.at(i)->getName()))
+		if (names.contains(snapshot->at(i).name))
 		{
 			identifiers.append(i);
+
+			if (isMainThread)
+			{
+				m_contentBlockingProfiles.at(i)->loadRules();
+			}
 		}
 	}
 
@@ -533,6 +743,10 @@ bool ContentFiltersManager::isFraud(const QUrl &url)
 	return false;
 }
 
+ContentFiltersRules::~ContentFiltersRules()
+{
+}
+
 ContentFiltersProfile::ContentFiltersProfile(QObject *parent) : QObject(parent)
 {
 }
@@ -23,12 +23,16 @@
 
 #include "NetworkManager.h"
 
+#include <QtCore/QSet>
 #include <QtCore/QUrl>
 
+#include <memory>
+
 namespace Otter
 {
 
 class ContentFiltersProfile;
+class ContentFiltersRules;
 
 class ContentFiltersManager final : public QObject
 {
@@ -58,6 +62,12 @@ public:
 		QStringList exceptions;
 	};
 
+	struct CosmeticFiltersStyleSheet final
+	{
+		QString genericStyleSheet;
+		QString domainStyleSheet;
+	};
+
 	static void createInstance();
 	static void initialize();
 	static void addProfile(ContentFiltersProfile *profile);
@@ -67,8 +77,9 @@ public:
 	static ContentFiltersProfile* getProfile(const QUrl &url);
 	static ContentFiltersProfile* getProfile(int identifier);
 	static CheckResult checkUrl(const QVector<int> &profiles, const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType);
-	static CosmeticFiltersResult getCosmeticFilters(const QVector<int> &profiles, const QUrl &requestUrl);
+	static CosmeticFiltersStyleSheet getCosmeticFiltersStyleSheet(const QVector<int> &profiles, const QUrl &requestUrl);
 	static QStringList createSubdomainList(const QString &domain);
+	static QString getProfileTitle(int identifier);
 	static QStringList getProfileNames();
 	static QVector<ContentFiltersProfile*> getContentBlockingProfiles();
 	static QVector<ContentFiltersProfile*> getFraudCheckingProfiles();
@@ -76,9 +87,30 @@ public:
 	static bool isFraud(const QUrl &url);
 
 protected:
+	struct ProfileSnapshot final
+	{
+		QString name;
+		QString title;
+		std::shared_ptr<const ContentFiltersRules> rules;
+	};
+
+	struct GenericCosmeticFilters final
+	{
+		QStringList selectors;
+		QString styleSheet;
+	};
+
+	struct DomainCosmeticFilters final
+	{
+		QSet<QString> genericExceptions;
+		QString styleSheet;
+	};
+
 	explicit ContentFiltersManager(QObject *parent);
 
 	void timerEvent(QTimerEvent *event) override;
+	static void updateSnapshot();
+	static QString createStyleSheet(const QStringList &selectors);
 
 protected slots:
 	void scheduleSave();
@@ -87,6 +119,9 @@ private:
 	int m_saveTimer;
 
 	static ContentFiltersManager *m_instance;
+	static std::shared_ptr<const QVector<ProfileSnapshot> > m_snapshot;
+	static QHash<QVector<int>, GenericCosmeticFilters> m_genericCosmeticFilters;
+	static QHash<QString, DomainCosmeticFilters> m_domainCosmeticFilters;
 	static QVector<ContentFiltersProfile*> m_contentBlockingProfiles;
 	static QVector<ContentFiltersProfile*> m_fraudCheckingProfiles;
 
@@ -96,6 +131,15 @@ signals:
 	void profileRemoved(const QString &profile);
 };
 
+class ContentFiltersRules
+{
+public:
+	virtual ~ContentFiltersRules();
+
+	virtual ContentFiltersManager::CheckResult checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType) const = 0;
+	virtual ContentFiltersManager::CosmeticFiltersResult getCosmeticFilters(const QStringList &domains, bool isDomainOnly) const = 0;
+};
+
 class ContentFiltersProfile : public QObject
 {
 	Q_OBJECT
@@ -142,6 +186,7 @@ public:
 	explicit ContentFiltersProfile(QObject *parent = nullptr);
 
 	virtual void clear() = 0;
+	virtual void loadRules() = 0;
 	virtual void setProfileSummary(const ProfileSummary &profileSummary) = 0;
 	virtual QString getName() const = 0;
 	virtual QString getTitle() const = 0;
@@ -149,8 +194,7 @@ public:
 	virtual QUrl getUpdateUrl() const = 0;
 	virtual QDateTime getLastUpdate() const = 0;
 	virtual ProfileSummary getProfileSummary() const = 0;
-	virtual ContentFiltersManager::CheckResult checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType) = 0;
-	virtual ContentFiltersManager::CosmeticFiltersResult getCosmeticFilters(const QStringList &domains, bool isDomainOnly) = 0;
+	virtual std::shared_ptr<const ContentFiltersRules> getRules() const = 0;
 	virtual QVector<QLocale::Language> getLanguages() const = 0;
 	virtual ProfileCategory getCategory() const = 0;
 	virtual ContentFiltersManager::CosmeticFiltersMode getCosmeticFiltersMode() const = 0;
@@ -166,6 +210,7 @@ public:
 
 signals:
 	void profileModified();
+	void rulesChanged();
 	void updateProgressChanged(int progress);
 };
 
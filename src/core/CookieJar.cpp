@@ -19,6 +19,7 @@
 
 #include "CookieJar.h"
 #include "Application.h"
+#include "Console.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 
@@ -26,6 +27,7 @@
 #include <QtCore/QFile>
 #include <QtCore/QSaveFile>
 #include <QtCore/QTimerEvent>
+#include <QtNetwork/QHostAddress>
 
 namespace Otter
 {
@@ -35,13 +37,37 @@ CookieJar::CookieJar(bool isPrivate, QObject *parent) : QNetworkCookieJar(parent
 	m_thirdPartyCookiesPolicy(AcceptAllCookies),
 	m_keepMode(KeepUntilExpiresMode),
 	m_saveTimer(0),
-	m_isPrivate(isPrivate)
+	m_recordsAmount(0),
+	m_isPrivate(isPrivate),
+	m_needsCompaction(false)
 {
 	if (isPrivate)
 	{
 		return;
 	}
 
+	loadCookies();
+	handleOptionChanged(SettingsManager::Network_CookiesPolicyOption, SettingsManager::getOption(SettingsManager::Network_CookiesPolicyOption));
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &CookieJar::handleOptionChanged);
+}
+
+void CookieJar::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_saveTimer)
+	{
+		return;
+	}
+
+	killTimer(m_saveTimer);
+
+	m_saveTimer = 0;
+
+	save();
+}
+
+void CookieJar::loadCookies()
+{
 	QFile file(SessionsManager::getWritableDataPath(QLatin1String("cookies.dat")));
 
 	if (!file.open(QIODevice::ReadOnly))
@@ -50,59 +76,137 @@ CookieJar::CookieJar(bool isPrivate, QObject *parent) : QNetworkCookieJar(parent
 	}
 
 	QDataStream stream(&file);
-	quint32 amount;
+	quint32 magic(0);
+
+	stream >> magic;
+
+	if (magic != JournalMagic)
+	{
+		for (quint32 i = 0; i < magic; ++i)
+		{
+			QByteArray value;
+
+			stream >> value;
+
+			const QList<QNetworkCookie> cookies(QNetworkCookie::parseCookies(value));
+
+			for (int j = 0; j < cookies.count(); ++j)
+			{
+				storeCookie(cookies.at(j));
+			}
+
+			if (stream.atEnd())
+			{
+				break;
+			}
+		}
+
+		m_pendingRecords.clear();
+		m_needsCompaction = true;
+
+		scheduleSave();
+
+		return;
+	}
 
-	stream >> amount;
+	quint32 version(0);
 
-	QList<QNetworkCookie> allCookies;
-	allCookies.reserve(static_cast<int>(amount));
+	stream >> version;
 
-	for (quint32 i = 0; i < amount; ++i)
+	if (version != JournalVersion)
 	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to load cookies: unsupported format"), Console::NetworkCategory, Console::ErrorLevel, file.fileName());
+
+		file.close();
+
+		if (!SessionsManager::isReadOnly())
+		{
+			const QString backupPath(file.fileName() + QLatin1String(".bak"));
+
+			QFile::remove(backupPath);
+
+			if (QFile::rename(file.fileName(), backupPath))
+			{
+				Console::addMessage(QCoreApplication::translate("main", "Moved unsupported cookies journal to %1").arg(backupPath), Console::NetworkCategory, Console::WarningLevel, file.fileName());
+			}
+		}
+
+		m_needsCompaction = true;
+
+		return;
+	}
+
+	while (!stream.atEnd())
+	{
+		quint32 length(0);
+		quint16 checksum(0);
+
+		stream >> length >> checksum;
+
+		const QByteArray payload((stream.status() == QDataStream::Ok && length <= static_cast<quint32>(file.bytesAvailable())) ? file.read(length) : QByteArray());
+
+		if (stream.status() != QDataStream::Ok || payload.size() != static_cast<int>(length) || qChecksum(payload.constData(), length) != checksum)
+		{
+			Console::addMessage(QCoreApplication::translate("main", "Cookies journal is damaged, discarding incomplete records"), Console::NetworkCategory, Console::WarningLevel, file.fileName());
+
+			m_needsCompaction = true;
+
+			break;
+		}
+
+		QDataStream payloadStream(payload);
+		quint8 type(UnknownRecord);
 		QByteArray value;
 
-		stream >> value;
+		payloadStream >> type >> value;
 
 		const QList<QNetworkCookie> cookies(QNetworkCookie::parseCookies(value));
 
-		for (int j = 0; j < cookies.count(); ++j)
+		if (cookies.isEmpty())
 		{
-			allCookies.append(cookies.at(j));
+			continue;
 		}
 
-		if (stream.atEnd())
+		switch (static_cast<RecordType>(type))
 		{
-			break;
-		}
-	}
+			case InsertRecord:
+				storeCookie(cookies.at(0));
 
-	handleOptionChanged(SettingsManager::Network_CookiesPolicyOption, SettingsManager::getOption(SettingsManager::Network_CookiesPolicyOption));
-	setAllCookies(allCookies);
+				break;
+			case RemoveRecord:
+				removeCookie(cookies.at(0));
 
-	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &CookieJar::handleOptionChanged);
-}
+				break;
+			default:
+				break;
+		}
 
-void CookieJar::timerEvent(QTimerEvent *event)
-{
-	if (event->timerId() != m_saveTimer)
-	{
-		return;
+		++m_recordsAmount;
 	}
 
-	killTimer(m_saveTimer);
+	m_pendingRecords.clear();
 
-	m_saveTimer = 0;
+	removeExpiredCookies();
 
-	save();
+	if (m_needsCompaction || (m_recordsAmount > MinimumCompactedRecordsAmount && m_recordsAmount > (m_expirationQueue.count() * 2)))
+	{
+		m_needsCompaction = true;
+
+		scheduleSave();
+	}
 }
 
 void CookieJar::clearCookies(int period)
 {
 	Q_UNUSED(period)
 
-	const QList<QNetworkCookie> cookies(allCookies());
+	const QVector<QNetworkCookie> cookies(getCookies());
 
-	setAllCookies({});
+	m_cookies.clear();
+	m_expirationQueue.clear();
+	m_pendingRecords.clear();
+
+	m_needsCompaction = true;
 
 	for (int i = 0; i < cookies.count(); ++i)
 	{
@@ -164,41 +268,130 @@ void CookieJar::handleOptionChanged(int identifier, const QVariant &value)
 
 void CookieJar::save()
 {
-	if (SessionsManager::isReadOnly())
+	if (m_isPrivate || SessionsManager::isReadOnly())
 	{
 		return;
 	}
 
-	QSaveFile file(SessionsManager::getWritableDataPath(QLatin1String("cookies.dat")));
+	removeExpiredCookies();
 
-	if (!file.open(QIODevice::WriteOnly))
+	if (!m_needsCompaction && m_recordsAmount > MinimumCompactedRecordsAmount && m_recordsAmount > (m_expirationQueue.count() * 2))
 	{
-		return;
+		m_needsCompaction = true;
 	}
 
-	const QList<QNetworkCookie> cookies(allCookies());
-	QDataStream stream(&file);
-	stream << static_cast<quint32>(cookies.count());
+	if (m_needsCompaction)
+	{
+		writeCookies();
+	}
+	else
+	{
+		appendRecords();
+	}
+}
 
-	for (int i = 0; i < cookies.count(); ++i)
+void CookieJar::removeExpiredCookies()
+{
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+
+	while (!m_expirationQueue.isEmpty() && m_expirationQueue.firstKey() < currentDateTime)
 	{
-		if (!cookies.at(i).isSessionCookie())
+		const QNetworkCookie cookie(m_expirationQueue.first());
+		const QString domain(getRegistrableDomain(cookie.domain()));
+
+		m_expirationQueue.erase(m_expirationQueue.begin());
+
+		if (m_cookies.contains(domain))
 		{
-			stream << cookies.at(i).toRawForm();
+			QVector<QNetworkCookie> &cookies(m_cookies[domain]);
+
+			for (int i = 0; i < cookies.count(); ++i)
+			{
+				if (cookies.at(i).hasSameIdentifier(cookie))
+				{
+					cookies.removeAt(i);
+
+					break;
+				}
+			}
+
+			if (cookies.isEmpty())
+			{
+				m_cookies.remove(domain);
+			}
 		}
+
+		emit cookieRemoved(cookie);
 	}
+}
 
-	file.commit();
+void CookieJar::addRecord(RecordType type, const QNetworkCookie &cookie)
+{
+	if (m_isPrivate)
+	{
+		return;
+	}
+
+	Record record;
+	record.cookie = cookie;
+	record.type = type;
+
+	m_pendingRecords.append(record);
 }
 
 CookieJar* CookieJar::clone(QObject *parent) const
 {
-	CookieJar *cookieJar(new CookieJar(m_isPrivate, parent));
-	cookieJar->setAllCookies(allCookies());
+	CookieJar *cookieJar(new CookieJar(true, parent));
+	cookieJar->m_cookies = m_cookies;
+	cookieJar->m_expirationQueue = m_expirationQueue;
+	cookieJar->m_generalCookiesPolicy = m_generalCookiesPolicy;
 
 	return cookieJar;
 }
 
+QString CookieJar::getRegistrableDomain(const QString &host)
+{
+	const QString normalizedHost((host.startsWith(QLatin1Char('.')) ? host.mid(1) : host).toLower());
+
+	if (!QHostAddress(normalizedHost).isNull())
+	{
+		return normalizedHost;
+	}
+
+	QUrl url;
+	url.setScheme(QLatin1String("http"));
+	url.setHost(normalizedHost);
+
+	const QString topLevelDomain(url.topLevelDomain());
+
+	if (topLevelDomain.isEmpty())
+	{
+		return normalizedHost.section(QLatin1Char('.'), -1);
+	}
+
+	if (normalizedHost.length() <= topLevelDomain.length())
+	{
+		return normalizedHost;
+	}
+
+	return (normalizedHost.left(normalizedHost.length() - topLevelDomain.length()).section(QLatin1Char('.'), -1) + topLevelDomain);
+}
+
+QByteArray CookieJar::createRecord(const Record &record)
+{
+	QByteArray payload;
+	QDataStream payloadStream(&payload, QIODevice::WriteOnly);
+	payloadStream << static_cast<quint8>(record.type) << record.cookie.toRawForm();
+
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream << static_cast<quint32>(payload.size()) << qChecksum(payload.constData(), static_cast<uint>(payload.size()));
+
+	data.append(payload);
+
+	return data;
+}
+
 QList<QNetworkCookie> CookieJar::cookiesForUrl(const QUrl &url) const
 {
 	if (m_generalCookiesPolicy == IgnoreCookies)
@@ -206,33 +399,74 @@ QList<QNetworkCookie> CookieJar::cookiesForUrl(const QUrl &url) const
 		return {};
 	}
 
-	return QNetworkCookieJar::cookiesForUrl(url);
+	return getCookiesForUrl(url);
 }
 
 QList<QNetworkCookie> CookieJar::getCookiesForUrl(const QUrl &url) const
 {
-	return QNetworkCookieJar::cookiesForUrl(url);
+	const QString host(url.host().toLower());
+	const QString domain(getRegistrableDomain(host));
+
+	if (!m_cookies.contains(domain))
+	{
+		return {};
+	}
+
+	const QVector<QNetworkCookie> cookies(m_cookies.value(domain));
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	const QString path(url.path());
+	const bool isEncrypted(url.scheme() == QLatin1String("https"));
+	QList<QNetworkCookie> matchingCookies;
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		const QNetworkCookie cookie(cookies.at(i));
+
+		if (!isParentDomain(host, cookie.domain()) || !isParentPath(path, cookie.path()) || (cookie.isSecure() && !isEncrypted) || (!cookie.isSessionCookie() && cookie.expirationDate() < currentDateTime))
+		{
+			continue;
+		}
+
+		int position(0);
+
+		while (position < matchingCookies.count() && matchingCookies.at(position).path().length() >= cookie.path().length())
+		{
+			++position;
+		}
+
+		matchingCookies.insert(position, cookie);
+	}
+
+	return matchingCookies;
 }
 
 QVector<QNetworkCookie> CookieJar::getCookies(const QString &domain) const
 {
-	if (!domain.isEmpty())
+	QVector<QNetworkCookie> cookies;
+
+	if (domain.isEmpty())
 	{
-		const QList<QNetworkCookie> cookies(allCookies());
-		QVector<QNetworkCookie> domainCookies;
+		QHash<QString, QVector<QNetworkCookie> >::const_iterator iterator;
 
-		for (int i = 0; i < cookies.count(); ++i)
+		for (iterator = m_cookies.constBegin(); iterator != m_cookies.constEnd(); ++iterator)
 		{
-			if (cookies.at(i).domain() == domain || (cookies.at(i).domain().startsWith(QLatin1Char('.')) && domain.endsWith(cookies.at(i).domain())))
-			{
-				domainCookies.append(cookies.at(i));
-			}
+			cookies.append(iterator.value());
 		}
 
-		return domainCookies;
+		return cookies;
+	}
+
+	const QVector<QNetworkCookie> domainCookies(m_cookies.value(getRegistrableDomain(domain)));
+
+	for (int i = 0; i < domainCookies.count(); ++i)
+	{
+		if (domainCookies.at(i).domain() == domain || (domainCookies.at(i).domain().startsWith(QLatin1Char('.')) && domain.endsWith(domainCookies.at(i).domain())))
+		{
+			cookies.append(domainCookies.at(i));
+		}
 	}
 
-	return allCookies().toVector();
+	return cookies;
 }
 
 bool CookieJar::insertCookie(const QNetworkCookie &cookie)
@@ -242,102 +476,242 @@ bool CookieJar::insertCookie(const QNetworkCookie &cookie)
 		return false;
 	}
 
-	const bool result(QNetworkCookieJar::insertCookie(cookie));
+	return forceInsertCookie(cookie);
+}
 
-	if (result)
+bool CookieJar::updateCookie(const QNetworkCookie &cookie)
+{
+	if (m_generalCookiesPolicy == IgnoreCookies || m_generalCookiesPolicy == ReadOnlyCookies)
 	{
-		scheduleSave();
-
-		emit cookieAdded(cookie);
+		return false;
 	}
 
-	return result;
+	return forceUpdateCookie(cookie);
 }
 
-bool CookieJar::updateCookie(const QNetworkCookie &cookie)
+bool CookieJar::deleteCookie(const QNetworkCookie &cookie)
 {
 	if (m_generalCookiesPolicy == IgnoreCookies || m_generalCookiesPolicy == ReadOnlyCookies)
 	{
 		return false;
 	}
 
-	const bool result(QNetworkCookieJar::updateCookie(cookie));
+	return forceDeleteCookie(cookie);
+}
+
+bool CookieJar::forceInsertCookie(const QNetworkCookie &cookie)
+{
+	const bool wasRemoved(removeCookie(cookie));
+	const bool result(storeCookie(cookie));
+
+	scheduleSave();
 
 	if (result)
 	{
-		scheduleSave();
+		emit cookieAdded(cookie);
+	}
+	else if (wasRemoved)
+	{
+		emit cookieRemoved(cookie);
 	}
 
 	return result;
 }
 
-bool CookieJar::deleteCookie(const QNetworkCookie &cookie)
+bool CookieJar::forceUpdateCookie(const QNetworkCookie &cookie)
 {
-	if (m_generalCookiesPolicy == IgnoreCookies || m_generalCookiesPolicy == ReadOnlyCookies)
+	if (!removeCookie(cookie))
 	{
 		return false;
 	}
 
-	const bool result(QNetworkCookieJar::deleteCookie(cookie));
+	const bool result(storeCookie(cookie));
 
-	if (result)
-	{
-		scheduleSave();
+	scheduleSave();
 
+	if (!result)
+	{
 		emit cookieRemoved(cookie);
 	}
 
 	return result;
 }
 
-bool CookieJar::forceInsertCookie(const QNetworkCookie &cookie)
+bool CookieJar::forceDeleteCookie(const QNetworkCookie &cookie)
 {
-	const bool result(QNetworkCookieJar::insertCookie(cookie));
+	const bool result(removeCookie(cookie));
 
 	if (result)
 	{
 		scheduleSave();
 
-		emit cookieAdded(cookie);
+		emit cookieRemoved(cookie);
 	}
 
 	return result;
 }
 
-bool CookieJar::forceUpdateCookie(const QNetworkCookie &cookie)
+bool CookieJar::storeCookie(const QNetworkCookie &cookie)
 {
-	const bool result(QNetworkCookieJar::updateCookie(cookie));
+	removeCookie(cookie);
 
-	if (result)
+	if (!cookie.isSessionCookie() && cookie.expirationDate() < QDateTime::currentDateTimeUtc())
 	{
-		scheduleSave();
+		return false;
 	}
 
-	return result;
+	m_cookies[getRegistrableDomain(cookie.domain())].append(cookie);
+
+	if (!cookie.isSessionCookie())
+	{
+		m_expirationQueue.insert(cookie.expirationDate().toUTC(), cookie);
+
+		addRecord(InsertRecord, cookie);
+	}
+
+	return true;
 }
 
-bool CookieJar::forceDeleteCookie(const QNetworkCookie &cookie)
+bool CookieJar::removeCookie(const QNetworkCookie &cookie)
 {
-	const bool result(QNetworkCookieJar::deleteCookie(cookie));
+	const QString domain(getRegistrableDomain(cookie.domain()));
 
-	if (result)
+	if (!m_cookies.contains(domain))
 	{
-		scheduleSave();
+		return false;
+	}
 
-		emit cookieRemoved(cookie);
+	QVector<QNetworkCookie> &cookies(m_cookies[domain]);
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		if (!cookies.at(i).hasSameIdentifier(cookie))
+		{
+			continue;
+		}
+
+		const QNetworkCookie removedCookie(cookies.takeAt(i));
+
+		if (cookies.isEmpty())
+		{
+			m_cookies.remove(domain);
+		}
+
+		if (!removedCookie.isSessionCookie())
+		{
+			QMultiMap<QDateTime, QNetworkCookie>::iterator iterator(m_expirationQueue.find(removedCookie.expirationDate().toUTC()));
+
+			while (iterator != m_expirationQueue.end() && iterator.key() == removedCookie.expirationDate().toUTC())
+			{
+				if (iterator.value().hasSameIdentifier(removedCookie))
+				{
+					m_expirationQueue.erase(iterator);
+
+					break;
+				}
+
+				++iterator;
+			}
+
+			addRecord(RemoveRecord, removedCookie);
+		}
+
+		return true;
 	}
 
-	return result;
+	return false;
 }
 
-bool CookieJar::hasCookie(const QNetworkCookie &cookie) const
+bool CookieJar::appendRecords()
 {
-	QUrl url;
-	url.setScheme(cookie.isSecure() ? QLatin1String("https") : QLatin1String("http"));
-	url.setHost(cookie.domain().startsWith(QLatin1Char('.')) ? cookie.domain().mid(1) : cookie.domain());
-	url.setPath(cookie.path());
+	if (m_pendingRecords.isEmpty())
+	{
+		return true;
+	}
+
+	QFile file(SessionsManager::getWritableDataPath(QLatin1String("cookies.dat")));
+	const bool needsHeader(!file.exists() || file.size() < JournalHeaderSize);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save cookies: %1").arg(file.errorString()), Console::NetworkCategory, Console::ErrorLevel, file.fileName());
+
+		return false;
+	}
+
+	if (needsHeader)
+	{
+		QDataStream stream(&file);
+
+		file.resize(0);
+
+		stream << static_cast<quint32>(JournalMagic) << static_cast<quint32>(JournalVersion);
+	}
+
+	for (int i = 0; i < m_pendingRecords.count(); ++i)
+	{
+		const QByteArray data(createRecord(m_pendingRecords.at(i)));
+
+		if (file.write(data) != data.size())
+		{
+			Console::addMessage(QCoreApplication::translate("main", "Failed to save cookies: %1").arg(file.errorString()), Console::NetworkCategory, Console::ErrorLevel, file.fileName());
 
-	const QList<QNetworkCookie> cookies(getCookiesForUrl(url));
+			m_needsCompaction = true;
+
+			return false;
+		}
+	}
+
+	m_recordsAmount += m_pendingRecords.count();
+
+	m_pendingRecords.clear();
+
+	return true;
+}
+
+bool CookieJar::writeCookies()
+{
+	QSaveFile file(SessionsManager::getWritableDataPath(QLatin1String("cookies.dat")));
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save cookies: %1").arg(file.errorString()), Console::NetworkCategory, Console::ErrorLevel, file.fileName());
+
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream << static_cast<quint32>(JournalMagic) << static_cast<quint32>(JournalVersion);
+
+	QMultiMap<QDateTime, QNetworkCookie>::const_iterator iterator;
+
+	for (iterator = m_expirationQueue.constBegin(); iterator != m_expirationQueue.constEnd(); ++iterator)
+	{
+		Record record;
+		record.cookie = iterator.value();
+		record.type = InsertRecord;
+
+		file.write(createRecord(record));
+	}
+
+	if (!file.commit())
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save cookies: %1").arg(file.errorString()), Console::NetworkCategory, Console::ErrorLevel, file.fileName());
+
+		return false;
+	}
+
+	m_recordsAmount = m_expirationQueue.count();
+	m_needsCompaction = false;
+
+	m_pendingRecords.clear();
+
+	return true;
+}
+
+bool CookieJar::hasCookie(const QNetworkCookie &cookie) const
+{
+	const QVector<QNetworkCookie> cookies(m_cookies.value(getRegistrableDomain(cookie.domain())));
 
 	for (int i = 0; i < cookies.count(); ++i)
 	{
@@ -350,6 +724,26 @@ bool CookieJar::hasCookie(const QNetworkCookie &cookie) const
 	return false;
 }
 
+bool CookieJar::isParentDomain(const QString &host, const QString &domain)
+{
+	if (!domain.startsWith(QLatin1Char('.')))
+	{
+		return (host == domain);
+	}
+
+	return (host.endsWith(domain) || host == domain.midRef(1));
+}
+
+bool CookieJar::isParentPath(const QString &path, const QString &reference)
+{
+	if ((path.isEmpty() && reference == QLatin1String("/")) || path.startsWith(reference))
+	{
+		return (path.length() == reference.length() || reference.endsWith(QLatin1Char('/')) || path.at(reference.length()) == QLatin1Char('/'));
+	}
+
+	return false;
+}
+
 bool CookieJar::isDomainTheSame(const QUrl &first, const QUrl &second)
 {
 	const QString firstTld(first.topLevelDomain());
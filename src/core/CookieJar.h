@@ -20,6 +20,10 @@
 #ifndef OTTER_COOKIEJAR_H
 #define OTTER_COOKIEJAR_H
 
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QMultiMap>
+#include <QtCore/QVector>
 #include <QtNetwork/QNetworkCookie>
 #include <QtNetwork/QNetworkCookieJar>
 
@@ -70,19 +74,57 @@ public:
 	static bool isDomainTheSame(const QUrl &first, const QUrl &second);
 
 protected:
+	enum JournalConstant
+	{
+		JournalMagic = 0x4F434A4C,
+		JournalVersion = 1,
+		JournalHeaderSize = 8,
+		RecordHeaderSize = 6,
+		MinimumCompactedRecordsAmount = 1000
+	};
+
+	enum RecordType
+	{
+		UnknownRecord = 0,
+		InsertRecord,
+		RemoveRecord
+	};
+
+	struct Record final
+	{
+		QNetworkCookie cookie;
+		RecordType type = UnknownRecord;
+	};
+
 	void timerEvent(QTimerEvent *event) override;
+	void loadCookies();
 	void scheduleSave();
 	void save();
+	void removeExpiredCookies();
+	void addRecord(RecordType type, const QNetworkCookie &cookie);
+	static QString getRegistrableDomain(const QString &host);
+	static QByteArray createRecord(const Record &record);
+	bool storeCookie(const QNetworkCookie &cookie);
+	bool removeCookie(const QNetworkCookie &cookie);
+	bool appendRecords();
+	bool writeCookies();
+	static bool isParentDomain(const QString &host, const QString &domain);
+	static bool isParentPath(const QString &path, const QString &reference);
 
 protected slots:
 	void handleOptionChanged(int identifier, const QVariant &value);
 
 private:
+	QHash<QString, QVector<QNetworkCookie> > m_cookies;
+	QMultiMap<QDateTime, QNetworkCookie> m_expirationQueue;
+	QVector<Record> m_pendingRecords;
 	CookiesPolicy m_generalCookiesPolicy;
 	CookiesPolicy m_thirdPartyCookiesPolicy;
 	KeepMode m_keepMode;
 	int m_saveTimer;
+	int m_recordsAmount;
 	bool m_isPrivate;
+	bool m_needsCompaction;
 
 signals:
 	void cookieAdded(QNetworkCookie cookie);
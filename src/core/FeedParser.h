@@ -20,6 +20,7 @@
 #ifndef OTTER_FEEDPARSER_H
 #define OTTER_FEEDPARSER_H
 
+#include "Console.h"
 #include "FeedsManager.h"
 
 #include <QtCore/QMimeType>
@@ -55,15 +56,17 @@ public:
 
 	explicit FeedParser();
 
-	virtual void parse(DataFetchJob *data) = 0;
 	virtual FeedInformation getInformation() const = 0;
 	static FeedParser* createParser(Feed *feed, DataFetchJob *data);
+	QVector<Console::Message> getMessages() const;
+	virtual bool parse(const QByteArray &data, const QUrl &url) = 0;
 
 protected:
+	void addMessage(const QString &note, Console::MessageCategory category, const QUrl &url, int line = -1);
 	static QString createIdentifier(const Feed::Entry &entry);
 
-signals:
-	void parsingFinished(bool isSuccess);
+private:
+	QVector<Console::Message> m_messages;
 };
 
 class AtomFeedParser final : public FeedParser
@@ -71,8 +74,8 @@ class AtomFeedParser final : public FeedParser
 public:
 	explicit AtomFeedParser();
 
-	void parse(DataFetchJob *data) override;
 	FeedInformation getInformation() const override;
+	bool parse(const QByteArray &data, const QUrl &url) override;
 
 protected:
 	QDateTime readDateTime(QXmlStreamReader *reader);
@@ -86,8 +89,8 @@ class RssFeedParser final : public FeedParser
 public:
 	explicit RssFeedParser();
 
-	void parse(DataFetchJob *data) override;
 	FeedInformation getInformation() const override;
+	bool parse(const QByteArray &data, const QUrl &url) override;
 
 protected:
 	QDateTime readDateTime(QXmlStreamReader *reader);
@@ -28,7 +28,9 @@
 #include "SessionsManager.h"
 #include "Utils.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -39,7 +41,6 @@ namespace Otter
 
 Feed::Feed(const QString &title, const QUrl &url, const QIcon &icon, int updateInterval, QObject *parent) : QObject(parent),
 	m_updateTimer(nullptr),
-	m_parser(nullptr),
 	m_title(title),
 	m_url(url),
 	m_icon(icon),
@@ -51,6 +52,11 @@ Feed::Feed(const QString &title, const QUrl &url, const QIcon &icon, int updateI
 	setUpdateInterval(updateInterval);
 }
 
+Feed::~Feed()
+{
+	FeedsManager::cancelUpdate(this);
+}
+
 void Feed::markEntryAsRead(const QString &identifier)
 {
 	for (int i = 0; i < m_entries.count(); ++i)
@@ -76,7 +82,7 @@ void Feed::markEntryAsRemoved(const QString &identifier)
 			{
 				m_entries.removeAt(i);
 
-				m_removedEntries.append(identifier);
+				m_removedEntries.insert(identifier);
 
 				emit feedModified(this);
 
@@ -142,7 +148,13 @@ void Feed::setCategories(const QMap<QString, QString> &categories)
 
 void Feed::setRemovedEntries(const QStringList &removedEntries)
 {
-	m_removedEntries = removedEntries;
+	m_removedEntries.clear();
+	m_removedEntries.reserve(removedEntries.count());
+
+	for (int i = 0; i < removedEntries.count(); ++i)
+	{
+		m_removedEntries.insert(removedEntries.at(i));
+	}
 }
 
 void Feed::setEntries(const QVector<Feed::Entry> &entries)
@@ -179,7 +191,7 @@ void Feed::setUpdateInterval(int interval)
 
 void Feed::update()
 {
-	if (m_parser)
+	if (m_isUpdating)
 	{
 		return;
 	}
@@ -189,7 +201,13 @@ void Feed::update()
 
 	emit feedModified(this);
 
+	FeedsManager::scheduleUpdate(this);
+}
+
+void Feed::startUpdate()
+{
 	DataFetchJob *dataJob(new DataFetchJob(m_url, this));
+	dataJob->setConditional(m_lastSynchronizationTime.isValid());
 
 	connect(dataJob, &DataFetchJob::progressChanged, this, [&](int progress)
 	{
@@ -199,141 +217,44 @@ void Feed::update()
 	});
 	connect(dataJob, &DataFetchJob::jobFinished, this, [=](bool isFetchSuccess)
 	{
-		if (isFetchSuccess)
-		{
-			m_parser = FeedParser::createParser(this, dataJob);
-
-			if (m_parser)
-			{
-				m_parser->moveToThread(&m_parserThread);
-
-				connect(m_parser, &FeedParser::parsingFinished, m_parser, [&](bool isParsingSuccess)
-				{
-					const FeedParser::FeedInformation information(m_parser->getInformation());
-
-					if (!isParsingSuccess)
-					{
-						m_error = ParseError;
-					}
-
-					if (m_icon.isNull() && information.icon.isValid())
-					{
-						IconFetchJob *iconJob(new IconFetchJob(information.icon, this));
+		FeedsManager::finishUpdate(this);
 
-						connect(iconJob, &IconFetchJob::jobFinished, this, [=]()
-						{
-							setIcon(iconJob->getIcon());
-						});
+		if (isFetchSuccess && dataJob->isNotModified())
+		{
+			m_lastSynchronizationTime = QDateTime::currentDateTimeUtc();
+			m_updateProgress = -1;
+			m_isUpdating = false;
 
-						iconJob->start();
-					}
+			emit updateProgressChanged(-1);
+			emit feedModified(this);
+		}
+		else if (isFetchSuccess)
+		{
+			FeedParser *rawParser(FeedParser::createParser(this, dataJob));
 
-					if (m_title.isEmpty())
-					{
-						m_title = information.title;
-					}
+			if (rawParser)
+			{
+				const QSharedPointer<FeedParser> parser(rawParser, &QObject::deleteLater);
+				const QByteArray data(dataJob->getData()->readAll());
+				const QUrl url(m_url);
+				QFutureWatcher<bool> *watcher(new QFutureWatcher<bool>(this));
 
-					if (m_description.isEmpty())
-					{
-						m_description = information.description;
-					}
+				m_parser = parser;
 
-					if (!information.entries.isEmpty())
+				connect(watcher, &QFutureWatcher<bool>::finished, this, [=]()
+				{
+					if (m_parser == parser)
 					{
-						QStringList existingRemovedEntries;
-						int amount(0);
-
-						for (int i = (information.entries.count() - 1); i >= 0; --i)
-						{
-							Feed::Entry entry(information.entries.at(i));
-
-							if (m_removedEntries.contains(entry.identifier))
-							{
-								existingRemovedEntries.append(entry.identifier);
-							}
-							else
-							{
-								bool hasEntry(false);
-
-								for (int j = 0; j < m_entries.count(); ++j)
-								{
-									const Feed::Entry existingEntry(m_entries.at(j));
-
-									if (existingEntry.identifier == entry.identifier)
-									{
-										if ((entry.publicationTime.isValid() && existingEntry.publicationTime != entry.publicationTime) || (entry.updateTime.isValid() && existingEntry.updateTime != entry.updateTime))
-										{
-											++amount;
-										}
-
-										entry.publicationTime = normalizeTime(entry.publicationTime);
-
-										if (entry.updateTime.isValid())
-										{
-											entry.updateTime = normalizeTime(entry.updateTime);
-										}
-
-										m_entries[j] = entry;
-
-										hasEntry = true;
-
-										break;
-									}
-								}
-
-								if (!hasEntry)
-								{
-									++amount;
-
-									entry.publicationTime = normalizeTime(entry.publicationTime);
-									entry.updateTime = normalizeTime(entry.updateTime);
-
-									m_entries.prepend(entry);
-								}
-							}
-						}
-
-						m_removedEntries = existingRemovedEntries;
-
-						if (amount > 0)
-						{
-							Notification::Message message;
-							message.message = getTitle() + QLatin1Char('\n') + tr("%n new message(s)", nullptr, amount);
-							message.icon = getIcon();
-							message.event = NotificationsManager::FeedUpdatedEvent;
-
-							if (message.icon.isNull())
-							{
-								message.icon = ThemesManager::createIcon(QLatin1String("application-rss+xml"));
-							}
-
-							connect(NotificationsManager::createNotification(message, this), &Notification::clicked, this, [&]()
-							{
-								Application::getInstance()->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), FeedsManager::createFeedReaderUrl(getUrl())}});
-							});
-						}
-
-						emit entriesModified(this);
+						handleParsingFinished(watcher->result());
 					}
 
-					m_mimeType = information.mimeType;
-					m_lastSynchronizationTime = QDateTime::currentDateTimeUtc();
-					m_lastUpdateTime = information.lastUpdateTime;
-					m_categories = information.categories;
-
-					m_parserThread.exit();
-
-					m_parser->deleteLater();
-					m_parser = nullptr;
-
-					m_isUpdating = false;
-
-					emit feedModified(this);
+					watcher->deleteLater();
 				});
 
-				m_parserThread.start();
-
-				m_parser->parse(dataJob);
+				watcher->setFuture(QtConcurrent::run(FeedsManager::getParserThreadPool(), [=]()
+				{
+					return parser->parse(data, url);
+				}));
 
 				m_updateProgress = -1;
 
@@ -363,6 +284,163 @@ void Feed::update()
 	dataJob->start();
 }
 
+void Feed::handleParsingFinished(bool isSuccess)
+{
+	const FeedParser::FeedInformation information(m_parser->getInformation());
+	const QVector<Console::Message> messages(m_parser->getMessages());
+
+	for (int i = 0; i < messages.count(); ++i)
+	{
+		const Console::Message &message(messages.at(i));
+
+		Console::addMessage(message.note, message.category, message.level, message.source, message.line);
+	}
+
+	if (isSuccess)
+	{
+		DataFetchJob::commitValidators(m_url);
+	}
+	else
+	{
+		m_error = ParseError;
+	}
+
+	if (m_icon.isNull() && information.icon.isValid())
+	{
+		IconFetchJob *iconJob(new IconFetchJob(information.icon, this));
+
+		connect(iconJob, &IconFetchJob::jobFinished, this, [=]()
+		{
+			setIcon(iconJob->getIcon());
+		});
+
+		iconJob->start();
+	}
+
+	if (m_title.isEmpty())
+	{
+		m_title = information.title;
+	}
+
+	if (m_description.isEmpty())
+	{
+		m_description = information.description;
+	}
+
+	if (!information.entries.isEmpty())
+	{
+		QHash<QString, int> existingEntries;
+		existingEntries.reserve(m_entries.count());
+
+		for (int i = 0; i < m_entries.count(); ++i)
+		{
+			existingEntries.insert(m_entries.at(i).identifier, i);
+		}
+
+		QSet<QString> existingRemovedEntries;
+		QHash<QString, int> addedEntriesIndexes;
+		QVector<Entry> addedEntries;
+		int amount(0);
+
+		for (int i = (information.entries.count() - 1); i >= 0; --i)
+		{
+			Feed::Entry entry(information.entries.at(i));
+
+			if (m_removedEntries.contains(entry.identifier))
+			{
+				existingRemovedEntries.insert(entry.identifier);
+
+				continue;
+			}
+
+			if (existingEntries.contains(entry.identifier))
+			{
+				const int index(existingEntries.value(entry.identifier));
+				const Feed::Entry &existingEntry(m_entries.at(index));
+
+				if ((entry.publicationTime.isValid() && existingEntry.publicationTime != entry.publicationTime) || (entry.updateTime.isValid() && existingEntry.updateTime != entry.updateTime))
+				{
+					++amount;
+				}
+
+				entry.publicationTime = normalizeTime(entry.publicationTime);
+
+				if (entry.updateTime.isValid())
+				{
+					entry.updateTime = normalizeTime(entry.updateTime);
+				}
+
+				m_entries[index] = entry;
+			}
+			else
+			{
+				entry.publicationTime = normalizeTime(entry.publicationTime);
+				entry.updateTime = normalizeTime(entry.updateTime);
+
+				if (addedEntriesIndexes.contains(entry.identifier))
+				{
+					addedEntries[addedEntriesIndexes.value(entry.identifier)] = entry;
+				}
+				else
+				{
+					++amount;
+
+					addedEntriesIndexes.insert(entry.identifier, addedEntries.count());
+					addedEntries.append(entry);
+				}
+			}
+		}
+
+		if (!addedEntries.isEmpty())
+		{
+			QVector<Entry> entries;
+			entries.reserve(addedEntries.count() + m_entries.count());
+
+			for (int i = (addedEntries.count() - 1); i >= 0; --i)
+			{
+				entries.append(addedEntries.at(i));
+			}
+
+			entries += m_entries;
+
+			m_entries = entries;
+		}
+
+		m_removedEntries = existingRemovedEntries;
+
+		if (amount > 0)
+		{
+			Notification::Message message;
+			message.message = getTitle() + QLatin1Char('\n') + tr("%n new message(s)", nullptr, amount);
+			message.icon = getIcon();
+			message.event = NotificationsManager::FeedUpdatedEvent;
+
+			if (message.icon.isNull())
+			{
+				message.icon = ThemesManager::createIcon(QLatin1String("application-rss+xml"));
+			}
+
+			connect(NotificationsManager::createNotification(message, this), &Notification::clicked, this, [&]()
+			{
+				Application::getInstance()->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), FeedsManager::createFeedReaderUrl(getUrl())}});
+			});
+		}
+
+		emit entriesModified(this);
+	}
+
+	m_mimeType = information.mimeType;
+	m_lastSynchronizationTime = QDateTime::currentDateTimeUtc();
+	m_lastUpdateTime = information.lastUpdateTime;
+	m_categories = information.categories;
+
+	m_parser.reset();
+
+	m_isUpdating = false;
+
+	emit feedModified(this);
+}
+
 QString Feed::getTitle() const
 {
 	return m_title;
@@ -412,7 +490,7 @@ QMap<QString, QString> Feed::getCategories() const
 
 QStringList Feed::getRemovedEntries() const
 {
-	return m_removedEntries;
+	return m_removedEntries.values();
 }
 
 QVector<Feed::Entry> Feed::getEntries(const QStringList &categories) const
@@ -485,7 +563,10 @@ bool Feed::isUpdating() const
 
 FeedsManager* FeedsManager::m_instance(nullptr);
 FeedsModel* FeedsManager::m_model(nullptr);
+QThreadPool* FeedsManager::m_parserThreadPool(nullptr);
 QVector<Feed*> FeedsManager::m_feeds;
+QQueue<QPointer<Feed> > FeedsManager::m_pendingUpdates;
+QSet<Feed*> FeedsManager::m_activeUpdates;
 bool FeedsManager::m_isInitialized(false);
 
 FeedsManager::FeedsManager(QObject *parent) : QObject(parent),
@@ -710,6 +791,46 @@ void FeedsManager::ensureInitialized()
 	}
 }
 
+void FeedsManager::scheduleUpdate(Feed *feed)
+{
+	if (!m_activeUpdates.contains(feed) && !m_pendingUpdates.contains(feed))
+	{
+		m_pendingUpdates.enqueue(feed);
+	}
+
+	startUpdates();
+}
+
+void FeedsManager::cancelUpdate(Feed *feed)
+{
+	m_pendingUpdates.removeAll(feed);
+
+	finishUpdate(feed);
+}
+
+void FeedsManager::finishUpdate(Feed *feed)
+{
+	if (m_activeUpdates.remove(feed))
+	{
+		startUpdates();
+	}
+}
+
+void FeedsManager::startUpdates()
+{
+	while (m_activeUpdates.count() < MaximumActiveUpdatesAmount && !m_pendingUpdates.isEmpty())
+	{
+		Feed *feed(m_pendingUpdates.dequeue().data());
+
+		if (feed)
+		{
+			m_activeUpdates.insert(feed);
+
+			feed->startUpdate();
+		}
+	}
+}
+
 void FeedsManager::scheduleSave()
 {
 	if (m_saveTimer == 0)
@@ -733,6 +854,17 @@ FeedsManager* FeedsManager::getInstance()
 	return m_instance;
 }
 
+QThreadPool* FeedsManager::getParserThreadPool()
+{
+	if (!m_parserThreadPool)
+	{
+		m_parserThreadPool = new QThreadPool(QCoreApplication::instance());
+		m_parserThreadPool->setMaxThreadCount(MaximumParserThreadsAmount);
+	}
+
+	return m_parserThreadPool;
+}
+
 FeedsModel* FeedsManager::getModel()
 {
 	ensureInitialized();
@@ -24,7 +24,11 @@
 
 #include <QtCore/QDateTime>
 #include <QtCore/QMimeType>
-#include <QtCore/QThread>
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+#include <QtCore/QSet>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
 
 namespace Otter
 {
@@ -61,6 +65,7 @@ public:
 	};
 
 	explicit Feed(const QString &title, const QUrl &url, const QIcon &icon, int updateInterval, QObject *parent = nullptr);
+	~Feed();
 
 	void markEntryAsRead(const QString &identifier);
 	void markEntryAsRemoved(const QString &identifier);
@@ -91,6 +96,8 @@ public slots:
 	void update();
 
 protected:
+	void startUpdate();
+	void handleParsingFinished(bool isSuccess);
 	void setCategories(const QMap<QString, QString> &categories);
 	void setRemovedEntries(const QStringList &removedEntries);
 	void setEntries(const QVector<Entry> &entries);
@@ -98,8 +105,7 @@ protected:
 
 private:
 	LongTermTimer *m_updateTimer;
-	FeedParser *m_parser;
-	QThread m_parserThread;
+	QSharedPointer<FeedParser> m_parser;
 	QString m_title;
 	QString m_description;
 	QUrl m_url;
@@ -108,7 +114,7 @@ private:
 	QDateTime m_lastSynchronizationTime;
 	QMimeType m_mimeType;
 	QMap<QString, QString> m_categories;
-	QStringList m_removedEntries;
+	QSet<QString> m_removedEntries;
 	QVector<Entry> m_entries;
 	FeedError m_error;
 	int m_updateInterval;
@@ -137,10 +143,21 @@ public:
 	static QVector<Feed*> getFeeds();
 
 protected:
+	enum UpdateLimit
+	{
+		MaximumActiveUpdatesAmount = 4,
+		MaximumParserThreadsAmount = 2
+	};
+
 	explicit FeedsManager(QObject *parent);
 
 	void timerEvent(QTimerEvent *event) override;
 	static void ensureInitialized();
+	static void scheduleUpdate(Feed *feed);
+	static void cancelUpdate(Feed *feed);
+	static void finishUpdate(Feed *feed);
+	static void startUpdates();
+	static QThreadPool* getParserThreadPool();
 
 protected slots:
 	void scheduleSave();
@@ -151,13 +168,18 @@ private:
 
 	static FeedsManager *m_instance;
 	static FeedsModel *m_model;
+	static QThreadPool *m_parserThreadPool;
 	static QVector<Feed*> m_feeds;
+	static QQueue<QPointer<Feed> > m_pendingUpdates;
+	static QSet<Feed*> m_activeUpdates;
 	static bool m_isInitialized;
 
 signals:
 	void feedAdded(const QUrl &url);
 	void feedModified(const QUrl &url);
 	void feedRemoved(const QUrl &url);
+
+friend class Feed;
 };
 
 }
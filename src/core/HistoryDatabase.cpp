@@ -0,0 +1,345 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HistoryDatabase.h"
+#include "Console.h"
+#include "Utils.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+namespace Otter
+{
+
+HistoryDatabase::HistoryDatabase(const QString &path) :
+	m_connectionName(QLatin1String("history:") + path),
+	m_isValid(false)
+{
+	if (!QSqlDatabase::isDriverAvailable(QLatin1String("QSQLITE")))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to open history database: SQLite driver is not available"), Console::OtherCategory, Console::ErrorLevel, path);
+
+		return;
+	}
+
+	QSqlDatabase database(QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), m_connectionName));
+	database.setDatabaseName(path);
+
+	if (!database.open())
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to open history database: %1").arg(database.lastError().text()), Console::OtherCategory, Console::ErrorLevel, path);
+
+		return;
+	}
+
+	const QStringList statements({QLatin1String("PRAGMA journal_mode = WAL"), QLatin1String("PRAGMA synchronous = NORMAL"), QLatin1String("CREATE TABLE IF NOT EXISTS visits (id INTEGER PRIMARY KEY, url TEXT NOT NULL, normalized_url TEXT NOT NULL, host TEXT NOT NULL, title TEXT, time INTEGER NOT NULL, typed INTEGER NOT NULL DEFAULT 0)"), QLatin1String("CREATE INDEX IF NOT EXISTS visits_time ON visits (time, id)"), QLatin1String("CREATE INDEX IF NOT EXISTS visits_url ON visits (normalized_url)"), QLatin1String("CREATE INDEX IF NOT EXISTS visits_host ON visits (host)")});
+
+	for (int i = 0; i < statements.count(); ++i)
+	{
+		QSqlQuery query(database);
+		query.prepare(statements.at(i));
+
+		if (!execute(query))
+		{
+			return;
+		}
+	}
+
+	m_isValid = true;
+}
+
+HistoryDatabase::~HistoryDatabase()
+{
+	{
+		QSqlDatabase database(QSqlDatabase::database(m_connectionName, false));
+
+		if (database.isOpen())
+		{
+			database.close();
+		}
+	}
+
+	QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+void HistoryDatabase::beginTransaction()
+{
+	QSqlDatabase::database(m_connectionName, false).transaction();
+}
+
+void HistoryDatabase::commitTransaction()
+{
+	QSqlDatabase::database(m_connectionName, false).commit();
+}
+
+void HistoryDatabase::enumerateVisits(const std::function<void(const Visit &visit)> &function) const
+{
+	QSqlQuery query(QSqlDatabase::database(m_connectionName, false));
+	query.setForwardOnly(true);
+	query.prepare(QLatin1String("SELECT id, url, title, time, typed FROM visits ORDER BY time ASC, id ASC"));
+
+	if (!execute(query))
+	{
+		return;
+	}
+
+	while (query.next())
+	{
+		function(readVisit(query));
+	}
+}
+
+QUrl HistoryDatabase::removeVisit(quint64 identifier)
+{
+	QSqlQuery selectQuery(QSqlDatabase::database(m_connectionName, false));
+	selectQuery.prepare(QLatin1String("SELECT normalized_url FROM visits WHERE id = ?"));
+	selectQuery.addBindValue(identifier);
+
+	if (!execute(selectQuery) || !selectQuery.next())
+	{
+		return {};
+	}
+
+	const QUrl url(selectQuery.value(0).toString());
+	QSqlQuery deleteQuery(QSqlDatabase::database(m_connectionName, false));
+	deleteQuery.prepare(QLatin1String("DELETE FROM visits WHERE id = ?"));
+	deleteQuery.addBindValue(identifier);
+
+	return (execute(deleteQuery) ? url : QUrl());
+}
+
+HistoryDatabase::Visit HistoryDatabase::readVisit(const QSqlQuery &query)
+{
+	Visit visit;
+	visit.identifier = query.value(0).toULongLong();
+	visit.url = QUrl(query.value(1).toString());
+	visit.title = query.value(2).toString();
+	visit.timeVisited = QDateTime::fromMSecsSinceEpoch(query.value(3).toLongLong(), Qt::UTC);
+	visit.isTypedIn = query.value(4).toBool();
+
+	return visit;
+}
+
+QVector<HistoryDatabase::Visit> HistoryDatabase::getVisits(int limit, const QDateTime &timeVisited, quint64 identifier) const
+{
+	QVector<Visit> visits;
+	QSqlQuery query(QSqlDatabase::database(m_connectionName, false));
+	query.setForwardOnly(true);
+
+	if (timeVisited.isValid())
+	{
+		query.prepare(QLatin1String("SELECT id, url, title, time, typed FROM visits WHERE time < ? OR (time = ? AND id < ?) ORDER BY time DESC, id DESC LIMIT ?"));
+		query.addBindValue(timeVisited.toMSecsSinceEpoch());
+		query.addBindValue(timeVisited.toMSecsSinceEpoch());
+		query.addBindValue(identifier);
+	}
+	else
+	{
+		query.prepare(QLatin1String("SELECT id, url, title, time, typed FROM visits ORDER BY time DESC, id DESC LIMIT ?"));
+	}
+
+	query.addBindValue(limit);
+
+	if (!execute(query))
+	{
+		return visits;
+	}
+
+	visits.reserve(limit);
+
+	while (query.next())
+	{
+		visits.append(readVisit(query));
+	}
+
+	return visits;
+}
+
+QVector<HistoryDatabase::Visit> HistoryDatabase::getVisits(const QUrl &url) const
+{
+	QVector<Visit> visits;
+	QSqlQuery query(QSqlDatabase::database(m_connectionName, false));
+	query.setForwardOnly(true);
+	query.prepare(QLatin1String("SELECT id, url, title, time, typed FROM visits WHERE normalized_url = ? ORDER BY time ASC, id ASC"));
+	query.addBindValue(url.toString());
+
+	if (!execute(query))
+	{
+		return visits;
+	}
+
+	while (query.next())
+	{
+		visits.append(readVisit(query));
+	}
+
+	return visits;
+}
+
+QVector<QUrl> HistoryDatabase::removeVisits(const QDateTime &from, const QDateTime &to)
+{
+	QString condition(QLatin1String("1"));
+
+	if (from.isValid())
+	{
+		condition.append(QLatin1String(" AND time >= :from"));
+	}
+
+	if (to.isValid())
+	{
+		condition.append(QLatin1String(" AND time < :to"));
+	}
+
+	QVector<QUrl> urls;
+	QSqlQuery selectQuery(QSqlDatabase::database(m_connectionName, false));
+	selectQuery.setForwardOnly(true);
+	selectQuery.prepare(QLatin1String("SELECT DISTINCT normalized_url FROM visits WHERE ") + condition);
+
+	QSqlQuery deleteQuery(QSqlDatabase::database(m_connectionName, false));
+	deleteQuery.prepare(QLatin1String("DELETE FROM visits WHERE ") + condition);
+
+	if (from.isValid())
+	{
+		selectQuery.bindValue(QLatin1String(":from"), from.toMSecsSinceEpoch());
+		deleteQuery.bindValue(QLatin1String(":from"), from.toMSecsSinceEpoch());
+	}
+
+	if (to.isValid())
+	{
+		selectQuery.bindValue(QLatin1String(":to"), to.toMSecsSinceEpoch());
+		deleteQuery.bindValue(QLatin1String(":to"), to.toMSecsSinceEpoch());
+	}
+
+	if (!execute(selectQuery))
+	{
+		return urls;
+	}
+
+	while (selectQuery.next())
+	{
+		urls.append(QUrl(selectQuery.value(0).toString()));
+	}
+
+	if (!execute(deleteQuery))
+	{
+		urls.clear();
+	}
+
+	return urls;
+}
+
+QVector<QUrl> HistoryDatabase::removeExcessVisits(int limit)
+{
+	QVector<QUrl> urls;
+	QSqlQuery selectQuery(QSqlDatabase::database(m_connectionName, false));
+	selectQuery.setForwardOnly(true);
+	selectQuery.prepare(QLatin1String("SELECT DISTINCT normalized_url FROM visits WHERE id NOT IN (SELECT id FROM visits ORDER BY time DESC, id DESC LIMIT ?)"));
+	selectQuery.addBindValue(limit);
+
+	if (!execute(selectQuery))
+	{
+		return urls;
+	}
+
+	while (selectQuery.next())
+	{
+		urls.append(QUrl(selectQuery.value(0).toString()));
+	}
+
+	if (urls.isEmpty())
+	{
+		return urls;
+	}
+
+	QSqlQuery deleteQuery(QSqlDatabase::database(m_connectionName, false));
+	deleteQuery.prepare(QLatin1String("DELETE FROM visits WHERE id NOT IN (SELECT id FROM visits ORDER BY time DESC, id DESC LIMIT ?)"));
+	deleteQuery.addBindValue(limit);
+
+	if (!execute(deleteQuery))
+	{
+		urls.clear();
+	}
+
+	return urls;
+}
+
+quint64 HistoryDatabase::addVisit(const Visit &visit)
+{
+	QSqlQuery query(QSqlDatabase::database(m_connectionName, false));
+	query.prepare(QLatin1String("INSERT INTO visits (id, url, normalized_url, host, title, time, typed) VALUES (?, ?, ?, ?, ?, ?, ?)"));
+	query.addBindValue((visit.identifier > 0) ? QVariant(visit.identifier) : QVariant());
+	query.addBindValue(visit.url.toString());
+	query.addBindValue(Utils::normalizeUrl(visit.url).toString());
+	query.addBindValue(visit.url.host().toLower());
+	query.addBindValue(visit.title);
+	query.addBindValue(visit.timeVisited.toMSecsSinceEpoch());
+	query.addBindValue(visit.isTypedIn);
+
+	return (execute(query) ? query.lastInsertId().toULongLong() : 0);
+}
+
+bool HistoryDatabase::updateVisit(const Visit &visit)
+{
+	QSqlQuery query(QSqlDatabase::database(m_connectionName, false));
+	query.prepare(QLatin1String("UPDATE visits SET url = ?, normalized_url = ?, host = ?, title = ? WHERE id = ?"));
+	query.addBindValue(visit.url.toString());
+	query.addBindValue(Utils::normalizeUrl(visit.url).toString());
+	query.addBindValue(visit.url.host().toLower());
+	query.addBindValue(visit.title);
+	query.addBindValue(visit.identifier);
+
+	return execute(query);
+}
+
+bool HistoryDatabase::clear()
+{
+	QSqlQuery query(QSqlDatabase::database(m_connectionName, false));
+	query.prepare(QLatin1String("DELETE FROM visits"));
+
+	return execute(query);
+}
+
+bool HistoryDatabase::execute(QSqlQuery &query) const
+{
+	if (query.exec())
+	{
+		return true;
+	}
+
+	Console::addMessage(QCoreApplication::translate("main", "Failed to execute history database query: %1").arg(query.lastError().text()), Console::OtherCategory, Console::ErrorLevel, QSqlDatabase::database(m_connectionName, false).databaseName());
+
+	return false;
+}
+
+bool HistoryDatabase::isEmpty() const
+{
+	QSqlQuery query(QSqlDatabase::database(m_connectionName, false));
+	query.prepare(QLatin1String("SELECT 1 FROM visits LIMIT 1"));
+
+	return (!execute(query) || !query.next());
+}
+
+bool HistoryDatabase::isValid() const
+{
+	return m_isValid;
+}
+
+}
@@ -0,0 +1,76 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HISTORYDATABASE_H
+#define OTTER_HISTORYDATABASE_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+#include <functional>
+
+class QSqlQuery;
+
+namespace Otter
+{
+
+class HistoryDatabase final
+{
+public:
+	struct Visit final
+	{
+		QUrl url;
+		QString title;
+		QDateTime timeVisited;
+		quint64 identifier = 0;
+		bool isTypedIn = false;
+	};
+
+	explicit HistoryDatabase(const QString &path);
+	~HistoryDatabase();
+
+	void beginTransaction();
+	void commitTransaction();
+	void enumerateVisits(const std::function<void(const Visit &visit)> &function) const;
+	QUrl removeVisit(quint64 identifier);
+	QVector<Visit> getVisits(int limit, const QDateTime &timeVisited = {}, quint64 identifier = 0) const;
+	QVector<Visit> getVisits(const QUrl &url) const;
+	QVector<QUrl> removeVisits(const QDateTime &from, const QDateTime &to);
+	QVector<QUrl> removeExcessVisits(int limit);
+	quint64 addVisit(const Visit &visit);
+	bool updateVisit(const Visit &visit);
+	bool clear();
+	bool isEmpty() const;
+	bool isValid() const;
+
+protected:
+	static Visit readVisit(const QSqlQuery &query);
+	bool execute(QSqlQuery &query) const;
+
+private:
+	QString m_connectionName;
+	bool m_isValid;
+
+	Q_DISABLE_COPY(HistoryDatabase)
+};
+
+}
+
+#endif
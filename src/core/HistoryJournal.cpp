@@ -0,0 +1,337 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HistoryJournal.h"
+#include "Console.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QSaveFile>
+
+namespace Otter
+{
+
+HistoryJournal::HistoryJournal(const QString &path) :
+	m_path(path),
+	m_validSize(-1),
+	m_recordsAmount(0),
+	m_needsBackup(false)
+{
+	m_file.setFileName(path);
+}
+
+QString HistoryJournal::getPath() const
+{
+	return m_path;
+}
+
+QByteArray HistoryJournal::createHeader()
+{
+	QByteArray header;
+	QDataStream stream(&header, QIODevice::WriteOnly);
+	stream << static_cast<quint32>(JournalMagic) << static_cast<quint32>(JournalVersion);
+
+	return header;
+}
+
+QByteArray HistoryJournal::createRecord(const Record &record)
+{
+	QByteArray payload;
+	QDataStream payloadStream(&payload, QIODevice::WriteOnly);
+	payloadStream << static_cast<quint8>(record.type) << record.identifier;
+
+	switch (record.type)
+	{
+		case AddRecord:
+			payloadStream << record.url << record.title << record.timeVisited.toMSecsSinceEpoch() << record.isTypedIn;
+
+			break;
+		case UpdateRecord:
+			payloadStream << record.url << record.title;
+
+			break;
+		default:
+			break;
+	}
+
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream << static_cast<quint32>(payload.size()) << qChecksum(payload.constData(), static_cast<uint>(payload.size()));
+
+	data.append(payload);
+
+	return data;
+}
+
+QVector<HistoryJournal::Record> HistoryJournal::read()
+{
+	QVector<Record> records;
+
+	m_file.close();
+
+	m_validSize = -1;
+	m_recordsAmount = 0;
+	m_needsBackup = false;
+
+	QFile file(m_path);
+
+	if (!file.exists())
+	{
+		return records;
+	}
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to open history journal: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return records;
+	}
+
+	const qint64 size(file.size());
+
+	if (size < JournalHeaderSize)
+	{
+		m_validSize = 0;
+
+		return records;
+	}
+
+	uchar *mappedData(file.map(0, size));
+	QByteArray buffer;
+
+	if (mappedData)
+	{
+		buffer = QByteArray::fromRawData(reinterpret_cast<const char*>(mappedData), static_cast<int>(size));
+	}
+	else
+	{
+		buffer = file.readAll();
+	}
+
+	QDataStream headerStream(buffer);
+	quint32 magic(0);
+	quint32 version(0);
+
+	headerStream >> magic >> version;
+
+	if (magic != JournalMagic || version != JournalVersion)
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to load history journal: unsupported format"), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		if (mappedData)
+		{
+			file.unmap(mappedData);
+		}
+
+		m_validSize = 0;
+		m_needsBackup = true;
+
+		return records;
+	}
+
+	int offset(JournalHeaderSize);
+
+	while ((offset + RecordHeaderSize) <= buffer.size())
+	{
+		QDataStream recordStream(QByteArray::fromRawData((buffer.constData() + offset), RecordHeaderSize));
+		quint32 length(0);
+		quint16 checksum(0);
+
+		recordStream >> length >> checksum;
+
+		if (length > static_cast<quint32>(buffer.size() - offset - RecordHeaderSize))
+		{
+			break;
+		}
+
+		const char *payload(buffer.constData() + offset + RecordHeaderSize);
+		Record record;
+
+		if (qChecksum(payload, length) != checksum || !parseRecord(payload, static_cast<int>(length), record))
+		{
+			break;
+		}
+
+		records.append(record);
+
+		offset += (RecordHeaderSize + static_cast<int>(length));
+	}
+
+	const int bufferSize(buffer.size());
+
+	buffer.clear();
+
+	if (mappedData)
+	{
+		file.unmap(mappedData);
+	}
+
+	if (offset < bufferSize)
+	{
+		Console::addMessage(QCoreApplication::translate("main", "History journal is damaged, discarding %n byte(s) of incomplete records", "", (bufferSize - offset)), Console::OtherCategory, Console::WarningLevel, m_path);
+
+		m_validSize = offset;
+	}
+
+	m_recordsAmount = records.count();
+
+	return records;
+}
+
+int HistoryJournal::getRecordsAmount() const
+{
+	return m_recordsAmount;
+}
+
+bool HistoryJournal::parseRecord(const char *data, int size, Record &record)
+{
+	QDataStream stream(QByteArray::fromRawData(data, size));
+	quint8 type(UnknownRecord);
+
+	stream >> type >> record.identifier;
+
+	record.type = static_cast<RecordType>(type);
+
+	switch (record.type)
+	{
+		case AddRecord:
+			{
+				qint64 timeVisited(0);
+
+				stream >> record.url >> record.title >> timeVisited >> record.isTypedIn;
+
+				record.timeVisited = QDateTime::fromMSecsSinceEpoch(timeVisited, Qt::UTC);
+			}
+
+			break;
+		case UpdateRecord:
+			stream >> record.url >> record.title;
+
+			break;
+		case RemoveRecord:
+			break;
+		default:
+			return false;
+	}
+
+	return (stream.status() == QDataStream::Ok);
+}
+
+bool HistoryJournal::append(const Record &record)
+{
+	if (!m_file.isOpen())
+	{
+		if (m_needsBackup)
+		{
+			const QString backupPath(m_path + QLatin1String(".bak"));
+
+			QFile::remove(backupPath);
+
+			if (QFile::rename(m_path, backupPath))
+			{
+				Console::addMessage(QCoreApplication::translate("main", "Moved unsupported history journal to %1").arg(backupPath), Console::OtherCategory, Console::WarningLevel, m_path);
+
+				m_validSize = -1;
+			}
+
+			m_needsBackup = false;
+		}
+
+		if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append))
+		{
+			Console::addMessage(QCoreApplication::translate("main", "Failed to open history journal: %1").arg(m_file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+			return false;
+		}
+
+		if (m_validSize >= 0 && m_file.size() > m_validSize)
+		{
+			m_file.resize(m_validSize);
+		}
+
+		m_validSize = -1;
+
+		if (m_file.size() < JournalHeaderSize)
+		{
+			m_file.resize(0);
+			m_file.write(createHeader());
+		}
+	}
+
+	const QByteArray data(createRecord(record));
+
+	if (m_file.write(data) != data.size() || !m_file.flush())
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to write history journal: %1").arg(m_file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		m_file.close();
+
+		return false;
+	}
+
+	++m_recordsAmount;
+
+	return true;
+}
+
+bool HistoryJournal::write(const QVector<Record> &records)
+{
+	m_file.close();
+
+	QSaveFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to compact history journal: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return false;
+	}
+
+	file.write(createHeader());
+
+	for (int i = 0; i < records.count(); ++i)
+	{
+		file.write(createRecord(records.at(i)));
+	}
+
+	if (!file.commit())
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to compact history journal: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return false;
+	}
+
+	m_validSize = -1;
+	m_recordsAmount = records.count();
+	m_needsBackup = false;
+
+	return true;
+}
+
+bool HistoryJournal::clear()
+{
+	return write({});
+}
+
+bool HistoryJournal::exists() const
+{
+	return QFile::exists(m_path);
+}
+
+}
@@ -0,0 +1,86 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HISTORYJOURNAL_H
+#define OTTER_HISTORYJOURNAL_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class HistoryJournal final
+{
+public:
+	enum RecordType : quint8
+	{
+		UnknownRecord = 0,
+		AddRecord,
+		UpdateRecord,
+		RemoveRecord
+	};
+
+	struct Record final
+	{
+		QString url;
+		QString title;
+		QDateTime timeVisited;
+		quint64 identifier = 0;
+		RecordType type = UnknownRecord;
+		bool isTypedIn = false;
+	};
+
+	explicit HistoryJournal(const QString &path);
+
+	QString getPath() const;
+	QVector<Record> read();
+	int getRecordsAmount() const;
+	bool append(const Record &record);
+	bool write(const QVector<Record> &records);
+	bool clear();
+	bool exists() const;
+
+protected:
+	enum JournalFormat : quint32
+	{
+		JournalMagic = 0x4F484A4C,
+		JournalVersion = 1,
+		JournalHeaderSize = 8,
+		RecordHeaderSize = 6
+	};
+
+	static QByteArray createHeader();
+	static QByteArray createRecord(const Record &record);
+	static bool parseRecord(const char *data, int size, Record &record);
+
+private:
+	QFile m_file;
+	QString m_path;
+	qint64 m_validSize;
+	int m_recordsAmount;
+	bool m_needsBackup;
+
+	Q_DISABLE_COPY(HistoryJournal)
+};
+
+}
+
+#endif
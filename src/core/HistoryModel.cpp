@@ -25,9 +25,12 @@
 #include "ThemesManager.h"
 #include "Utils.h"
 
+#include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
+#include <QtCore/QSet>
 
 namespace Otter
 {
@@ -78,38 +81,112 @@ quint64 HistoryModel::Entry::getIdentifier() const
 	return data(IdentifierRole).toULongLong();
 }
 
+bool HistoryModel::Entry::isTypedIn() const
+{
+	return data(IsTypedInRole).toBool();
+}
+
 HistoryModel::HistoryModel(const QString &path, HistoryType type, QObject *parent) : QStandardItemModel(parent),
-	m_type(type)
+	m_journal(nullptr),
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	m_database(nullptr),
+#endif
+	m_path(path),
+	m_type(type),
+	m_isUpdating(true),
+	m_hasFetchedAll(true)
 {
-	QFile file(path);
+	setSortRole(TimeVisitedRole);
 
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	if (type == BrowsingHistory)
 	{
-		Console::addMessage(tr("Failed to open history file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+		if (loadDatabase())
+		{
+			m_isUpdating = false;
 
-		return;
-	}
+			return;
+		}
+#endif
 
-	const QJsonArray historyArray(QJsonDocument::fromJson(file.readAll()).array());
+		m_journal = new HistoryJournal(path);
 
-	file.close();
+		if (m_journal->exists())
+		{
+			loadJournal();
+		}
+		else
+		{
+			const QString legacyPath(getLegacyPath());
 
-	for (int i = 0; i < historyArray.count(); ++i)
+			if (QFile::exists(legacyPath) && loadEntries(legacyPath) && !SessionsManager::isReadOnly())
+			{
+				compactJournal();
+			}
+		}
+	}
+	else
 	{
-		const QJsonObject entryObject(historyArray.at(i).toObject());
-		QDateTime dateTime(QDateTime::fromString(entryObject.value(QLatin1String("time")).toString(), Qt::ISODate));
-		dateTime.setTimeSpec(Qt::UTC);
+		loadEntries(path);
+	}
+
+	m_isUpdating = false;
 
-		addEntry(QUrl(entryObject.value(QLatin1String("url")).toString()), entryObject.value(QLatin1String("title")).toString(), {}, dateTime);
+	m_statistics.reserve(m_urls.count());
+
+	QHash<QUrl, QVector<Entry*> >::const_iterator iterator;
+
+	for (iterator = m_urls.constBegin(); iterator != m_urls.constEnd(); ++iterator)
+	{
+		updateStatistics(iterator.key());
 	}
 
-	setSortRole(TimeVisitedRole);
 	sort(0, Qt::DescendingOrder);
 }
 
+HistoryModel::~HistoryModel()
+{
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	if (m_database)
+	{
+		QHash<QUrl, UrlStatistics>::const_iterator iterator;
+
+		for (iterator = m_statistics.constBegin(); iterator != m_statistics.constEnd(); ++iterator)
+		{
+			delete iterator.value().entry;
+		}
+
+		delete m_database;
+	}
+#endif
+
+	delete m_journal;
+}
+
 void HistoryModel::clearExcessEntries(int limit)
 {
-	if (limit > 0 && rowCount() > limit)
+	if (limit <= 0)
+	{
+		return;
+	}
+
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	if (m_database)
+	{
+		const QVector<QUrl> urls(m_database->removeExcessVisits(limit));
+
+		removeFetchedEntries([&](const Entry *entry)
+		{
+			return (entry->row() >= limit);
+		});
+
+		updateStatistics(urls);
+
+		return;
+	}
+#endif
+
+	if (rowCount() > limit)
 	{
 		for (int i = (rowCount() - 1); i >= limit; --i)
 		{
@@ -124,14 +201,63 @@ void HistoryModel::clearRecentEntries(uint period)
 	{
 		clear();
 
+		m_index.clear();
 		m_urls.clear();
 		m_identifiers.clear();
 
+		if (!SessionsManager::isReadOnly())
+		{
+			if (m_journal)
+			{
+				m_journal->clear();
+			}
+
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+			if (m_database)
+			{
+				m_database->clear();
+			}
+#endif
+		}
+
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+		if (m_database)
+		{
+			QHash<QUrl, UrlStatistics>::const_iterator iterator;
+
+			for (iterator = m_statistics.constBegin(); iterator != m_statistics.constEnd(); ++iterator)
+			{
+				delete iterator.value().entry;
+			}
+
+			m_hasFetchedAll = true;
+		}
+#endif
+
+		m_statistics.clear();
+
 		emit cleared();
 
 		return;
 	}
 
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	if (m_database)
+	{
+		const QDateTime dateTime(QDateTime::currentDateTimeUtc().addSecs(-(static_cast<qint64>(period) * 3600)));
+		const QVector<QUrl> urls(m_database->removeVisits(dateTime, {}));
+
+		removeFetchedEntries([&](const Entry *entry)
+		{
+			return (entry->getTimeVisited() >= dateTime);
+		});
+
+		updateStatistics(urls);
+
+		return;
+	}
+#endif
+
 	for (int i = (rowCount() - 1); i >= 0; --i)
 	{
 		if (index(i, 0).data(TimeVisitedRole).toDateTime().secsTo(QDateTime::currentDateTimeUtc()) < (period * 3600))
@@ -150,6 +276,23 @@ void HistoryModel::clearOldestEntries(int period)
 
 	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
 
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	if (m_database)
+	{
+		const QDateTime dateTime(currentDateTime.date().addDays(-period), QTime(0, 0), Qt::UTC);
+		const QVector<QUrl> urls(m_database->removeVisits({}, dateTime));
+
+		removeFetchedEntries([&](const Entry *entry)
+		{
+			return (entry->getTimeVisited().daysTo(currentDateTime) > period);
+		});
+
+		updateStatistics(urls);
+
+		return;
+	}
+#endif
+
 	for (int i = (rowCount() - 1); i >= 0; --i)
 	{
 		if (index(i, 0).data(TimeVisitedRole).toDateTime().daysTo(currentDateTime) > period)
@@ -159,15 +302,352 @@ void HistoryModel::clearOldestEntries(int period)
 	}
 }
 
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+void HistoryModel::removeFetchedEntries(const std::function<bool(const Entry *entry)> &function)
+{
+	const bool wasUpdating(m_isUpdating);
+
+	m_isUpdating = true;
+
+	for (int i = (rowCount() - 1); i >= 0; --i)
+	{
+		const Entry *entry(static_cast<Entry*>(item(i, 0)));
+
+		if (entry && function(entry))
+		{
+			removeEntry(entry->getIdentifier());
+		}
+	}
+
+	m_isUpdating = wasUpdating;
+}
+
+void HistoryModel::updateSummary(UrlStatistics &statistics, const HistoryDatabase::Visit &visit)
+{
+	if (!statistics.entry)
+	{
+		statistics.entry = new Entry();
+	}
+
+	statistics.entry->setItemData(visit.url, UrlRole);
+	statistics.entry->setItemData(visit.title, TitleRole);
+	statistics.entry->setItemData(visit.timeVisited, TimeVisitedRole);
+	statistics.entry->setItemData(visit.identifier, IdentifierRole);
+	statistics.entry->setItemData(visit.isTypedIn, IsTypedInRole);
+
+	statistics.timeVisited = visit.timeVisited;
+}
+
+void HistoryModel::importDatabaseEntries()
+{
+	QVector<HistoryJournal::Record> records;
+	HistoryJournal journal(m_path);
+
+	if (journal.exists())
+	{
+		records = journal.read();
+	}
+	else if (QFile::exists(getLegacyPath()))
+	{
+		readEntries(getLegacyPath(), records);
+	}
+
+	if (records.isEmpty())
+	{
+		return;
+	}
+
+	m_database->beginTransaction();
+
+	for (int i = 0; i < records.count(); ++i)
+	{
+		const HistoryJournal::Record &record(records.at(i));
+		HistoryDatabase::Visit visit;
+		visit.url = QUrl(record.url);
+		visit.title = record.title;
+		visit.timeVisited = record.timeVisited;
+		visit.identifier = record.identifier;
+		visit.isTypedIn = record.isTypedIn;
+
+		switch (record.type)
+		{
+			case HistoryJournal::AddRecord:
+				m_database->addVisit(visit);
+
+				break;
+			case HistoryJournal::UpdateRecord:
+				m_database->updateVisit(visit);
+
+				break;
+			case HistoryJournal::RemoveRecord:
+				m_database->removeVisit(visit.identifier);
+
+				break;
+			default:
+				break;
+		}
+	}
+
+	m_database->commitTransaction();
+}
+#endif
+
+void HistoryModel::loadJournal()
+{
+	const QVector<HistoryJournal::Record> records(m_journal->read());
+
+	for (int i = 0; i < records.count(); ++i)
+	{
+		const HistoryJournal::Record &record(records.at(i));
+
+		switch (record.type)
+		{
+			case HistoryJournal::AddRecord:
+				addEntry(QUrl(record.url), record.title, {}, record.timeVisited, record.identifier, record.isTypedIn);
+
+				break;
+			case HistoryJournal::UpdateRecord:
+				{
+					Entry *entry(getEntry(record.identifier));
+
+					if (entry)
+					{
+						setData(entry->index(), QUrl(record.url), UrlRole);
+						setData(entry->index(), record.title, TitleRole);
+					}
+				}
+
+				break;
+			case HistoryJournal::RemoveRecord:
+				removeEntry(record.identifier);
+
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+void HistoryModel::writeRecord(HistoryJournal::RecordType type, const Entry *entry)
+{
+	if (m_isUpdating || SessionsManager::isReadOnly())
+	{
+		return;
+	}
+
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	if (m_database)
+	{
+		if (type == HistoryJournal::RemoveRecord)
+		{
+			m_database->removeVisit(entry->getIdentifier());
+		}
+		else if (type == HistoryJournal::UpdateRecord)
+		{
+			HistoryDatabase::Visit visit;
+			visit.url = entry->getUrl();
+			visit.title = entry->data(TitleRole).toString();
+			visit.identifier = entry->getIdentifier();
+
+			m_database->updateVisit(visit);
+		}
+
+		return;
+	}
+#endif
+
+	if (!m_journal)
+	{
+		return;
+	}
+
+	HistoryJournal::Record record;
+	record.identifier = entry->getIdentifier();
+	record.type = type;
+
+	if (type != HistoryJournal::RemoveRecord)
+	{
+		record.url = entry->getUrl().toString();
+		record.title = entry->data(TitleRole).toString();
+		record.timeVisited = entry->getTimeVisited();
+		record.isTypedIn = entry->isTypedIn();
+	}
+
+	m_journal->append(record);
+}
+
+void HistoryModel::updateStatistics(const QUrl &url)
+{
+	if (m_isUpdating)
+	{
+		return;
+	}
+
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	if (m_database)
+	{
+		const QVector<HistoryDatabase::Visit> visits(m_database->getVisits(url));
+
+		if (visits.isEmpty())
+		{
+			m_index.removeEntry(url);
+
+			delete m_statistics.take(url).entry;
+
+			return;
+		}
+
+		UrlStatistics &statistics(m_statistics[url]);
+		statistics.visits = 0;
+
+		for (int i = 0; i < visits.count(); ++i)
+		{
+			addVisit(statistics, visits.at(i).timeVisited, visits.at(i).isTypedIn);
+		}
+
+		updateSummary(statistics, visits.last());
+		updateIndex(url, statistics);
+
+		return;
+	}
+#endif
+
+	const QVector<Entry*> entries(m_urls.value(url));
+
+	if (entries.isEmpty())
+	{
+		m_index.removeEntry(url);
+		m_statistics.remove(url);
+
+		return;
+	}
+
+	UrlStatistics statistics;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		Entry *entry(entries.at(i));
+		const QDateTime timeVisited(entry->getTimeVisited());
+
+		addVisit(statistics, timeVisited, entry->isTypedIn());
+
+		if (!statistics.entry || timeVisited > statistics.timeVisited)
+		{
+			statistics.entry = entry;
+			statistics.timeVisited = timeVisited;
+		}
+	}
+
+	m_statistics[url] = statistics;
+
+	updateIndex(url, statistics);
+}
+
+void HistoryModel::updateStatistics(const QVector<QUrl> &urls)
+{
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		updateStatistics(urls.at(i));
+	}
+
+	if (!urls.isEmpty())
+	{
+		emit modelModified();
+	}
+}
+
+void HistoryModel::addVisit(UrlStatistics &statistics, const QDateTime &timeVisited, bool isTypedIn)
+{
+	const qreal weight(isTypedIn ? 2 : 1);
+
+	statistics.score = ((statistics.visits > 0) ? UrlCompletionIndex::addVisitScore(statistics.score, timeVisited, weight) : UrlCompletionIndex::calculateScore(weight, timeVisited));
+
+	++statistics.visits;
+}
+
+void HistoryModel::updateIndex(const QUrl &url, const UrlStatistics &statistics)
+{
+	m_index.setEntry(url, statistics.entry, statistics.entry->data(TitleRole).toString(), statistics.score);
+}
+
+void HistoryModel::fetchMore(const QModelIndex &parent)
+{
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	if (!m_database || m_hasFetchedAll || parent.isValid())
+	{
+		return;
+	}
+
+	const Entry *lastEntry((rowCount() > 0) ? static_cast<Entry*>(item((rowCount() - 1), 0)) : nullptr);
+	const QVector<HistoryDatabase::Visit> visits(m_database->getVisits(500, (lastEntry ? lastEntry->getTimeVisited() : QDateTime()), (lastEntry ? lastEntry->getIdentifier() : 0)));
+	QVector<Entry*> entries;
+	entries.reserve(visits.count());
+
+	m_hasFetchedAll = (visits.count() < 500);
+
+	const bool wasUpdating(m_isUpdating);
+
+	m_isUpdating = true;
+
+	blockSignals(true);
+
+	for (int i = 0; i < visits.count(); ++i)
+	{
+		const HistoryDatabase::Visit &visit(visits.at(i));
+		Entry *entry(new Entry());
+
+		appendRow(entry);
+		setData(entry->index(), visit.url, UrlRole);
+		setData(entry->index(), visit.title, TitleRole);
+		setData(entry->index(), visit.timeVisited, TimeVisitedRole);
+		setData(entry->index(), visit.identifier, IdentifierRole);
+
+		if (visit.isTypedIn)
+		{
+			setData(entry->index(), true, IsTypedInRole);
+		}
+
+		m_identifiers[visit.identifier] = entry;
+
+		entries.append(entry);
+	}
+
+	blockSignals(false);
+
+	m_isUpdating = wasUpdating;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		emit entryAdded(entries.at(i));
+	}
+#else
+	Q_UNUSED(parent)
+#endif
+}
+
 void HistoryModel::removeEntry(quint64 identifier)
 {
 	Entry *entry(getEntry(identifier));
 
 	if (!entry)
 	{
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+		if (m_database && !m_isUpdating && !SessionsManager::isReadOnly())
+		{
+			const QUrl url(m_database->removeVisit(identifier));
+
+			if (!url.isEmpty())
+			{
+				updateStatistics(QVector<QUrl>({url}));
+			}
+		}
+#endif
+
 		return;
 	}
 
+	writeRecord(HistoryJournal::RemoveRecord, entry);
+
 	const QUrl url(Utils::normalizeUrl(entry->getUrl()));
 
 	if (m_urls.contains(url))
@@ -178,6 +658,8 @@ void HistoryModel::removeEntry(quint64 identifier)
 		{
 			m_urls.remove(url);
 		}
+
+		updateStatistics(url);
 	}
 
 	if (identifier > 0 && m_identifiers.contains(identifier))
@@ -192,14 +674,14 @@ void HistoryModel::removeEntry(quint64 identifier)
 	emit modelModified();
 }
 
-HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date, quint64 identifier)
+HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date, quint64 identifier, bool isTypedIn)
 {
 	blockSignals(true);
 
+	const QUrl normalizedUrl(Utils::normalizeUrl(url));
+
 	if (m_type == TypedHistory)
 	{
-		const QUrl normalizedUrl(Utils::normalizeUrl(url));
-
 		if (hasEntry(normalizedUrl))
 		{
 			for (int i = 0; i < m_urls[normalizedUrl].count(); ++i)
@@ -212,11 +694,33 @@ HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &titl
 	Entry *entry(new Entry());
 	entry->setIcon(icon);
 
+	const bool wasUpdating(m_isUpdating);
+
+	m_isUpdating = true;
+
 	insertRow(0, entry);
 	setData(entry->index(), url, UrlRole);
 	setData(entry->index(), title, TitleRole);
 	setData(entry->index(), date, TimeVisitedRole);
 
+	if (isTypedIn)
+	{
+		setData(entry->index(), true, IsTypedInRole);
+	}
+
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	HistoryDatabase::Visit visit;
+	visit.url = url;
+	visit.title = title;
+	visit.timeVisited = date;
+	visit.isTypedIn = isTypedIn;
+
+	if (m_database && !wasUpdating && !SessionsManager::isReadOnly())
+	{
+		identifier = m_database->addVisit(visit);
+	}
+#endif
+
 	if (identifier == 0 || m_identifiers.contains(identifier))
 	{
 		identifier = (m_identifiers.isEmpty() ? 1 : (m_identifiers.lastKey() + 1));
@@ -225,6 +729,35 @@ HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &titl
 	setData(entry->index(), identifier, IdentifierRole);
 
 	m_identifiers[identifier] = entry;
+	m_isUpdating = wasUpdating;
+
+	writeRecord(HistoryJournal::AddRecord, entry);
+
+	if (!m_isUpdating && !normalizedUrl.isEmpty())
+	{
+		UrlStatistics &statistics(m_statistics[normalizedUrl]);
+
+		addVisit(statistics, date, isTypedIn);
+
+		if (!statistics.entry || date >= statistics.timeVisited)
+		{
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+			if (m_database)
+			{
+				visit.identifier = identifier;
+
+				updateSummary(statistics, visit);
+			}
+			else
+#endif
+			{
+				statistics.entry = entry;
+				statistics.timeVisited = date;
+			}
+		}
+
+		updateIndex(normalizedUrl, statistics);
+	}
 
 	blockSignals(false);
 
@@ -243,52 +776,68 @@ HistoryModel::Entry* HistoryModel::getEntry(quint64 identifier) const
 	return nullptr;
 }
 
-QVector<HistoryModel::HistoryEntryMatch> HistoryModel::findEntries(const QString &prefix, bool markAsTypedIn) const
+QVector<HistoryModel::HistoryEntryMatch> HistoryModel::findEntries(const QString &prefix, bool markAsTypedIn, int limit) const
 {
-	QVector<Entry*> matchedEntries;
-	QVector<HistoryEntryMatch> allMatches;
-	QVector<HistoryEntryMatch> currentMatches;
-	QMultiMap<QDateTime, HistoryEntryMatch> matchesMap;
-	QHash<QUrl, QVector<Entry*> >::const_iterator urlsIterator;
+	QVector<HistoryEntryMatch> matches;
 
-	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+	if (prefix.isEmpty())
 	{
-		if (urlsIterator.value().isEmpty() || matchedEntries.contains(urlsIterator.value().value(0)))
-		{
-			continue;
-		}
-
-		const QString result(Utils::matchUrl(urlsIterator.key(), prefix));
+		QSet<QUrl> urls;
 
-		if (!result.isEmpty())
+		for (int i = 0; i < rowCount(); ++i)
 		{
-			HistoryEntryMatch match;
-			match.entry = urlsIterator.value().value(0);
-			match.match = result;
+			if (limit > 0 && matches.count() >= limit)
+			{
+				break;
+			}
+
+			Entry *entry(static_cast<Entry*>(item(i, 0)));
 
-			if (markAsTypedIn)
+			if (!entry)
 			{
-				match.isTypedIn = true;
+				continue;
 			}
 
-			matchesMap.insert(match.entry->data(TimeVisitedRole).toDateTime(), match);
+			const QUrl url(Utils::normalizeUrl(entry->getUrl()));
 
-			matchedEntries.append(match.entry);
+			if (!urls.contains(url))
+			{
+				HistoryEntryMatch match;
+				match.entry = entry;
+				match.match = url.toString();
+				match.isTypedIn = markAsTypedIn;
+
+				matches.append(match);
+
+				urls.insert(url);
+			}
 		}
-	}
 
-	currentMatches = matchesMap.values().toVector();
+		return matches;
+	}
 
-	matchesMap.clear();
+	const QVector<UrlCompletionIndex::Match> indexMatches(m_index.findEntries(prefix, limit));
 
-	allMatches.reserve(currentMatches.count());
+	matches.reserve(indexMatches.count());
 
-	for (int i = (currentMatches.count() - 1); i >= 0; --i)
+	for (int i = 0; i < indexMatches.count(); ++i)
 	{
-		allMatches.append(currentMatches.at(i));
+		HistoryEntryMatch match;
+		match.entry = static_cast<Entry*>(indexMatches.at(i).item);
+		match.match = indexMatches.at(i).match;
+		match.isTypedIn = markAsTypedIn;
+
+		matches.append(match);
 	}
 
-	return allMatches;
+	return matches;
+}
+
+QString HistoryModel::getLegacyPath() const
+{
+	const QFileInfo information(m_path);
+
+	return information.absoluteDir().filePath(information.completeBaseName() + QLatin1String(".json"));
 }
 
 HistoryModel::HistoryType HistoryModel::getType() const
@@ -296,29 +845,187 @@ HistoryModel::HistoryType HistoryModel::getType() const
 	return m_type;
 }
 
-bool HistoryModel::save(const QString &path) const
+bool HistoryModel::readEntries(const QString &path, QVector<HistoryJournal::Record> &records)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		Console::addMessage(tr("Failed to open history file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
+
+		return false;
+	}
+
+	const QJsonArray historyArray(QJsonDocument::fromJson(file.readAll()).array());
+
+	file.close();
+
+	records.reserve(historyArray.count());
+
+	for (int i = 0; i < historyArray.count(); ++i)
+	{
+		const QJsonObject entryObject(historyArray.at(i).toObject());
+		HistoryJournal::Record record;
+		record.url = entryObject.value(QLatin1String("url")).toString();
+		record.title = entryObject.value(QLatin1String("title")).toString();
+		record.timeVisited = QDateTime::fromString(entryObject.value(QLatin1String("time")).toString(), Qt::ISODate);
+		record.timeVisited.setTimeSpec(Qt::UTC);
+		record.type = HistoryJournal::AddRecord;
+		record.isTypedIn = entryObject.value(QLatin1String("typed")).toBool();
+
+		records.append(record);
+	}
+
+	return true;
+}
+
+bool HistoryModel::loadEntries(const QString &path)
+{
+	QVector<HistoryJournal::Record> records;
+
+	if (!readEntries(path, records))
+	{
+		return false;
+	}
+
+	for (int i = 0; i < records.count(); ++i)
+	{
+		const HistoryJournal::Record &record(records.at(i));
+
+		addEntry(QUrl(record.url), record.title, {}, record.timeVisited, 0, record.isTypedIn);
+	}
+
+	return true;
+}
+
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+bool HistoryModel::loadDatabase()
+{
+	const QFileInfo information(m_path);
+
+	m_database = new HistoryDatabase(information.absoluteDir().filePath(information.completeBaseName() + QLatin1String(".sqlite")));
+
+	if (!m_database->isValid())
+	{
+		delete m_database;
+
+		m_database = nullptr;
+
+		return false;
+	}
+
+	if (m_database->isEmpty() && !SessionsManager::isReadOnly())
+	{
+		importDatabaseEntries();
+	}
+
+	m_database->enumerateVisits([&](const HistoryDatabase::Visit &visit)
+	{
+		UrlStatistics &statistics(m_statistics[Utils::normalizeUrl(visit.url)]);
+
+		addVisit(statistics, visit.timeVisited, visit.isTypedIn);
+		updateSummary(statistics, visit);
+	});
+
+	QHash<QUrl, UrlStatistics>::const_iterator iterator;
+
+	for (iterator = m_statistics.constBegin(); iterator != m_statistics.constEnd(); ++iterator)
+	{
+		updateIndex(iterator.key(), iterator.value());
+	}
+
+	m_hasFetchedAll = false;
+
+	fetchMore({});
+
+	return true;
+}
+#endif
+
+bool HistoryModel::compactJournal()
+{
+	QVector<HistoryJournal::Record> records;
+	records.reserve(rowCount());
+
+	for (int i = (rowCount() - 1); i >= 0; --i)
+	{
+		const Entry *entry(static_cast<Entry*>(item(i, 0)));
+
+		if (entry)
+		{
+			HistoryJournal::Record record;
+			record.url = entry->getUrl().toString();
+			record.title = entry->data(TitleRole).toString();
+			record.timeVisited = entry->getTimeVisited();
+			record.identifier = entry->getIdentifier();
+			record.type = HistoryJournal::AddRecord;
+			record.isTypedIn = entry->isTypedIn();
+
+			records.append(record);
+		}
+	}
+
+	return m_journal->write(records);
+}
+
+bool HistoryModel::canFetchMore(const QModelIndex &parent) const
+{
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	return (m_database && !m_hasFetchedAll && !parent.isValid());
+#else
+	Q_UNUSED(parent)
+
+	return false;
+#endif
+}
+
+bool HistoryModel::save()
 {
 	if (SessionsManager::isReadOnly())
 	{
 		return false;
 	}
 
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	if (m_database)
+	{
+		return true;
+	}
+#endif
+
+	if (m_journal)
+	{
+		if (m_journal->getRecordsAmount() > ((rowCount() * 2) + 1000))
+		{
+			return compactJournal();
+		}
+
+		return true;
+	}
+
 	QJsonArray historyArray;
 
-	for (int i = 0; i < rowCount(); ++i)
+	for (int i = (rowCount() - 1); i >= 0; --i)
 	{
 		const QModelIndex index(this->index(i, 0));
 
 		if (index.isValid())
 		{
-			historyArray.prepend(QJsonObject({{QLatin1String("url"), index.data(UrlRole).toUrl().toString()}, {QLatin1String("title"), index.data(TitleRole).toString()}, {QLatin1String("time"), index.data(TimeVisitedRole).toDateTime().toString(Qt::ISODate)}}));
+			QJsonObject entryObject({{QLatin1String("url"), index.data(UrlRole).toUrl().toString()}, {QLatin1String("title"), index.data(TitleRole).toString()}, {QLatin1String("time"), index.data(TimeVisitedRole).toDateTime().toString(Qt::ISODate)}});
+
+			if (index.data(IsTypedInRole).toBool())
+			{
+				entryObject.insert(QLatin1String("typed"), true);
+			}
+
+			historyArray.append(entryObject);
 		}
 	}
 
 	JsonSettings settings;
 	settings.setArray(historyArray);
 
-	return settings.save(path);
+	return settings.save(m_path);
 }
 
 bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int role)
@@ -330,6 +1037,8 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 		return QStandardItemModel::setData(index, value, role);
 	}
 
+	QUrl previousUrl;
+
 	if (role == UrlRole && value.toUrl() != index.data(UrlRole).toUrl())
 	{
 		const QUrl oldUrl(Utils::normalizeUrl(index.data(UrlRole).toUrl()));
@@ -354,6 +1063,8 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 
 			m_urls[newUrl].append(entry);
 		}
+
+		previousUrl = oldUrl;
 	}
 
 	entry->setItemData(value, role);
@@ -362,8 +1073,26 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 	{
 		case TitleRole:
 		case UrlRole:
-		case IdentifierRole:
+			writeRecord(HistoryJournal::UpdateRecord, entry);
+
+			if (!previousUrl.isEmpty())
+			{
+				updateStatistics(previousUrl);
+			}
+
+			updateStatistics(Utils::normalizeUrl(entry->getUrl()));
+			emit entryModified(entry);
+			emit modelModified();
+
+			break;
 		case TimeVisitedRole:
+		case IsTypedInRole:
+			updateStatistics(Utils::normalizeUrl(entry->getUrl()));
+			emit entryModified(entry);
+			emit modelModified();
+
+			break;
+		case IdentifierRole:
 			emit entryModified(entry);
 			emit modelModified();
 
@@ -377,7 +1106,7 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 
 bool HistoryModel::hasEntry(const QUrl &url) const
 {
-	return m_urls.contains(url);
+	return (m_urls.contains(url) || m_statistics.contains(url));
 }
 
 }
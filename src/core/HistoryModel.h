@@ -21,6 +21,12 @@
 #ifndef OTTER_HISTORYMODEL_H
 #define OTTER_HISTORYMODEL_H
 
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+#include "HistoryDatabase.h"
+#endif
+#include "HistoryJournal.h"
+#include "UrlCompletionIndex.h"
+
 #include <QtCore/QDateTime>
 #include <QtCore/QUrl>
 #include <QtGui/QStandardItemModel>
@@ -38,7 +44,8 @@ public:
 		TitleRole = Qt::DisplayRole,
 		UrlRole = Qt::StatusTipRole,
 		IdentifierRole = Qt::UserRole,
-		TimeVisitedRole
+		TimeVisitedRole,
+		IsTypedInRole
 	};
 
 	enum HistoryType
@@ -57,6 +64,7 @@ public:
 		QDateTime getTimeVisited() const;
 		QIcon getIcon() const;
 		quint64 getIdentifier() const;
+		bool isTypedIn() const;
 
 	protected:
 		explicit Entry();
@@ -71,24 +79,64 @@ public:
 		bool isTypedIn = false;
 	};
 
+	struct UrlStatistics final
+	{
+		QDateTime timeVisited;
+		Entry *entry = nullptr;
+		qreal score = 0;
+		int visits = 0;
+	};
+
 	explicit HistoryModel(const QString &path, HistoryType type, QObject *parent = nullptr);
+	~HistoryModel();
 
 	void clearExcessEntries(int limit);
 	void clearRecentEntries(uint period);
 	void clearOldestEntries(int period);
+	void fetchMore(const QModelIndex &parent) override;
 	void removeEntry(quint64 identifier);
-	Entry* addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date = QDateTime::currentDateTimeUtc(), quint64 identifier = 0);
+	Entry* addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date = QDateTime::currentDateTimeUtc(), quint64 identifier = 0, bool isTypedIn = false);
 	Entry* getEntry(quint64 identifier) const;
-	QVector<HistoryEntryMatch> findEntries(const QString &prefix, bool markAsTypedIn = false) const;
+	QVector<HistoryEntryMatch> findEntries(const QString &prefix, bool markAsTypedIn = false, int limit = 0) const;
 	HistoryType getType() const;
+	bool canFetchMore(const QModelIndex &parent) const override;
 	bool hasEntry(const QUrl &url) const;
-	bool save(const QString &path) const;
+	bool save();
 	bool setData(const QModelIndex &index, const QVariant &value, int role) override;
 
+protected:
+	void loadJournal();
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	void importDatabaseEntries();
+	void removeFetchedEntries(const std::function<bool(const Entry *entry)> &function);
+	void updateSummary(UrlStatistics &statistics, const HistoryDatabase::Visit &visit);
+#endif
+	void writeRecord(HistoryJournal::RecordType type, const Entry *entry);
+	void updateStatistics(const QUrl &url);
+	void updateStatistics(const QVector<QUrl> &urls);
+	void updateIndex(const QUrl &url, const UrlStatistics &statistics);
+	static void addVisit(UrlStatistics &statistics, const QDateTime &timeVisited, bool isTypedIn);
+	QString getLegacyPath() const;
+	bool readEntries(const QString &path, QVector<HistoryJournal::Record> &records);
+	bool loadEntries(const QString &path);
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	bool loadDatabase();
+#endif
+	bool compactJournal();
+
 private:
+	HistoryJournal *m_journal;
+#ifdef OTTER_ENABLE_SQLITEHISTORY
+	HistoryDatabase *m_database;
+#endif
+	UrlCompletionIndex m_index;
+	QString m_path;
 	QHash<QUrl, QVector<Entry*> > m_urls;
+	QHash<QUrl, UrlStatistics> m_statistics;
 	QMap<quint64, Entry*> m_identifiers;
 	HistoryType m_type;
+	bool m_isUpdating;
+	bool m_hasFetchedAll;
 
 signals:
 	void cleared();
@@ -0,0 +1,275 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HostLookupManager.h"
+#include "SettingsManager.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+namespace Otter
+{
+
+HostLookupManager* HostLookupManager::m_instance(nullptr);
+QHash<QString, HostLookupManager::HostEntry> HostLookupManager::m_entries;
+QReadWriteLock HostLookupManager::m_entriesLock;
+
+HostLookupManager::HostLookupManager(QObject *parent) : QObject(parent),
+	m_requestIdentifier(0)
+{
+}
+
+void HostLookupManager::createInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new HostLookupManager(QCoreApplication::instance());
+	}
+}
+
+void HostLookupManager::lookupHost(const QString &host, QObject *context, const std::function<void(LookupResult result)> &function, int timeout)
+{
+	const QString normalizedHost(normalizeHost(host));
+	const LookupResult result(getCachedResult(normalizedHost));
+
+	if (result != UnknownResult || !m_instance || normalizedHost.isEmpty())
+	{
+		function(result);
+
+		return;
+	}
+
+	++m_instance->m_requestIdentifier;
+
+	LookupRequest request;
+	request.context = context;
+	request.function = function;
+	request.identifier = m_instance->m_requestIdentifier;
+	request.hasContext = (context != nullptr);
+
+	m_instance->m_requests[normalizedHost].append(request);
+	m_instance->startLookup(normalizedHost);
+
+	if (timeout > 0)
+	{
+		const quint64 identifier(request.identifier);
+
+		QTimer::singleShot(timeout, m_instance, [=]()
+		{
+			m_instance->handleLookupTimeout(normalizedHost, identifier);
+		});
+	}
+}
+
+void HostLookupManager::prefetchHost(const QUrl &url)
+{
+	if (!m_instance || !url.isValid() || (url.scheme() != QLatin1String("http") && url.scheme() != QLatin1String("https") && url.scheme() != QLatin1String("ftp")))
+	{
+		return;
+	}
+
+	const QString host(normalizeHost(url.host()));
+
+	if (host.isEmpty() || !QHostAddress(host).isNull() || !SettingsManager::getOption(SettingsManager::Network_EnableDnsPrefetchOption, host).toBool() || getCachedResult(host) != UnknownResult)
+	{
+		return;
+	}
+
+	m_instance->startLookup(host);
+}
+
+void HostLookupManager::startLookup(const QString &host)
+{
+	if (m_lookups.key(host, -1) >= 0)
+	{
+		return;
+	}
+
+	m_lookups[QHostInfo::lookupHost(host, this, SLOT(handleLookupFinished(QHostInfo)))] = host;
+}
+
+void HostLookupManager::storeResult(const QString &host, const QHostInfo &information)
+{
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+	HostEntry entry;
+	entry.addresses = information.addresses();
+	entry.isResolvable = (information.error() == QHostInfo::NoError && !entry.addresses.isEmpty());
+	entry.expirationTime = (currentTime + (entry.isResolvable ? PositiveTimeToLive : NegativeTimeToLive));
+
+	QWriteLocker locker(&m_entriesLock);
+
+	if (m_entries.count() >= MaximumEntriesAmount)
+	{
+		QHash<QString, HostEntry>::iterator iterator(m_entries.begin());
+
+		while (iterator != m_entries.end())
+		{
+			if (iterator.value().expirationTime <= currentTime)
+			{
+				iterator = m_entries.erase(iterator);
+			}
+			else
+			{
+				++iterator;
+			}
+		}
+
+		if (m_entries.count() >= MaximumEntriesAmount)
+		{
+			m_entries.clear();
+		}
+	}
+
+	m_entries[host] = entry;
+}
+
+void HostLookupManager::handleLookupFinished(const QHostInfo &information)
+{
+	const QString host(m_lookups.take(information.lookupId()));
+
+	if (host.isEmpty())
+	{
+		return;
+	}
+
+	storeResult(host, information);
+
+	const bool isResolvable(getCachedResult(host) == ResolvedResult);
+	const QVector<LookupRequest> requests(m_requests.take(host));
+
+	for (int i = 0; i < requests.count(); ++i)
+	{
+		if (requests.at(i).context || !requests.at(i).hasContext)
+		{
+			requests.at(i).function(isResolvable ? ResolvedResult : FailedResult);
+		}
+	}
+
+	emit hostResolved(host, isResolvable);
+}
+
+void HostLookupManager::handleLookupTimeout(const QString &host, quint64 identifier)
+{
+	if (!m_requests.contains(host))
+	{
+		return;
+	}
+
+	QVector<LookupRequest> &requests(m_requests[host]);
+
+	for (int i = 0; i < requests.count(); ++i)
+	{
+		if (requests.at(i).identifier == identifier)
+		{
+			const LookupRequest request(requests.takeAt(i));
+
+			if (requests.isEmpty())
+			{
+				m_requests.remove(host);
+			}
+
+			if (request.context || !request.hasContext)
+			{
+				request.function(UnknownResult);
+			}
+
+			return;
+		}
+	}
+}
+
+HostLookupManager* HostLookupManager::getInstance()
+{
+	return m_instance;
+}
+
+QString HostLookupManager::normalizeHost(const QString &host)
+{
+	return host.trimmed().toLower();
+}
+
+HostLookupManager::LookupResult HostLookupManager::getCachedResult(const QString &host, QList<QHostAddress> *addresses)
+{
+	const QHostAddress address(host);
+
+	if (!address.isNull())
+	{
+		if (addresses)
+		{
+			*addresses = {address};
+		}
+
+		return ResolvedResult;
+	}
+
+	const QString normalizedHost(normalizeHost(host));
+	QReadLocker locker(&m_entriesLock);
+
+	if (!m_entries.contains(normalizedHost))
+	{
+		return UnknownResult;
+	}
+
+	const HostEntry entry(m_entries.value(normalizedHost));
+
+	if (entry.expirationTime <= QDateTime::currentMSecsSinceEpoch())
+	{
+		return UnknownResult;
+	}
+
+	if (addresses)
+	{
+		*addresses = entry.addresses;
+	}
+
+	return (entry.isResolvable ? ResolvedResult : FailedResult);
+}
+
+HostLookupManager::LookupResult HostLookupManager::resolveHost(const QString &host, QList<QHostAddress> *addresses)
+{
+	const LookupResult result(getCachedResult(host, addresses));
+
+	if (result != UnknownResult)
+	{
+		return result;
+	}
+
+	const QString normalizedHost(normalizeHost(host));
+
+	if (normalizedHost.isEmpty())
+	{
+		return FailedResult;
+	}
+
+// never block the event loop of the main thread, the answer will be available on next call
+	if (m_instance && QThread::currentThread() == m_instance->thread())
+	{
+		m_instance->startLookup(normalizedHost);
+
+		return UnknownResult;
+	}
+
+	storeResult(normalizedHost, QHostInfo::fromName(normalizedHost));
+
+	return getCachedResult(normalizedHost, addresses);
+}
+
+}
@@ -0,0 +1,104 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HOSTLOOKUPMANAGER_H
+#define OTTER_HOSTLOOKUPMANAGER_H
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QHostInfo>
+
+#include <functional>
+
+namespace Otter
+{
+
+class HostLookupManager final : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum LookupResult
+	{
+		UnknownResult = 0,
+		ResolvedResult,
+		FailedResult
+	};
+
+	static void createInstance();
+	static void lookupHost(const QString &host, QObject *context, const std::function<void(LookupResult result)> &function, int timeout = 0);
+	static void prefetchHost(const QUrl &url);
+	static HostLookupManager* getInstance();
+	static LookupResult getCachedResult(const QString &host, QList<QHostAddress> *addresses = nullptr);
+	static LookupResult resolveHost(const QString &host, QList<QHostAddress> *addresses = nullptr);
+
+protected:
+	enum CacheLimit
+	{
+		PositiveTimeToLive = 300000,
+		NegativeTimeToLive = 30000,
+		MaximumEntriesAmount = 1000
+	};
+
+	struct HostEntry final
+	{
+		QList<QHostAddress> addresses;
+		qint64 expirationTime = 0;
+		bool isResolvable = false;
+	};
+
+	struct LookupRequest final
+	{
+		QPointer<QObject> context;
+		std::function<void(LookupResult result)> function;
+		quint64 identifier = 0;
+		bool hasContext = false;
+	};
+
+	explicit HostLookupManager(QObject *parent);
+
+	void startLookup(const QString &host);
+	void handleLookupTimeout(const QString &host, quint64 identifier);
+	static void storeResult(const QString &host, const QHostInfo &information);
+	static QString normalizeHost(const QString &host);
+
+protected slots:
+	void handleLookupFinished(const QHostInfo &information);
+
+private:
+	QHash<int, QString> m_lookups;
+	QHash<QString, QVector<LookupRequest> > m_requests;
+	quint64 m_requestIdentifier;
+
+	static HostLookupManager *m_instance;
+	static QHash<QString, HostEntry> m_entries;
+	static QReadWriteLock m_entriesLock;
+
+signals:
+	void hostResolved(const QString &host, bool isResolvable);
+};
+
+}
+
+#endif
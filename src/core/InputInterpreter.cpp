@@ -20,6 +20,7 @@
 
 #include "InputInterpreter.h"
 #include "BookmarksManager.h"
+#include "HostLookupManager.h"
 #include "SearchEnginesManager.h"
 #include "SettingsManager.h"
 #include "Utils.h"
@@ -27,8 +28,7 @@
 #include <QtCore/QEventLoop>
 #include <QtCore/QFileInfo>
 #include <QtCore/QRegularExpression>
-#include <QtCore/QTimer>
-#include <QtNetwork/QHostInfo>
+#include <QtNetwork/QHostAddress>
 
 namespace Otter
 {
@@ -37,7 +37,104 @@ InputInterpreter::InputInterpreter(QObject *parent) : QObject(parent)
 {
 }
 
+void InputInterpreter::interpret(const QString &text, InterpreterFlags flags, QObject *context, const std::function<void(const InterpreterResult &result)> &function)
+{
+	const InterpreterResult result(interpretText(text, flags));
+
+	if (result.isValid() || text.isEmpty())
+	{
+		function(result);
+
+		return;
+	}
+
+	const QUrl url(QUrl::fromUserInput(text));
+	const int lookupTimeout(SettingsManager::getOption(SettingsManager::AddressField_HostLookupTimeoutOption).toInt());
+
+	if (flags.testFlag(NoHostLookupFlag) || !url.isValid() || lookupTimeout <= 0)
+	{
+		function(createSearchResult(text));
+
+		return;
+	}
+
+	HostLookupManager::lookupHost(url.host(), context, [=](HostLookupManager::LookupResult lookupResult)
+	{
+		if (lookupResult == HostLookupManager::ResolvedResult)
+		{
+			InterpreterResult urlResult;
+			urlResult.url = url;
+			urlResult.type = InterpreterResult::UrlType;
+
+			function(urlResult);
+		}
+		else
+		{
+			function(createSearchResult(text));
+		}
+	}, lookupTimeout);
+}
+
 InputInterpreter::InterpreterResult InputInterpreter::interpret(const QString &text, InterpreterFlags flags)
+{
+	InterpreterResult result(interpretText(text, flags));
+
+	if (result.isValid() || text.isEmpty())
+	{
+		return result;
+	}
+
+	if (!flags.testFlag(NoHostLookupFlag))
+	{
+		const QUrl url(QUrl::fromUserInput(text));
+		const int lookupTimeout(SettingsManager::getOption(SettingsManager::AddressField_HostLookupTimeoutOption).toInt());
+
+		if (url.isValid() && lookupTimeout > 0)
+		{
+			HostLookupManager::LookupResult lookupResult(HostLookupManager::getCachedResult(url.host()));
+
+			if (lookupResult == HostLookupManager::UnknownResult)
+			{
+				QEventLoop eventLoop;
+				bool isFinished(false);
+
+				HostLookupManager::lookupHost(url.host(), &eventLoop, [&](HostLookupManager::LookupResult currentResult)
+				{
+					lookupResult = currentResult;
+					isFinished = true;
+
+					eventLoop.quit();
+				}, lookupTimeout);
+
+				if (!isFinished)
+				{
+					eventLoop.exec();
+				}
+			}
+
+			if (lookupResult == HostLookupManager::ResolvedResult)
+			{
+				result.url = url;
+				result.type = InterpreterResult::UrlType;
+
+				return result;
+			}
+		}
+	}
+
+	return createSearchResult(text);
+}
+
+InputInterpreter::InterpreterResult InputInterpreter::createSearchResult(const QString &text)
+{
+	InterpreterResult result;
+	result.searchQuery = text;
+	result.type = InterpreterResult::SearchType;
+
+	return result;
+}
+
+InputInterpreter::InterpreterResult InputInterpreter::interpretText(const QString &text, InterpreterFlags flags)
 {
 	InterpreterResult result;
 
@@ -125,53 +222,6 @@ InputInterpreter::InterpreterResult InputInterpreter::interpret(const QString &t
 		return result;
 	}
 
-#if QT_VERSION >= 0x050900
-	if (!flags.testFlag(NoHostLookupFlag))
-	{
-		const int lookupTimeout(SettingsManager::getOption(SettingsManager::AddressField_HostLookupTimeoutOption).toInt());
-
-		if (url.isValid() && lookupTimeout > 0)
-		{
-			QEventLoop eventLoop;
-			const int lookupIdentifier(QHostInfo::lookupHost(url.host(), [&](const QHostInfo &information)
-			{
-				if (information.error() == QHostInfo::NoError)
-				{
-					result.url = QUrl::fromUserInput(text);
-					result.type = InterpreterResult::UrlType;
-				}
-
-				eventLoop.quit();
-			}));
-
-			QTimer timer;
-			timer.setSingleShot(true);
-
-			connect(&timer, &QTimer::timeout, [&]()
-			{
-				QHostInfo::abortHostLookup(lookupIdentifier);
-
-				eventLoop.quit();
-			});
-
-			timer.start(lookupTimeout);
-
-			if (result.type == InterpreterResult::UnknownType)
-			{
-				eventLoop.exec();
-			}
-
-			if (result.type == InterpreterResult::UrlType)
-			{
-				return result;
-			}
-		}
-	}
-#endif
-
-	result.searchQuery = text;
-	result.type = InterpreterResult::SearchType;
-
 	return result;
 }
 
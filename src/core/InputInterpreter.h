@@ -23,6 +23,8 @@
 
 #include "BookmarksModel.h"
 
+#include <functional>
+
 namespace Otter
 {
 
@@ -65,7 +67,12 @@ public:
 
 	explicit InputInterpreter(QObject *parent = nullptr);
 
+	static void interpret(const QString &text, InterpreterFlags flags, QObject *context, const std::function<void(const InterpreterResult &result)> &function);
 	static InterpreterResult interpret(const QString &text, InterpreterFlags flags = NoFlags);
+
+protected:
+	static InterpreterResult createSearchResult(const QString &text);
+	static InterpreterResult interpretText(const QString &text, InterpreterFlags flags);
 };
 
 }
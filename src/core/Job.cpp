@@ -20,8 +20,14 @@
 #include "Job.h"
 #include "NetworkManager.h"
 #include "NetworkManagerFactory.h"
+#include "SessionsManager.h"
 #include "Utils.h"
 
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+
 namespace Otter
 {
 
@@ -79,7 +85,7 @@ void FetchJob::start()
 		return;
 	}
 
-	m_reply = NetworkManagerFactory::createRequest(m_url, QNetworkAccessManager::GetOperation, m_isPrivate);
+	m_reply = NetworkManagerFactory::createRequest(createRequest(), QNetworkAccessManager::GetOperation, m_isPrivate);
 
 	connect(m_reply, &QNetworkReply::downloadProgress, this, [&](qint64 bytesReceived, qint64 bytesTotal)
 	{
@@ -151,18 +157,34 @@ void FetchJob::setPrivate(bool isPrivate)
 	m_isPrivate = isPrivate;
 }
 
+QNetworkRequest FetchJob::createRequest() const
+{
+	return QNetworkRequest(m_url);
+}
+
 QUrl FetchJob::getUrl() const
 {
 	return (m_reply ? m_reply->request().url() : m_url);
 }
 
+bool FetchJob::isPrivate() const
+{
+	return m_isPrivate;
+}
+
 bool FetchJob::isRunning() const
 {
 	return (m_reply != nullptr);
 }
 
+QHash<QUrl, DataFetchJob::Validators> DataFetchJob::m_validators;
+QHash<QUrl, DataFetchJob::Validators> DataFetchJob::m_pendingValidators;
+bool DataFetchJob::m_areValidatorsLoaded(false);
+
 DataFetchJob::DataFetchJob(const QUrl &url, QObject *parent) : FetchJob(url, parent),
-	m_reply(nullptr)
+	m_reply(nullptr),
+	m_isConditional(false),
+	m_isNotModified(false)
 {
 }
 
@@ -170,9 +192,153 @@ void DataFetchJob::handleSuccessfulReply(QNetworkReply *reply)
 {
 	m_reply = reply;
 
+	if (m_isConditional && !isPrivate())
+	{
+		if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304)
+		{
+			m_isNotModified = true;
+
+			m_pendingValidators.remove(getUrl());
+		}
+		else
+		{
+			Validators validators;
+			validators.entityTag = reply->rawHeader(QByteArrayLiteral("ETag"));
+			validators.lastModified = reply->rawHeader(QByteArrayLiteral("Last-Modified"));
+
+			m_pendingValidators[getUrl()] = validators;
+		}
+	}
+
 	markAsFinished();
 }
 
+void DataFetchJob::commitValidators(const QUrl &url)
+{
+	if (!m_pendingValidators.contains(url))
+	{
+		return;
+	}
+
+	const Validators validators(m_pendingValidators.take(url));
+
+	loadValidators();
+
+	if (validators.entityTag.isEmpty() && validators.lastModified.isEmpty())
+	{
+		if (m_validators.remove(url) > 0)
+		{
+			saveValidators();
+		}
+	}
+	else
+	{
+		m_validators[url] = validators;
+
+		saveValidators();
+	}
+}
+
+void DataFetchJob::loadValidators()
+{
+	if (m_areValidatorsLoaded)
+	{
+		return;
+	}
+
+	m_areValidatorsLoaded = true;
+
+	QFile file(SessionsManager::getWritableDataPath(QLatin1String("validators.json")));
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	const QJsonObject validatorsObject(QJsonDocument::fromJson(file.readAll()).object());
+	QJsonObject::const_iterator iterator;
+
+	for (iterator = validatorsObject.constBegin(); iterator != validatorsObject.constEnd(); ++iterator)
+	{
+		const QJsonObject validatorObject(iterator.value().toObject());
+		Validators validators;
+		validators.entityTag = validatorObject.value(QLatin1String("etag")).toString().toLatin1();
+		validators.lastModified = validatorObject.value(QLatin1String("lastModified")).toString().toLatin1();
+
+		m_validators[QUrl(iterator.key())] = validators;
+	}
+}
+
+void DataFetchJob::saveValidators()
+{
+	if (SessionsManager::isReadOnly())
+	{
+		return;
+	}
+
+	QJsonObject validatorsObject;
+	QHash<QUrl, Validators>::const_iterator iterator;
+
+	for (iterator = m_validators.constBegin(); iterator != m_validators.constEnd(); ++iterator)
+	{
+		QJsonObject validatorObject;
+
+		if (!iterator.value().entityTag.isEmpty())
+		{
+			validatorObject.insert(QLatin1String("etag"), QString::fromLatin1(iterator.value().entityTag));
+		}
+
+		if (!iterator.value().lastModified.isEmpty())
+		{
+			validatorObject.insert(QLatin1String("lastModified"), QString::fromLatin1(iterator.value().lastModified));
+		}
+
+		validatorsObject.insert(iterator.key().toString(), validatorObject);
+	}
+
+	QSaveFile file(SessionsManager::getWritableDataPath(QLatin1String("validators.json")));
+
+	if (file.open(QIODevice::WriteOnly))
+	{
+		file.write(QJsonDocument(validatorsObject).toJson(QJsonDocument::Compact));
+		file.commit();
+	}
+}
+
+void DataFetchJob::setConditional(bool isConditional)
+{
+	m_isConditional = isConditional;
+}
+
+QNetworkRequest DataFetchJob::createRequest() const
+{
+	QNetworkRequest request(FetchJob::createRequest());
+
+	if (!m_isConditional || isPrivate())
+	{
+		return request;
+	}
+
+	loadValidators();
+
+	const Validators validators(m_validators.value(request.url()));
+
+	if (!validators.entityTag.isEmpty())
+	{
+		request.setRawHeader(QByteArrayLiteral("If-None-Match"), validators.entityTag);
+	}
+
+	if (!validators.lastModified.isEmpty())
+	{
+		request.setRawHeader(QByteArrayLiteral("If-Modified-Since"), validators.lastModified);
+	}
+
+	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+	request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+
+	return request;
+}
+
 QIODevice* DataFetchJob::getData() const
 {
 	return m_reply;
@@ -191,6 +357,11 @@ QMap<QByteArray, QByteArray> DataFetchJob::getHeaders() const
 	return headers;
 }
 
+bool DataFetchJob::isNotModified() const
+{
+	return m_isNotModified;
+}
+
 IconFetchJob::IconFetchJob(const QUrl &url, QObject *parent) : FetchJob(url, parent)
 {
 	setSizeLimit(20480);
@@ -63,6 +63,7 @@ public:
 	void setSizeLimit(qint64 limit);
 	void setPrivate(bool isPrivate);
 	QUrl getUrl() const;
+	bool isPrivate() const;
 	bool isRunning() const override;
 
 public slots:
@@ -73,6 +74,7 @@ protected:
 	void timerEvent(QTimerEvent *event) override;
 	void markAsFailure();
 	void markAsFinished();
+	virtual QNetworkRequest createRequest() const;
 	virtual void handleSuccessfulReply(QNetworkReply *reply) = 0;
 
 private:
@@ -92,14 +94,32 @@ class DataFetchJob final : public FetchJob
 public:
 	explicit DataFetchJob(const QUrl &url, QObject *parent = nullptr);
 
+	static void commitValidators(const QUrl &url);
+	void setConditional(bool isConditional);
 	QIODevice* getData() const;
 	QMap<QByteArray, QByteArray> getHeaders() const;
+	bool isNotModified() const;
 
 protected:
+	struct Validators final
+	{
+		QByteArray entityTag;
+		QByteArray lastModified;
+	};
+
+	QNetworkRequest createRequest() const override;
 	void handleSuccessfulReply(QNetworkReply *reply) override;
+	static void loadValidators();
+	static void saveValidators();
 
 private:
 	QNetworkReply *m_reply;
+	bool m_isConditional;
+	bool m_isNotModified;
+
+	static QHash<QUrl, Validators> m_validators;
+	static QHash<QUrl, Validators> m_pendingValidators;
+	static bool m_areValidatorsLoaded;
 };
 
 class IconFetchJob final : public FetchJob
@@ -0,0 +1,226 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "MemoryPressureManager.h"
+#include "Application.h"
+#include "SettingsManager.h"
+#include "Utils.h"
+#include "../ui/ContentsWidget.h"
+#include "../ui/MainWindow.h"
+#include "../ui/WebWidget.h"
+#include "../ui/Window.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QHash>
+#include <QtCore/QTimerEvent>
+
+#include <algorithm>
+
+namespace Otter
+{
+
+MemoryPressureManager* MemoryPressureManager::m_instance(nullptr);
+
+MemoryPressureManager::MemoryPressureManager(QObject *parent) : QObject(parent),
+	m_suspensionUsage(0),
+	m_checkTimer(0)
+{
+	updateCheckTimer();
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &MemoryPressureManager::handleOptionChanged);
+}
+
+void MemoryPressureManager::createInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new MemoryPressureManager(QCoreApplication::instance());
+	}
+}
+
+void MemoryPressureManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_checkTimer)
+	{
+		checkMemoryUsage();
+	}
+}
+
+void MemoryPressureManager::checkMemoryUsage()
+{
+	const qint64 limit(SettingsManager::getOption(SettingsManager::Browser_TabsMemoryLimitOption).toLongLong() * 1048576);
+
+	if (limit <= 0)
+	{
+		return;
+	}
+
+	struct Candidate final
+	{
+		Window *window = nullptr;
+		qint64 processIdentifier = 0;
+		qint64 usage = 0;
+		qreal score = 0;
+	};
+
+	const qint64 applicationIdentifier(QCoreApplication::applicationPid());
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	const QVector<MainWindow*> mainWindows(Application::getWindows());
+	QVector<Candidate> candidates;
+	QHash<qint64, int> processWindows;
+	qint64 totalUsage(0);
+
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		const MainWindow *mainWindow(mainWindows.at(i));
+		const Window *activeWindow(mainWindow->getActiveWindow());
+
+		for (int j = 0; j < mainWindow->getWindowCount(); ++j)
+		{
+			Window *window(mainWindow->getWindowByIndex(j));
+
+			if (!window || window->getLoadingState() == WebWidget::DeferredLoadingState)
+			{
+				continue;
+			}
+
+			const WebWidget *webWidget(window->getContentsWidget()->getWebWidget());
+
+			if (!webWidget)
+			{
+				continue;
+			}
+
+			const qint64 processIdentifier(webWidget->getProcessIdentifier());
+			qint64 usage(-1);
+
+			if (processIdentifier == applicationIdentifier)
+			{
+// Resident memory of the browser process does not shrink after a tab is suspended, so in-process tabs are accounted by their own estimates and skipped if they have none
+				usage = webWidget->getMemoryUsage();
+
+				if (usage < 0)
+				{
+					continue;
+				}
+
+				totalUsage += usage;
+			}
+			else
+			{
+				if (!processWindows.contains(processIdentifier))
+				{
+					totalUsage += qMax(Utils::getProcessMemoryUsage(processIdentifier), qint64(0));
+				}
+
+				++processWindows[processIdentifier];
+			}
+
+			if (window == activeWindow || window->isPinned() || webWidget->isAudible())
+			{
+				continue;
+			}
+
+			const QDateTime lastActivity(window->getLastActivity());
+			Candidate candidate;
+			candidate.window = window;
+			candidate.processIdentifier = processIdentifier;
+			candidate.usage = usage;
+			candidate.score = (lastActivity.isValid() ? (static_cast<qreal>(lastActivity.secsTo(currentDateTime)) / 60) : 0);
+
+			candidates.append(candidate);
+		}
+	}
+
+	const qint64 targetUsage((limit * 9) / 10);
+
+	if (totalUsage <= limit || candidates.isEmpty())
+	{
+		if (totalUsage <= targetUsage)
+		{
+			m_suspensionTime = {};
+		}
+
+		return;
+	}
+
+	if (m_suspensionTime.isValid() && (m_suspensionTime.msecsTo(currentDateTime) < SuspensionCooldownInterval || totalUsage >= m_suspensionUsage))
+	{
+		return;
+	}
+
+	for (int i = 0; i < candidates.count(); ++i)
+	{
+		Candidate &candidate(candidates[i]);
+
+		if (candidate.usage < 0)
+		{
+			candidate.usage = (qMax(Utils::getProcessMemoryUsage(candidate.processIdentifier), qint64(0)) / qMax(processWindows.value(candidate.processIdentifier), 1));
+		}
+
+		candidate.score = (static_cast<qreal>(candidate.usage) * (1 + qMax(candidate.score, qreal(0))));
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate &first, const Candidate &second)
+	{
+		return (first.score > second.score);
+	});
+
+	m_suspensionUsage = totalUsage;
+
+	for (int i = 0; (i < candidates.count() && totalUsage > targetUsage); ++i)
+	{
+		candidates.at(i).window->triggerAction(ActionsManager::SuspendTabAction);
+
+		totalUsage -= candidates.at(i).usage;
+	}
+
+	m_suspensionTime = currentDateTime;
+}
+
+void MemoryPressureManager::updateCheckTimer()
+{
+	const bool isEnabled(SettingsManager::getOption(SettingsManager::Browser_TabsMemoryLimitOption).toInt() > 0);
+
+	if (isEnabled && m_checkTimer == 0)
+	{
+		m_checkTimer = startTimer(MemoryCheckInterval);
+	}
+	else if (!isEnabled && m_checkTimer != 0)
+	{
+		killTimer(m_checkTimer);
+
+		m_checkTimer = 0;
+	}
+}
+
+void MemoryPressureManager::handleOptionChanged(int identifier)
+{
+	if (identifier == SettingsManager::Browser_TabsMemoryLimitOption)
+	{
+		updateCheckTimer();
+	}
+}
+
+MemoryPressureManager* MemoryPressureManager::getInstance()
+{
+	return m_instance;
+}
+
+}
@@ -0,0 +1,63 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_MEMORYPRESSUREMANAGER_H
+#define OTTER_MEMORYPRESSUREMANAGER_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QObject>
+
+namespace Otter
+{
+
+class MemoryPressureManager final : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance();
+	static MemoryPressureManager* getInstance();
+
+protected:
+	enum CheckInterval
+	{
+		MemoryCheckInterval = 15000,
+		SuspensionCooldownInterval = 60000
+	};
+
+	explicit MemoryPressureManager(QObject *parent);
+
+	void timerEvent(QTimerEvent *event) override;
+	void checkMemoryUsage();
+	void updateCheckTimer();
+
+protected slots:
+	void handleOptionChanged(int identifier);
+
+private:
+	QDateTime m_suspensionTime;
+	qint64 m_suspensionUsage;
+	int m_checkTimer;
+
+	static MemoryPressureManager *m_instance;
+};
+
+}
+
+#endif
@@ -20,12 +20,15 @@
 
 #include "NetworkAutomaticProxy.h"
 #include "Console.h"
+#include "HostLookupManager.h"
 #include "Job.h"
+#include "SettingsManager.h"
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDate>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
-#include <QtNetwork/QHostInfo>
+#include <QtCore/QTimer>
 #include <QtNetwork/QNetworkInterface>
 
 namespace Otter
@@ -40,16 +43,19 @@ PacUtils::PacUtils(QObject *parent) : QObject(parent)
 
 void PacUtils::alert(const QString &message) const
 {
-	Console::addMessage(message, Console::NetworkCategory, Console::WarningLevel);
+	QTimer::singleShot(0, QCoreApplication::instance(), [=]()
+	{
+		Console::addMessage(message, Console::NetworkCategory, Console::WarningLevel);
+	});
 }
 
 QString PacUtils::dnsResolve(const QString &host) const
 {
-	const QHostInfo hostInformation(QHostInfo::fromName(host));
+	QList<QHostAddress> addresses;
 
-	if (hostInformation.error() == QHostInfo::NoError && !hostInformation.addresses().isEmpty())
+	if (HostLookupManager::resolveHost(host, &addresses) == HostLookupManager::ResolvedResult && !addresses.isEmpty())
 	{
-		return hostInformation.addresses().value(0).toString();
+		return addresses.value(0).toString();
 	}
 
 	return {};
@@ -96,7 +102,7 @@ bool PacUtils::isPlainHostName(const QString &host) const
 
 bool PacUtils::isResolvable(const QString &host) const
 {
-	return (QHostInfo::fromName(host).error() == QHostInfo::NoError);
+	return (HostLookupManager::resolveHost(host) == HostLookupManager::ResolvedResult);
 }
 
 bool PacUtils::localHostOrDomainIs(const QString &host, QString domain) const
@@ -290,33 +296,101 @@ bool PacUtils::isInRange(const QVariant &valueOne, const QVariant &valueTwo, con
 	return (actualValue >= valueOne && actualValue <= valueTwo);
 }
 
-NetworkAutomaticProxy::NetworkAutomaticProxy(const QString &path, QObject *parent) : QObject(parent),
-	m_path(path),
-	m_isValid(false)
+NetworkAutomaticProxyWorker::NetworkAutomaticProxyWorker(QObject *parent) : QObject(parent),
+	m_engine(nullptr)
+{
+}
+
+void NetworkAutomaticProxyWorker::evaluateProxy(const QString &key, const QString &url, const QString &host)
 {
-	m_engine.globalObject().setProperty(QLatin1String("PacUtils"), m_engine.newQObject(new PacUtils(this)));
+	emit proxyEvaluated(key, findProxy(url, host));
+}
+
+QString NetworkAutomaticProxyWorker::findProxy(const QString &url, const QString &host)
+{
+	if (!m_findProxy.isCallable())
+	{
+		return QLatin1String("ERROR");
+	}
+
+	const QJSValue result(m_findProxy.call(QJSValueList({m_engine->toScriptValue(url), m_engine->toScriptValue(host)})));
+
+	if (result.isError())
+	{
+		return QLatin1String("ERROR");
+	}
+
+	return result.toString().remove(QLatin1Char(' '));
+}
+
+bool NetworkAutomaticProxyWorker::setup(const QString &script)
+{
+	if (m_engine)
+	{
+		m_findProxy = QJSValue();
+
+		delete m_engine;
+	}
+
+	m_engine = new QJSEngine(this);
+	m_engine->globalObject().setProperty(QLatin1String("PacUtils"), m_engine->newQObject(new PacUtils(m_engine)));
 
 	const QStringList functions({QLatin1String("alert"), QLatin1String("dnsResolve"), QLatin1String("myIpAddress"), QLatin1String("dnsDomainLevels"), QLatin1String("isInNet"), QLatin1String("isPlainHostName"), QLatin1String("isResolvable"), QLatin1String("localHostOrDomainIs"), QLatin1String("dnsDomainIs"), QLatin1String("shExpMatch"), QLatin1String("weekdayRange"), QLatin1String("dateRange"), QLatin1String("timeRange")});
 
 	for (int i = 0; i < functions.count(); ++i)
 	{
-		m_engine.evaluate(QStringLiteral("function %1() { return PacUtils.%1.apply(null, arguments); }").arg(functions.at(i))).isError();
+		m_engine->evaluate(QStringLiteral("function %1() { return PacUtils.%1.apply(null, arguments); }").arg(functions.at(i))).isError();
 	}
 
+	if (m_engine->evaluate(script).isError())
+	{
+		return false;
+	}
+
+	m_findProxy = m_engine->globalObject().property(QLatin1String("FindProxyForURL"));
+
+	return m_findProxy.isCallable();
+}
+
+NetworkAutomaticProxy::NetworkAutomaticProxy(const QString &path, QObject *parent) : QObject(parent),
+	m_worker(new NetworkAutomaticProxyWorker()),
+	m_path(path),
+	m_isValid(false)
+{
+	m_thread.setObjectName(QLatin1String("NetworkAutomaticProxy"));
+	m_thread.start();
+
+	m_worker->moveToThread(&m_thread);
+
+	connect(&m_thread, &QThread::finished, m_worker, &NetworkAutomaticProxyWorker::deleteLater);
+	connect(m_worker, &NetworkAutomaticProxyWorker::proxyEvaluated, this, &NetworkAutomaticProxy::handleProxyEvaluated, Qt::DirectConnection);
+
 	m_proxies.insert(QLatin1String("ERROR"), QVector<QNetworkProxy>({QNetworkProxy(QNetworkProxy::DefaultProxy)}));
 	m_proxies.insert(QLatin1String("DIRECT"), QVector<QNetworkProxy>({QNetworkProxy(QNetworkProxy::NoProxy)}));
 
 	setPath(path);
 }
 
+NetworkAutomaticProxy::~NetworkAutomaticProxy()
+{
+	m_thread.quit();
+	m_thread.wait();
+}
+
 void NetworkAutomaticProxy::setPath(const QString &path)
 {
+	const bool isConditional(m_isValid && path == m_path);
+
+	m_path = path;
+
 	if (QFile::exists(path))
 	{
 		QFile file(path);
 
 		if (file.open(QIODevice::ReadOnly | QIODevice::Text) && setup(QString::fromLatin1(file.readAll())))
 		{
+			clearCache();
+
 			m_isValid = true;
 
 			file.close();
@@ -333,13 +407,23 @@ void NetworkAutomaticProxy::setPath(const QString &path)
 		if (url.isValid())
 		{
 			DataFetchJob *job(new DataFetchJob(url, this));
+			job->setConditional(isConditional);
 
 			connect(job, &Job::jobFinished, this, [=](bool isSuccess)
 			{
 				QIODevice *device(job->getData());
 
+				if (isSuccess && job->isNotModified())
+				{
+					return;
+				}
+
 				if (isSuccess && device && setup(QString::fromLatin1(device->readAll())))
 				{
+					DataFetchJob::commitValidators(job->getUrl());
+
+					clearCache();
+
 					m_isValid = true;
 				}
 				else
@@ -357,22 +441,114 @@ void NetworkAutomaticProxy::setPath(const QString &path)
 	}
 }
 
+void NetworkAutomaticProxy::clearCache()
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_cache.clear();
+}
+
 QString NetworkAutomaticProxy::getPath() const
 {
 	return m_path;
 }
 
+QString NetworkAutomaticProxy::getCacheKey(const QString &url, const QString &host)
+{
+	const QUrl parsedUrl(url);
+
+	return (parsedUrl.scheme() + QLatin1String("://") + host.toLower() + QLatin1Char(':') + QString::number(parsedUrl.port()));
+}
+
+void NetworkAutomaticProxy::handleProxyEvaluated(const QString &key, const QString &configuration)
+{
+	const int cacheTime(SettingsManager::getOption(SettingsManager::Network_ProxyAutoConfigCacheTimeOption).toInt());
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+	QMutexLocker locker(&m_mutex);
+
+	if (m_cache.count() >= MaximumEntriesAmount)
+	{
+		QHash<QString, CacheEntry>::iterator iterator(m_cache.begin());
+
+		while (iterator != m_cache.end())
+		{
+			if (iterator.value().expirationTime <= currentTime)
+			{
+				iterator = m_cache.erase(iterator);
+			}
+			else
+			{
+				++iterator;
+			}
+		}
+
+		if (m_cache.count() >= MaximumEntriesAmount)
+		{
+			m_cache.clear();
+		}
+	}
+
+	CacheEntry entry;
+	entry.proxies = parseProxies(configuration);
+	entry.expirationTime = (currentTime + (qMax(cacheTime, 0) * 1000));
+
+	m_cache[key] = entry;
+
+	m_pendingKeys.remove(key);
+	m_condition.wakeAll();
+}
+
 QVector<QNetworkProxy> NetworkAutomaticProxy::getProxy(const QString &url, const QString &host)
 {
-	const QJSValue result(m_findProxy.call(QJSValueList({m_engine.toScriptValue(url), m_engine.toScriptValue(host)})));
+	const QString key(getCacheKey(url, host));
 
-	if (result.isError())
+	if (QThread::currentThread() == &m_thread)
 	{
-		return m_proxies[QLatin1String("ERROR")];
+		handleProxyEvaluated(key, m_worker->findProxy(url, host));
+
+		QMutexLocker locker(&m_mutex);
+
+		return m_cache.value(key).proxies;
+	}
+
+	const bool canUseExpired(SettingsManager::getOption(SettingsManager::Network_ProxyAutoConfigCacheTimeOption).toInt() > 0);
+	QMutexLocker locker(&m_mutex);
+
+	if (m_cache.contains(key) && m_cache[key].expirationTime > QDateTime::currentMSecsSinceEpoch())
+	{
+		return m_cache[key].proxies;
+	}
+
+	if (!m_pendingKeys.contains(key))
+	{
+		m_pendingKeys.insert(key);
+
+		QMetaObject::invokeMethod(m_worker, "evaluateProxy", Qt::QueuedConnection, Q_ARG(QString, key), Q_ARG(QString, url), Q_ARG(QString, host));
+	}
+
+	if (canUseExpired && m_cache.contains(key))
+	{
+		return m_cache[key].proxies;
 	}
 
-	const QString configuration(result.toString().remove(QLatin1Char(' ')));
+	QElapsedTimer timer;
+	timer.start();
 
+	while (m_pendingKeys.contains(key))
+	{
+		const qint64 remainingTime(EvaluationTimeout - timer.elapsed());
+
+		if (remainingTime <= 0 || !m_condition.wait(&m_mutex, static_cast<unsigned long>(remainingTime)))
+		{
+			return m_proxies[QLatin1String("DIRECT")];
+		}
+	}
+
+	return (m_cache.contains(key) ? m_cache[key].proxies : m_proxies[QLatin1String("DIRECT")]);
+}
+
+QVector<QNetworkProxy> NetworkAutomaticProxy::parseProxies(const QString &configuration)
+{
 	if (!m_proxies.value(configuration).isEmpty())
 	{
 		return m_proxies[configuration];
@@ -426,14 +602,11 @@ bool NetworkAutomaticProxy::isValid() const
 
 bool NetworkAutomaticProxy::setup(const QString &script)
 {
-	if (m_engine.evaluate(script).isError())
-	{
-		return false;
-	}
+	bool isSuccess(false);
 
-	m_findProxy = m_engine.globalObject().property(QLatin1String("FindProxyForURL"));
+	QMetaObject::invokeMethod(m_worker, "setup", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, isSuccess), Q_ARG(QString, script));
 
-	return m_findProxy.isCallable();
+	return isSuccess;
 }
 
 }
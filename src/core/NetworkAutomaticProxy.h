@@ -21,6 +21,10 @@
 #ifndef OTTER_NETWORKAUTOMATICPROXY_H
 #define OTTER_NETWORKAUTOMATICPROXY_H
 
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
 #include <QtNetwork/QNetworkProxy>
 #include <QtQml/QJSEngine>
 
@@ -57,10 +61,31 @@ private:
 	static QStringList m_days;
 };
 
+class NetworkAutomaticProxyWorker final : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit NetworkAutomaticProxyWorker(QObject *parent = nullptr);
+
+public slots:
+	void evaluateProxy(const QString &key, const QString &url, const QString &host);
+	QString findProxy(const QString &url, const QString &host);
+	bool setup(const QString &script);
+
+private:
+	QJSEngine *m_engine;
+	QJSValue m_findProxy;
+
+signals:
+	void proxyEvaluated(const QString &key, const QString &configuration);
+};
+
 class NetworkAutomaticProxy final : public QObject
 {
 public:
 	explicit NetworkAutomaticProxy(const QString &path, QObject *parent = nullptr);
+	~NetworkAutomaticProxy();
 
 	void setPath(const QString &path);
 	QString getPath() const;
@@ -68,13 +93,33 @@ public:
 	bool isValid() const;
 
 protected:
+	enum CacheLimit
+	{
+		MaximumEntriesAmount = 500,
+		EvaluationTimeout = 2000
+	};
+
+	struct CacheEntry final
+	{
+		QVector<QNetworkProxy> proxies;
+		qint64 expirationTime = 0;
+	};
+
+	void clearCache();
+	void handleProxyEvaluated(const QString &key, const QString &configuration);
+	static QString getCacheKey(const QString &url, const QString &host);
+	QVector<QNetworkProxy> parseProxies(const QString &configuration);
 	bool setup(const QString &script);
 
 private:
-	QJSEngine m_engine;
-	QJSValue m_findProxy;
+	QThread m_thread;
+	NetworkAutomaticProxyWorker *m_worker;
 	QString m_path;
 	QHash<QString, QVector<QNetworkProxy> > m_proxies;
+	QHash<QString, CacheEntry> m_cache;
+	QSet<QString> m_pendingKeys;
+	QMutex m_mutex;
+	QWaitCondition m_condition;
 	bool m_isValid;
 };
 
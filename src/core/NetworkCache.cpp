@@ -18,16 +18,24 @@
 **************************************************************************/
 
 #include "NetworkCache.h"
+#include "Console.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimerEvent>
 
 namespace Otter
 {
 
-NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent)
+NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent),
+	m_saveTimer(0),
+	m_isIndexValid(false)
 {
 	const QString cachePath(SessionsManager::getCachePath());
 
@@ -37,11 +45,29 @@ NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent)
 
 		setCacheDirectory(cachePath);
 		setMaximumCacheSize(SettingsManager::getOption(SettingsManager::Cache_DiskCacheLimitOption).toInt() * 1024);
+		loadIndex();
 
 		connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &NetworkCache::handleOptionChanged);
 	}
 }
 
+NetworkCache::~NetworkCache()
+{
+	saveIndex();
+}
+
+void NetworkCache::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_saveTimer)
+	{
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+
+		saveIndex();
+	}
+}
+
 void NetworkCache::handleOptionChanged(int identifier, const QVariant &value)
 {
 	if (identifier == SettingsManager::Cache_DiskCacheLimitOption)
@@ -61,7 +87,151 @@ void NetworkCache::clearCache(int period)
 		return;
 	}
 
+	if (!m_isIndexValid)
+	{
+		rebuildIndex();
+	}
+
 	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	QVector<QUrl> urls;
+	QHash<QUrl, Entry>::const_iterator iterator;
+
+	for (iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator)
+	{
+		if (iterator.value().timeStored.secsTo(currentDateTime) < (period * 3600))
+		{
+			urls.append(iterator.key());
+		}
+	}
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		remove(urls.at(i));
+	}
+}
+
+void NetworkCache::clear()
+{
+	m_entries.clear();
+
+	QNetworkDiskCache::clear();
+
+	m_isIndexValid = !cacheDirectory().isEmpty();
+
+	scheduleSave();
+}
+
+void NetworkCache::loadIndex()
+{
+	QFile file(getIndexPath());
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	const QDir directory(cacheDirectory());
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magic(0);
+	quint32 version(0);
+	quint32 amount(0);
+
+	stream >> magic >> version >> amount;
+
+	if (magic == IndexMagic && version == IndexVersion)
+	{
+		m_entries.reserve(static_cast<int>(amount));
+
+		for (quint32 i = 0; i < amount; ++i)
+		{
+			Entry entry;
+
+			stream >> entry.url >> entry.path >> entry.contentType >> entry.lastModified >> entry.expirationDate >> entry.timeStored >> entry.size;
+
+			if (stream.status() != QDataStream::Ok)
+			{
+				break;
+			}
+
+			if (!entry.path.isEmpty())
+			{
+				entry.path = directory.absoluteFilePath(entry.path);
+			}
+
+			m_entries[entry.url] = entry;
+		}
+
+		m_isIndexValid = (stream.status() == QDataStream::Ok);
+	}
+
+	if (!m_isIndexValid)
+	{
+		m_entries.clear();
+	}
+}
+
+void NetworkCache::scheduleSave()
+{
+	if (m_saveTimer == 0 && !cacheDirectory().isEmpty())
+	{
+		m_saveTimer = startTimer(1000);
+	}
+}
+
+void NetworkCache::saveIndex()
+{
+	if (cacheDirectory().isEmpty())
+	{
+		return;
+	}
+
+	if (!m_isIndexValid)
+	{
+		QFile::remove(getIndexPath());
+
+		return;
+	}
+
+	QSaveFile file(getIndexPath());
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save network cache index: %1").arg(file.errorString()), Console::NetworkCategory, Console::ErrorLevel, file.fileName());
+
+		return;
+	}
+
+	const QDir directory(cacheDirectory());
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(IndexMagic) << static_cast<quint32>(IndexVersion) << static_cast<quint32>(m_entries.count());
+
+	QHash<QUrl, Entry>::const_iterator iterator;
+
+	for (iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator)
+	{
+		const Entry &entry(iterator.value());
+
+		stream << entry.url << (entry.path.isEmpty() ? QString() : directory.relativeFilePath(entry.path)) << entry.contentType << entry.lastModified << entry.expirationDate << entry.timeStored << entry.size;
+	}
+
+	if (!file.commit())
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save network cache index: %1").arg(file.errorString()), Console::NetworkCategory, Console::ErrorLevel, file.fileName());
+	}
+}
+
+void NetworkCache::rebuildIndex()
+{
+	m_entries.clear();
+
+	if (cacheDirectory().isEmpty())
+	{
+		return;
+	}
+
 	const QDir cacheMainDirectory(cacheDirectory());
 	const QStringList directories(cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
 
@@ -76,29 +246,115 @@ void NetworkCache::clearCache(int period)
 
 			for (int k = 0; k < files.count(); ++k)
 			{
-				if (files.at(k).lastModified().toUTC().secsTo(currentDateTime) < (period * 3600))
+				const QNetworkCacheMetaData metaData(fileMetaData(files.at(k).absoluteFilePath()));
+
+				if (metaData.isValid() && metaData.url().isValid())
 				{
-					const QNetworkCacheMetaData metaData(fileMetaData(files.at(k).absoluteFilePath()));
+					Entry entry;
+					entry.url = metaData.url();
+					entry.path = files.at(k).absoluteFilePath();
+					entry.timeStored = files.at(k).lastModified().toUTC();
+					entry.size = files.at(k).size();
 
-					if (metaData.isValid())
-					{
-						remove(metaData.url());
-					}
+					updateEntry(entry, metaData);
+
+					m_entries[entry.url] = entry;
 				}
 			}
 		}
 	}
+
+	m_isIndexValid = true;
+
+	scheduleSave();
+}
+
+void NetworkCache::updateEntry(Entry &entry, const QNetworkCacheMetaData &metaData) const
+{
+	const QList<QPair<QByteArray, QByteArray> > headers(metaData.rawHeaders());
+
+	entry.lastModified = metaData.lastModified();
+	entry.expirationDate = metaData.expirationDate();
+	entry.contentType.clear();
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		if (headers.at(i).first.compare(QByteArrayLiteral("Content-Type"), Qt::CaseInsensitive) == 0)
+		{
+			entry.contentType = QString::fromLatin1(headers.at(i).second);
+
+			break;
+		}
+	}
 }
 
 void NetworkCache::insert(QIODevice *device)
 {
+	const QHash<QIODevice*, QNetworkCacheMetaData>::iterator iterator(m_devices.find(device));
+
+	if (iterator == m_devices.end())
+	{
+		QNetworkDiskCache::insert(device);
+
+		return;
+	}
+
+	const QNetworkCacheMetaData metaData(iterator.value());
+	const qint64 size(device->size());
+
+	m_devices.erase(iterator);
+
 	QNetworkDiskCache::insert(device);
 
-	if (m_devices.contains(device))
+	if (m_isIndexValid)
 	{
-		emit entryAdded(m_devices[device]);
+		Entry entry;
+		entry.url = metaData.url();
+		entry.path = getFileName(entry.url);
+		entry.timeStored = QDateTime::currentDateTimeUtc();
+		entry.size = size;
+
+		const QFileInfo fileInfo(entry.path);
+
+		if (fileInfo.exists() && fileMetaData(entry.path).url() == entry.url)
+		{
+			entry.size = fileInfo.size();
+
+			updateEntry(entry, metaData);
 
-		m_devices.remove(device);
+			m_entries[entry.url] = entry;
+		}
+		else
+		{
+			m_entries.clear();
+
+			m_isIndexValid = false;
+		}
+
+		scheduleSave();
+	}
+
+	emit entryAdded(metaData.url());
+}
+
+void NetworkCache::updateMetaData(const QNetworkCacheMetaData &metaData)
+{
+	QNetworkDiskCache::updateMetaData(metaData);
+
+	if (!m_isIndexValid)
+	{
+		return;
+	}
+
+	const QHash<QUrl, Entry>::iterator iterator(m_entries.find(metaData.url()));
+
+	if (iterator != m_entries.end())
+	{
+		iterator.value().timeStored = QDateTime::currentDateTimeUtc();
+
+		updateEntry(iterator.value(), metaData);
+
+		scheduleSave();
 	}
 }
 
@@ -108,87 +364,148 @@ QIODevice* NetworkCache::prepare(const QNetworkCacheMetaData &metaData)
 
 	if (device)
 	{
-		m_devices[device] = metaData.url();
+		m_devices[device] = metaData;
 	}
 
 	return device;
 }
 
+QString NetworkCache::getIndexPath() const
+{
+	return QDir(cacheDirectory()).filePath(QLatin1String("index.dat"));
+}
+
+QString NetworkCache::getFileName(const QUrl &url) const
+{
+// Mirrors file naming used by QNetworkDiskCache, result needs to be verified before use
+	QUrl cleanUrl(url);
+	cleanUrl.setPassword({});
+	cleanUrl.setFragment({});
+
+	const QByteArray hash(QCryptographicHash::hash(cleanUrl.toEncoded(), QCryptographicHash::Sha1));
+	const QByteArray identifier(QByteArray::number(*reinterpret_cast<const qlonglong*>(hash.constData()), 36).left(8));
+
+	return QDir(cacheDirectory()).absoluteFilePath(QStringLiteral("data8/%1/%2.d").arg(QString::number((static_cast<uint>(identifier.at(identifier.length() - 1)) % 16), 16)).arg(QString::fromLatin1(identifier)));
+}
+
 QString NetworkCache::getPathForUrl(const QUrl &url)
 {
-	if (!url.isValid() || !metaData(url).isValid())
+	if (!url.isValid())
 	{
 		return {};
 	}
 
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories(cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
-
-	for (int i = 0; i < directories.count(); ++i)
+	if (!m_isIndexValid)
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories(cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+		rebuildIndex();
+	}
 
-		for (int j = 0; j < subDirectories.count(); ++j)
+	const QString path(m_entries.value(url).path);
+
+	if (path.isEmpty() || fileMetaData(path).url() != url)
+	{
+		if (!m_entries.contains(url))
 		{
-			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files(cacheFilesDirectory.entryList(QDir::Files));
+			return {};
+		}
 
-			for (int k = 0; k < files.count(); ++k)
-			{
-				const QString cacheFilePath(cacheFilesDirectory.absoluteFilePath(files.at(k)));
-				const QNetworkCacheMetaData metaData(fileMetaData(cacheFilePath));
+		rebuildIndex();
 
-				if (metaData.isValid() && url == metaData.url())
-				{
-					return cacheFilePath;
-				}
-			}
-		}
+		return m_entries.value(url).path;
 	}
 
-	return {};
+	return path;
 }
 
-QVector<QUrl> NetworkCache::getEntries() const
+NetworkCache::Entry NetworkCache::getEntry(const QUrl &url)
 {
-	QVector<QUrl> entries;
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories(cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+	if (!m_isIndexValid)
+	{
+		rebuildIndex();
+	}
 
-	for (int i = 0; i < directories.count(); ++i)
+	return m_entries.value(url);
+}
+
+QVector<NetworkCache::Entry> NetworkCache::getEntries()
+{
+	if (!m_isIndexValid)
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories(cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+		rebuildIndex();
+	}
 
-		for (int j = 0; j < subDirectories.count(); ++j)
+	QVector<Entry> entries;
+	entries.reserve(m_entries.count());
+
+	QHash<QUrl, Entry>::const_iterator iterator;
+
+	for (iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator)
+	{
+		entries.append(iterator.value());
+	}
+
+	return entries;
+}
+
+qint64 NetworkCache::expire()
+{
+	const qint64 size(QNetworkDiskCache::expire());
+
+	if (!m_isIndexValid)
+	{
+		return size;
+	}
+
+	QVector<QUrl> urls;
+	QHash<QUrl, Entry>::iterator iterator(m_entries.begin());
+
+	while (iterator != m_entries.end())
+	{
+		if (iterator.value().path.isEmpty())
 		{
-			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files(cacheFilesDirectory.entryList(QDir::Files));
+			m_entries.clear();
 
-			entries.reserve(entries.count() + files.count());
+			m_isIndexValid = false;
 
-			for (int k = 0; k < files.count(); ++k)
-			{
-				const QNetworkCacheMetaData metaData(fileMetaData(cacheFilesDirectory.absoluteFilePath(files.at(k))));
+			scheduleSave();
 
-				if (metaData.url().isValid())
-				{
-					entries.append(metaData.url());
-				}
-			}
+			return size;
+		}
+
+		if (QFile::exists(iterator.value().path))
+		{
+			++iterator;
+		}
+		else
+		{
+			urls.append(iterator.key());
+
+			iterator = m_entries.erase(iterator);
 		}
 	}
 
-	entries.squeeze();
+	if (!urls.isEmpty())
+	{
+		scheduleSave();
+	}
 
-	return entries;
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		emit entryRemoved(urls.at(i));
+	}
+
+	return size;
 }
 
 bool NetworkCache::remove(const QUrl &url)
 {
 	const bool result(QNetworkDiskCache::remove(url));
 
+	if (m_entries.remove(url) > 0)
+	{
+		scheduleSave();
+	}
+
 	if (result)
 	{
 		emit entryRemoved(url);
@@ -30,20 +30,62 @@ class NetworkCache final : public QNetworkDiskCache
 	Q_OBJECT
 
 public:
+	struct Entry final
+	{
+		QUrl url;
+		QString path;
+		QString contentType;
+		QDateTime lastModified;
+		QDateTime expirationDate;
+		QDateTime timeStored;
+		qint64 size = 0;
+
+		bool isValid() const
+		{
+			return url.isValid();
+		}
+	};
+
 	explicit NetworkCache(QObject *parent = nullptr);
+	~NetworkCache();
 
 	void clearCache(int period = 0);
 	void insert(QIODevice *device) override;
+	void updateMetaData(const QNetworkCacheMetaData &metaData) override;
 	QIODevice* prepare(const QNetworkCacheMetaData &metaData) override;
 	QString getPathForUrl(const QUrl &url);
-	QVector<QUrl> getEntries() const;
+	Entry getEntry(const QUrl &url);
+	QVector<Entry> getEntries();
 	bool remove(const QUrl &url) override;
 
+public slots:
+	void clear() override;
+
+protected:
+	enum IndexFormat : quint32
+	{
+		IndexMagic = 0x4F4E4349,
+		IndexVersion = 1
+	};
+
+	void timerEvent(QTimerEvent *event) override;
+	void loadIndex();
+	void saveIndex();
+	void rebuildIndex();
+	void updateEntry(Entry &entry, const QNetworkCacheMetaData &metaData) const;
+	QString getIndexPath() const;
+	QString getFileName(const QUrl &url) const;
+	qint64 expire() override;
+
 protected slots:
+	void scheduleSave();
 	void handleOptionChanged(int identifier, const QVariant &value);
 
 private:
-	QHash<QIODevice*, QUrl> m_devices;
+	QHash<QIODevice*, QNetworkCacheMetaData> m_devices;
+	QHash<QUrl, Entry> m_entries;
+	int m_saveTimer;
+	bool m_isIndexValid;
 
 signals:
 	void cleared();
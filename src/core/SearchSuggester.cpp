@@ -22,70 +22,208 @@
 #include "NetworkManager.h"
 #include "NetworkManagerFactory.h"
 #include "SearchEnginesManager.h"
+#include "SettingsManager.h"
 
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimerEvent>
 
 namespace Otter
 {
 
+QCache<QString, QVector<SearchSuggester::SearchSuggestion> > SearchSuggester::m_cache(MaximumCachedQueriesAmount);
+QHash<QString, SearchSuggester::PendingRequest> SearchSuggester::m_pendingRequests;
+SearchSuggester::CacheStatistics SearchSuggester::m_cacheStatistics;
+
 SearchSuggester::SearchSuggester(const QString &searchEngine, QObject *parent) : QObject(parent),
-	m_networkReply(nullptr),
 	m_model(nullptr),
-	m_searchEngine(searchEngine)
+	m_searchEngine(searchEngine),
+	m_requestTimer(0)
 {
+	connect(SearchEnginesManager::getInstance(), &SearchEnginesManager::searchEnginesModified, this, []()
+	{
+		m_cache.clear();
+	});
 }
 
-void SearchSuggester::handleReplyFinished()
+SearchSuggester::~SearchSuggester()
+{
+	detachRequest();
+}
+
+void SearchSuggester::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_requestTimer)
+	{
+		killTimer(m_requestTimer);
+
+		m_requestTimer = 0;
+
+		requestSuggestions();
+	}
+}
+
+void SearchSuggester::requestSuggestions()
 {
-	if (!m_networkReply)
+	const QString key(createKey(m_searchEngine, m_query));
+
+	if (m_cache.contains(key))
 	{
+		setSuggestions(*m_cache.object(key));
+
 		return;
 	}
 
-	if (m_model)
+	if (m_pendingRequests.contains(key))
 	{
-		m_model->clear();
+		++m_cacheStatistics.coalescedRequests;
+
+		attachRequest(key);
+
+		return;
 	}
 
-	m_networkReply->deleteLater();
+	const SearchEnginesManager::SearchEngineDefinition searchEngine(SearchEnginesManager::getSearchEngine(m_searchEngine));
+
+	if (!searchEngine.isValid() || searchEngine.suggestionsUrl.url.isEmpty())
+	{
+		return;
+	}
+
+	QNetworkRequest request;
+	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+
+	QNetworkAccessManager::Operation method;
+	QByteArray body;
+	QNetworkReply *reply(nullptr);
+
+	SearchEnginesManager::setupQuery(m_query, searchEngine.suggestionsUrl, &request, &method, &body);
 
-	if (m_networkReply->size() <= 0)
+	if (method == QNetworkAccessManager::PostOperation)
+	{
+		reply = NetworkManagerFactory::getNetworkManager()->post(request, body);
+	}
+	else
 	{
-		m_networkReply = nullptr;
+		reply = NetworkManagerFactory::getNetworkManager()->get(request);
+	}
 
+	++m_cacheStatistics.networkRequests;
+
+	const QString query(m_query);
+
+	m_pendingRequests[key].reply = reply;
+
+	connect(reply, &QNetworkReply::finished, reply, [=]()
+	{
+		handleReply(key, query, reply);
+	});
+
+	attachRequest(key);
+}
+
+void SearchSuggester::attachRequest(const QString &key)
+{
+	PendingRequest &request(m_pendingRequests[key]);
+
+	++request.waitersAmount;
+
+	m_pendingKey = key;
+
+	connect(request.reply.data(), &QNetworkReply::finished, this, &SearchSuggester::handleReplyFinished);
+}
+
+void SearchSuggester::detachRequest()
+{
+	if (m_pendingKey.isEmpty())
+	{
 		return;
 	}
 
-	const QJsonDocument document(QJsonDocument::fromJson(m_networkReply->readAll()));
+	const QString key(m_pendingKey);
+
+	m_pendingKey.clear();
 
-	if (!document.isEmpty() && document.isArray() && document.array().count() > 1 && document.array().at(0).toString() == m_query)
+	if (!m_pendingRequests.contains(key))
 	{
-		const QJsonArray completionsArray(document.array().at(1).toArray());
-		const QJsonArray descriptionsArray(document.array().at(2).toArray());
-		const QJsonArray urlsArray(document.array().at(3).toArray());
+		return;
+	}
 
-		m_suggestions.reserve(completionsArray.count());
+	PendingRequest &request(m_pendingRequests[key]);
+	QNetworkReply *reply(request.reply.data());
 
-		for (int i = 0; i < completionsArray.count(); ++i)
-		{
-			SearchSuggestion suggestion;
-			suggestion.completion = completionsArray.at(i).toString();
-			suggestion.description = descriptionsArray.at(i).toString();
-			suggestion.url = urlsArray.at(i).toString();
+	--request.waitersAmount;
 
-			m_suggestions.append(suggestion);
+	if (!reply)
+	{
+		m_pendingRequests.remove(key);
 
-			if (m_model)
-			{
-				m_model->appendRow(new QStandardItem(suggestion.completion));
-			}
-		}
+		return;
+	}
+
+	disconnect(reply, &QNetworkReply::finished, this, &SearchSuggester::handleReplyFinished);
 
-		emit suggestionsChanged(m_suggestions);
+	if (request.waitersAmount <= 0)
+	{
+		m_pendingRequests.remove(key);
+
+		reply->abort();
+		reply->deleteLater();
 	}
+}
+
+void SearchSuggester::handleReply(const QString &key, const QString &query, QNetworkReply *reply)
+{
+	m_pendingRequests.remove(key);
 
-	m_networkReply = nullptr;
+	reply->deleteLater();
+
+	if (reply->error() != QNetworkReply::NoError || reply->size() <= 0)
+	{
+		return;
+	}
+
+	const QJsonDocument document(QJsonDocument::fromJson(reply->readAll()));
+
+	if (document.isEmpty() || !document.isArray() || document.array().count() <= 1 || document.array().at(0).toString() != query)
+	{
+		return;
+	}
+
+	const QJsonArray completionsArray(document.array().at(1).toArray());
+	const QJsonArray descriptionsArray(document.array().at(2).toArray());
+	const QJsonArray urlsArray(document.array().at(3).toArray());
+	QVector<SearchSuggestion> *suggestions(new QVector<SearchSuggestion>());
+	suggestions->reserve(completionsArray.count());
+
+	for (int i = 0; i < completionsArray.count(); ++i)
+	{
+		SearchSuggestion suggestion;
+		suggestion.completion = completionsArray.at(i).toString();
+		suggestion.description = descriptionsArray.at(i).toString();
+		suggestion.url = urlsArray.at(i).toString();
+
+		suggestions->append(suggestion);
+	}
+
+	m_cache.insert(key, suggestions);
+}
+
+void SearchSuggester::handleReplyFinished()
+{
+	const QString key(m_pendingKey);
+
+	m_pendingKey.clear();
+
+	if (m_cache.contains(key))
+	{
+		setSuggestions(*m_cache.object(key));
+	}
+	else
+	{
+		setSuggestions({});
+	}
 }
 
 void SearchSuggester::setSearchEngine(const QString &searchEngine)
@@ -108,38 +246,102 @@ void SearchSuggester::setQuery(const QString &query)
 	m_query = query;
 	m_suggestions.clear();
 
-	if (m_networkReply)
+	detachRequest();
+
+	if (m_requestTimer != 0)
 	{
-		m_networkReply->abort();
-		m_networkReply->deleteLater();
-		m_networkReply = nullptr;
+		killTimer(m_requestTimer);
+
+		m_requestTimer = 0;
 	}
 
-	const SearchEnginesManager::SearchEngineDefinition searchEngine(SearchEnginesManager::getSearchEngine(m_searchEngine));
+	const QString key(createKey(m_searchEngine, query));
 
-	if (!searchEngine.isValid() || searchEngine.suggestionsUrl.url.isEmpty())
+	if (m_cache.contains(key))
 	{
+		++m_cacheStatistics.hits;
+
+		setSuggestions(*m_cache.object(key));
+
 		return;
 	}
 
-	QNetworkRequest request;
-	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+	bool hasPrefix(false);
 
-	QNetworkAccessManager::Operation method;
-	QByteArray body;
+	for (int i = (query.length() - 1); i > 0; --i)
+	{
+		const QVector<SearchSuggestion> *cachedSuggestions(m_cache.object(createKey(m_searchEngine, query.left(i))));
 
-	SearchEnginesManager::setupQuery(query, searchEngine.suggestionsUrl, &request, &method, &body);
+		if (cachedSuggestions)
+		{
+			QVector<SearchSuggestion> suggestions;
 
-	if (method == QNetworkAccessManager::PostOperation)
+			for (int j = 0; j < cachedSuggestions->count(); ++j)
+			{
+				if (cachedSuggestions->at(j).completion.startsWith(query, Qt::CaseInsensitive))
+				{
+					suggestions.append(cachedSuggestions->at(j));
+				}
+			}
+
+			hasPrefix = true;
+
+			setSuggestions(suggestions);
+
+			break;
+		}
+	}
+
+	if (hasPrefix)
+	{
+		++m_cacheStatistics.prefixHits;
+	}
+	else
+	{
+		++m_cacheStatistics.misses;
+	}
+
+	if (m_pendingRequests.contains(key))
+	{
+		++m_cacheStatistics.coalescedRequests;
+
+		attachRequest(key);
+
+		return;
+	}
+
+	const int delay(SettingsManager::getOption(SettingsManager::Search_SearchEnginesSuggestionsDelayOption).toInt());
+
+	if (delay > 0)
 	{
-		m_networkReply = NetworkManagerFactory::getNetworkManager()->post(request, body);
+		m_requestTimer = startTimer(delay);
 	}
 	else
 	{
-		m_networkReply = NetworkManagerFactory::getNetworkManager()->get(request);
+		requestSuggestions();
 	}
+}
+
+void SearchSuggester::setSuggestions(const QVector<SearchSuggestion> &suggestions)
+{
+	m_suggestions = suggestions;
 
-	connect(m_networkReply, &QNetworkReply::finished, this, &SearchSuggester::handleReplyFinished);
+	if (m_model)
+	{
+		m_model->clear();
+
+		for (int i = 0; i < m_suggestions.count(); ++i)
+		{
+			m_model->appendRow(new QStandardItem(m_suggestions.at(i).completion));
+		}
+	}
+
+	emit suggestionsChanged(m_suggestions);
+}
+
+QString SearchSuggester::createKey(const QString &searchEngine, const QString &query)
+{
+	return (searchEngine + QLatin1Char('\n') + query);
 }
 
 QStandardItemModel* SearchSuggester::getModel()
@@ -162,4 +364,32 @@ QVector<SearchSuggester::SearchSuggestion> SearchSuggester::getSuggestions() con
 	return m_suggestions;
 }
 
+QString SearchSuggester::createReport()
+{
+	const QVector<QPair<QString, quint64> > counters({{QLatin1String("Hits"), m_cacheStatistics.hits}, {QLatin1String("Prefix Hits"), m_cacheStatistics.prefixHits}, {QLatin1String("Misses"), m_cacheStatistics.misses}, {QLatin1String("Coalesced Requests"), m_cacheStatistics.coalescedRequests}, {QLatin1String("Network Requests"), m_cacheStatistics.networkRequests}});
+	QString report;
+	QTextStream stream(&report);
+	stream.setFieldAlignment(QTextStream::AlignLeft);
+	stream << QLatin1String("Search Suggestions Cache:\n");
+
+	for (int i = 0; i < counters.count(); ++i)
+	{
+		stream << QLatin1Char('\t');
+		stream.setFieldWidth(30);
+		stream << counters.at(i).first;
+		stream << counters.at(i).second;
+		stream.setFieldWidth(0);
+		stream << QLatin1Char('\n');
+	}
+
+	stream << QLatin1Char('\n');
+
+	return report;
+}
+
+SearchSuggester::CacheStatistics SearchSuggester::getCacheStatistics()
+{
+	return m_cacheStatistics;
+}
+
 }
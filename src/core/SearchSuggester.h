@@ -21,7 +21,9 @@
 #ifndef OTTER_SEARCHSUGGESTER_H
 #define OTTER_SEARCHSUGGESTER_H
 
+#include <QtCore/QCache>
 #include <QtCore/QObject>
+#include <QtCore/QPointer>
 #include <QtGui/QStandardItemModel>
 #include <QtNetwork/QNetworkReply>
 
@@ -40,24 +42,61 @@ public:
 		QString url;
 	};
 
+	struct CacheStatistics final
+	{
+		quint64 hits = 0;
+		quint64 prefixHits = 0;
+		quint64 misses = 0;
+		quint64 coalescedRequests = 0;
+		quint64 networkRequests = 0;
+	};
+
 	explicit SearchSuggester(const QString &searchEngine, QObject *parent = nullptr);
+	~SearchSuggester();
 
 	QStandardItemModel* getModel();
 	QVector<SearchSuggestion> getSuggestions() const;
+	static QString createReport();
+	static CacheStatistics getCacheStatistics();
 
 public slots:
 	void setSearchEngine(const QString &searchEngine);
 	void setQuery(const QString &query);
 
+protected:
+	enum CacheLimit
+	{
+		MaximumCachedQueriesAmount = 100
+	};
+
+	struct PendingRequest final
+	{
+		QPointer<QNetworkReply> reply;
+		int waitersAmount = 0;
+	};
+
+	void timerEvent(QTimerEvent *event) override;
+	void requestSuggestions();
+	void attachRequest(const QString &key);
+	void detachRequest();
+	void setSuggestions(const QVector<SearchSuggestion> &suggestions);
+	static void handleReply(const QString &key, const QString &query, QNetworkReply *reply);
+	static QString createKey(const QString &searchEngine, const QString &query);
+
 protected slots:
 	void handleReplyFinished();
 
 private:
-	QNetworkReply *m_networkReply;
 	QStandardItemModel *m_model;
 	QString m_searchEngine;
 	QString m_query;
+	QString m_pendingKey;
 	QVector<SearchSuggestion> m_suggestions;
+	int m_requestTimer;
+
+	static QCache<QString, QVector<SearchSuggestion> > m_cache;
+	static QHash<QString, PendingRequest> m_pendingRequests;
+	static CacheStatistics m_cacheStatistics;
 
 signals:
 	void suggestionsChanged(const QVector<SearchSuggester::SearchSuggestion> &suggestions);
@@ -36,10 +36,14 @@ SettingsManager* SettingsManager::m_instance(nullptr);
 QString SettingsManager::m_globalPath;
 QString SettingsManager::m_overridePath;
 QVector<SettingsManager::OptionDefinition> SettingsManager::m_definitions;
+QVector<QVariant> SettingsManager::m_options;
+QHash<QString, QHash<int, QVariant> > SettingsManager::m_overrides;
+QHash<QString, QHash<int, QVariant> > SettingsManager::m_wildcardedOverrides;
 QHash<QString, int> SettingsManager::m_customOptions;
+QReadWriteLock SettingsManager::m_optionsLock;
 int SettingsManager::m_identifierCounter(-1);
 int SettingsManager::m_optionIdentifierEnumerator(0);
-bool SettingsManager::m_hasWildcardedOverrides(false);
+bool SettingsManager::m_areOptionsLoaded(false);
 
 SettingsManager::SettingsManager(QObject *parent) : QObject(parent)
 {
@@ -97,6 +101,7 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Browser_ShowSelectionContextMenuOnDoubleClickOption, BooleanType, false);
 	registerOption(Browser_SpellCheckDictionaryOption, StringType, QString());
 	registerOption(Browser_StartupBehaviorOption, EnumerationType, QLatin1String("continuePrevious"), {QLatin1String("continuePrevious"), QLatin1String("showDialog"), QLatin1String("startHomePage"), QLatin1String("startStartPage"), QLatin1String("startEmpty")});
+	registerOption(Browser_TabsMemoryLimitOption, IntegerType, 0);
 	registerOption(Browser_ToolTipsModeOption, EnumerationType, QLatin1String("extended"), {QLatin1String("disabled"), QLatin1String("standard"), QLatin1String("extended")});
 	registerOption(Browser_TransferStartingActionOption, EnumerationType, QLatin1String("doNothing"), {QLatin1String("openTab"), QLatin1String("openBackgroundTab"), QLatin1String("openPanel"), QLatin1String("doNothing")});
 	registerOption(Browser_ValidatorsOrderOption, ListType, QStringList({QLatin1String("w3c-markup"), QLatin1String("w3c-css")}));
@@ -163,11 +168,19 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Network_CookiesPolicyOption, EnumerationType, QLatin1String("acceptAll"), {QLatin1String("acceptAll"), QLatin1String("acceptExisting"), QLatin1String("readOnly"), QLatin1String("ignore")});
 	registerOption(Network_DoNotTrackPolicyOption, EnumerationType, QLatin1String("skip"), {QLatin1String("skip"), QLatin1String("allow"), QLatin1String("doNotAllow")});
 	registerOption(Network_EnableDnsPrefetchOption, BooleanType, true);
+	registerOption(Network_EnableHttp2Option, BooleanType, false);
 	registerOption(Network_EnableReferrerOption, BooleanType, true);
+	registerOption(Network_MaximumConnectionsPerHostOption, IntegerType, 6);
+	registerOption(Network_MaximumTransferSegmentsOption, IntegerType, 4);
+	registerOption(Network_MaximumTransfersOption, IntegerType, 5);
+	registerOption(Network_MaximumTransfersPerHostOption, IntegerType, 2);
+	registerOption(Network_ProxyAutoConfigCacheTimeOption, IntegerType, 300);
 	registerOption(Network_ProxyOption, EnumerationType, QLatin1String("system"), {QLatin1String("system")});
 	registerOption(Network_ThirdPartyCookiesAcceptedHostsOption, ListType, QStringList());
 	registerOption(Network_ThirdPartyCookiesPolicyOption, EnumerationType, QLatin1String("acceptAll"), QStringList({QLatin1String("acceptAll"), QLatin1String("acceptExisting"), QLatin1String("ignore")}));
 	registerOption(Network_ThirdPartyCookiesRejectedHostsOption, ListType, QStringList());
+	registerOption(Network_TransferSpeedLimitOption, IntegerType, 0);
+	registerOption(Network_TransferTimeWindowOption, StringType, QString());
 	registerOption(Network_UserAgentOption, EnumerationType, QLatin1String("default"), QStringList(QLatin1String("default")));
 	registerOption(Network_WorkOfflineOption, BooleanType, false);
 	registerOption(Paths_DownloadsOption, PathType, QStandardPaths::writableLocation(QStandardPaths::DownloadLocation));
@@ -200,6 +213,7 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Search_EnableFindInPageHighlightAllOption, BooleanType, false);
 	registerOption(Search_ReuseLastQuickFindQueryOption, BooleanType, false);
 	registerOption(Search_SearchEnginesOrderOption, ListType, QStringList({QLatin1String("duckduckgo"), QLatin1String("wikipedia"), QLatin1String("startpage"), QLatin1String("google"), QLatin1String("yahoo"), QLatin1String("bing"), QLatin1String("youtube")}));
+	registerOption(Search_SearchEnginesSuggestionsDelayOption, IntegerType, 150);
 	registerOption(Search_SearchEnginesSuggestionsOption, BooleanType, false);
 	registerOption(Security_AllowMixedContentOption, BooleanType, false);
 	registerOption(Security_CiphersOption, ListType, QStringList(QLatin1String("default")));
@@ -243,18 +257,6 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Updates_CheckIntervalOption, IntegerType, 7);
 	registerOption(Updates_LastCheckOption, StringType, QString());
 	registerOption(Updates_ServerUrlOption, StringType, QLatin1String("https://www.otter-browser.org/updates/update.json"));
-
-	const QStringList hosts(getOverrideHosts());
-
-	for (int i = 0; i < hosts.count(); ++i)
-	{
-		if (hosts.at(i).startsWith(QLatin1Char('*')))
-		{
-			m_hasWildcardedOverrides = true;
-
-			break;
-		}
-	}
 }
 
 void SettingsManager::removeOverride(const QString &host, int identifier)
@@ -267,6 +269,8 @@ void SettingsManager::removeOverride(const QString &host, int identifier)
 	{
 		QSettings(m_overridePath, QSettings::IniFormat).remove(host + QLatin1Char('/') + getOptionName(identifier));
 	}
+
+	invalidateOptions();
 }
 
 void SettingsManager::registerOption(int identifier, OptionType type, const QVariant &defaultValue, const QStringList &choices, OptionDefinition::OptionFlags flags)
@@ -279,6 +283,8 @@ void SettingsManager::registerOption(int identifier, OptionType type, const QVar
 	definition.identifier = identifier;
 
 	m_definitions.append(definition);
+
+	invalidateOptions();
 }
 
 void SettingsManager::saveOption(const QString &path, const QString &key, const QVariant &value, OptionType type)
@@ -299,12 +305,83 @@ void SettingsManager::saveOption(const QString &path, const QString &key, const
 	}
 }
 
+void SettingsManager::loadOptions()
+{
+	QWriteLocker locker(&m_optionsLock);
+
+	if (m_areOptionsLoaded)
+	{
+		return;
+	}
+
+	const QSettings settings(m_globalPath, QSettings::IniFormat);
+
+	m_options.resize(m_definitions.count());
+
+	for (int i = 0; i < m_definitions.count(); ++i)
+	{
+		m_options[i] = settings.value(getOptionName(i), m_definitions.at(i).defaultValue);
+	}
+
+	m_overrides.clear();
+	m_wildcardedOverrides.clear();
+
+	QSettings overrides(m_overridePath, QSettings::IniFormat);
+	const QStringList hosts(overrides.childGroups());
+
+	for (int i = 0; i < hosts.count(); ++i)
+	{
+		const QString host(hosts.at(i));
+
+		overrides.beginGroup(host);
+
+		const QStringList keys(overrides.allKeys());
+		QHash<int, QVariant> values;
+		values.reserve(keys.count());
+
+		for (int j = 0; j < keys.count(); ++j)
+		{
+			const int identifier(getOptionIdentifier(keys.at(j)));
+
+			if (identifier >= 0 && identifier < m_definitions.count())
+			{
+				values[identifier] = overrides.value(keys.at(j));
+			}
+		}
+
+		overrides.endGroup();
+
+		if (values.isEmpty())
+		{
+			continue;
+		}
+
+		m_overrides[host] = values;
+
+		if (host.startsWith(QLatin1String("*.")))
+		{
+			m_wildcardedOverrides[host.mid(2)] = values;
+		}
+	}
+
+	m_areOptionsLoaded = true;
+}
+
+void SettingsManager::invalidateOptions()
+{
+	QWriteLocker locker(&m_optionsLock);
+
+	m_areOptionsLoaded = false;
+}
+
 void SettingsManager::updateOptionDefinition(int identifier, const SettingsManager::OptionDefinition &definition)
 {
 	if (identifier >= 0 && identifier < m_definitions.count())
 	{
 		m_definitions[identifier].defaultValue = definition.defaultValue;
 		m_definitions[identifier].choices = definition.choices;
+
+		invalidateOptions();
 	}
 }
 
@@ -326,10 +403,7 @@ void SettingsManager::setOption(int identifier, const QVariant &value, const QSt
 			saveOption(m_overridePath, overrideName, value, type);
 		}
 
-		if (!m_hasWildcardedOverrides && overrideName.startsWith(QLatin1Char('*')))
-		{
-			m_hasWildcardedOverrides = true;
-		}
+		invalidateOptions();
 
 		emit m_instance->hostOptionChanged(identifier, value, host);
 
@@ -339,6 +413,7 @@ void SettingsManager::setOption(int identifier, const QVariant &value, const QSt
 	if (getOption(identifier) != value)
 	{
 		saveOption(m_globalPath, name, value, type);
+		invalidateOptions();
 
 		emit m_instance->optionChanged(identifier, value);
 	}
@@ -489,32 +564,45 @@ QVariant SettingsManager::getOption(int identifier, const QString &host)
 		return {};
 	}
 
-	const QString name(getOptionName(identifier));
+	QReadLocker locker(&m_optionsLock);
 
-	if (host.isEmpty())
+	while (!m_areOptionsLoaded)
 	{
-		return QSettings(m_globalPath, QSettings::IniFormat).value(name, m_definitions.at(identifier).defaultValue);
-	}
+		locker.unlock();
 
-	const QString overrideName(host + QLatin1Char('/') + name);
-	const QSettings overrides(m_overridePath, QSettings::IniFormat);
+		loadOptions();
+
+		locker.relock();
+	}
 
-	if (m_hasWildcardedOverrides && !overrides.contains(overrideName))
+	if (!host.isEmpty())
 	{
-		const QStringList hostParts(host.split(QLatin1Char('.')));
+		const QHash<QString, QHash<int, QVariant> >::const_iterator iterator(m_overrides.constFind(host));
 
-		for (int i = 1; i < hostParts.count(); ++i)
+		if (iterator != m_overrides.constEnd() && iterator.value().contains(identifier))
 		{
-			const QString wildcardedName(QLatin1String("*.") + QStringList(hostParts.mid(i)).join(QLatin1Char('.')) + QLatin1Char('/') + name);
+			return iterator.value().value(identifier);
+		}
 
-			if (overrides.contains(wildcardedName))
+		if (!m_wildcardedOverrides.isEmpty())
+		{
+			int position(host.indexOf(QLatin1Char('.')));
+
+			while (position >= 0)
 			{
-				return QSettings(m_overridePath, QSettings::IniFormat).value(wildcardedName, getOption(identifier));
+				const QHash<QString, QHash<int, QVariant> >::const_iterator wildcardedIterator(m_wildcardedOverrides.constFind(host.mid(position + 1)));
+
+				if (wildcardedIterator != m_wildcardedOverrides.constEnd() && wildcardedIterator.value().contains(identifier))
+				{
+					return wildcardedIterator.value().value(identifier);
+				}
+
+				position = host.indexOf(QLatin1Char('.'), (position + 1));
 			}
 		}
 	}
 
-	return QSettings(m_overridePath, QSettings::IniFormat).value(overrideName, getOption(identifier));
+	return m_options.value(identifier, m_definitions.at(identifier).defaultValue);
 }
 
 QStringList SettingsManager::getOptions()
@@ -587,6 +675,8 @@ int SettingsManager::registerOption(const QString &name, OptionType type, const
 
 	m_definitions.append(definition);
 
+	invalidateOptions();
+
 	return identifier;
 }
 
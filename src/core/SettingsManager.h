@@ -23,6 +23,7 @@
 #define OTTER_SETTINGSMANAGER_H
 
 #include <QtCore/QObject>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QVariant>
 #include <QtGui/QIcon>
 
@@ -73,6 +74,7 @@ public:
 		Browser_ShowSelectionContextMenuOnDoubleClickOption,
 		Browser_SpellCheckDictionaryOption,
 		Browser_StartupBehaviorOption,
+		Browser_TabsMemoryLimitOption,
 		Browser_ToolTipsModeOption,
 		Browser_TransferStartingActionOption,
 		Browser_ValidatorsOrderOption,
@@ -139,11 +141,19 @@ public:
 		Network_CookiesPolicyOption,
 		Network_DoNotTrackPolicyOption,
 		Network_EnableDnsPrefetchOption,
+		Network_EnableHttp2Option,
 		Network_EnableReferrerOption,
+		Network_MaximumConnectionsPerHostOption,
+		Network_MaximumTransferSegmentsOption,
+		Network_MaximumTransfersOption,
+		Network_MaximumTransfersPerHostOption,
+		Network_ProxyAutoConfigCacheTimeOption,
 		Network_ProxyOption,
 		Network_ThirdPartyCookiesAcceptedHostsOption,
 		Network_ThirdPartyCookiesPolicyOption,
 		Network_ThirdPartyCookiesRejectedHostsOption,
+		Network_TransferSpeedLimitOption,
+		Network_TransferTimeWindowOption,
 		Network_UserAgentOption,
 		Network_WorkOfflineOption,
 		Paths_DownloadsOption,
@@ -176,6 +186,7 @@ public:
 		Search_EnableFindInPageHighlightAllOption,
 		Search_ReuseLastQuickFindQueryOption,
 		Search_SearchEnginesOrderOption,
+		Search_SearchEnginesSuggestionsDelayOption,
 		Search_SearchEnginesSuggestionsOption,
 		Security_AllowMixedContentOption,
 		Security_CiphersOption,
@@ -323,16 +334,22 @@ protected:
 
 	static void registerOption(int identifier, OptionType type, const QVariant &defaultValue = {}, const QStringList &choices = {}, OptionDefinition::OptionFlags flags = static_cast<OptionDefinition::OptionFlags>(OptionDefinition::IsEnabledFlag |OptionDefinition:: IsVisibleFlag | OptionDefinition::IsBuiltInFlag));
 	static void saveOption(const QString &path, const QString &key, const QVariant &value, OptionType type);
+	static void loadOptions();
+	static void invalidateOptions();
 
 private:
 	static SettingsManager *m_instance;
 	static QString m_globalPath;
 	static QString m_overridePath;
 	static QVector<OptionDefinition> m_definitions;
+	static QVector<QVariant> m_options;
+	static QHash<QString, QHash<int, QVariant> > m_overrides;
+	static QHash<QString, QHash<int, QVariant> > m_wildcardedOverrides;
 	static QHash<QString, int> m_customOptions;
+	static QReadWriteLock m_optionsLock;
 	static int m_identifierCounter;
 	static int m_optionIdentifierEnumerator;
-	static bool m_hasWildcardedOverrides;
+	static bool m_areOptionsLoaded;
 
 signals:
 	void optionChanged(int identifier, const QVariant &value);
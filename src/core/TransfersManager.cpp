@@ -54,11 +54,17 @@ Transfer::Transfer(TransferOptions options, QObject *parent) : QObject(parent ?
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(0),
 	m_bytesTotal(0),
+	m_hashedBytes(0),
+	m_speedLimit(0),
+	m_effectiveSpeedLimit(0),
+	m_readAllowance(0),
 	m_options(options),
 	m_state(UnknownState),
 	m_updateTimer(0),
 	m_updateInterval(0),
+	m_throttlingTimer(0),
 	m_remainingTime(-1),
+	m_priority(0),
 	m_isSelectingPath(false),
 	m_isArchived(false)
 {
@@ -77,16 +83,70 @@ Transfer::Transfer(const QSettings &settings, QObject *parent) : QObject(parent
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(settings.value(QLatin1String("bytesReceived")).toLongLong()),
 	m_bytesTotal(settings.value(QLatin1String("bytesTotal")).toLongLong()),
+	m_hashedBytes(0),
+	m_speedLimit(0),
+	m_effectiveSpeedLimit(0),
+	m_readAllowance(0),
 	m_options(NoOption),
 	m_state((m_bytesReceived > 0 && m_bytesTotal == m_bytesReceived && QFile::exists(settings.value(QLatin1String("target")).toString())) ? FinishedState : ErrorState),
 	m_updateTimer(0),
 	m_updateInterval(0),
+	m_throttlingTimer(0),
 	m_remainingTime(-1),
+	m_priority(settings.value(QLatin1String("priority")).toInt()),
 	m_isSelectingPath(false),
 	m_isArchived(true)
 {
 	m_timeStarted.setTimeSpec(Qt::UTC);
 	m_timeFinished.setTimeSpec(Qt::UTC);
+
+	if (m_state != ErrorState)
+	{
+		return;
+	}
+
+	if (settings.value(QLatin1String("isQueued")).toBool())
+	{
+		QNetworkRequest request;
+		request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+		request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+		request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+		request.setUrl(m_source);
+
+		queue(request, m_target);
+
+		m_isArchived = false;
+
+		return;
+	}
+
+	const QStringList segments(settings.value(QLatin1String("segments")).toStringList());
+
+	for (int i = 0; i < segments.count(); ++i)
+	{
+		const QStringList values(segments.at(i).split(QLatin1Char('-')));
+
+		if (values.count() != 3)
+		{
+			m_segments.clear();
+
+			return;
+		}
+
+		Segment segment;
+		segment.start = values.at(0).toLongLong();
+		segment.position = values.at(1).toLongLong();
+		segment.end = values.at(2).toLongLong();
+
+		if (segment.start < 0 || segment.position < segment.start || segment.position > segment.end || segment.end > m_bytesTotal)
+		{
+			m_segments.clear();
+
+			return;
+		}
+
+		m_segments.append(segment);
+	}
 }
 
 Transfer::~Transfer()
@@ -95,6 +155,8 @@ Transfer::~Transfer()
 	{
 		QFile::remove(m_target);
 	}
+
+	qDeleteAll(m_hashStates);
 }
 
 void Transfer::timerEvent(QTimerEvent *event)
@@ -132,6 +194,12 @@ void Transfer::timerEvent(QTimerEvent *event)
 			emit changed();
 		}
 	}
+	else if (event->timerId() == m_throttlingTimer)
+	{
+		m_readAllowance = ((m_effectiveSpeedLimit * ThrottlingInterval) / 1000);
+
+		readPendingData();
+	}
 }
 
 void Transfer::start(QNetworkReply *reply, const QString &target)
@@ -177,7 +245,7 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 	m_timeStarted = QDateTime::currentDateTimeUtc();
 	m_bytesTotal = m_reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
 
-	if (m_bytesTotal == 0 && reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool() && reply->manager()->cache())
+	if (m_bytesTotal == 0 && reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool() && reply->manager() && reply->manager()->cache())
 	{
 		QIODevice *device(reply->manager()->cache()->data(m_source));
 
@@ -322,6 +390,407 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 	}
 }
 
+bool Transfer::queue(const QNetworkRequest &request, const QString &target)
+{
+	m_request = request;
+	m_source = request.url().adjusted(QUrl::RemovePassword | QUrl::PreferLocalFile);
+	m_state = QueuedState;
+
+	if (!target.isEmpty())
+	{
+		m_target = QFileInfo(QDir::toNativeSeparators(target)).absoluteFilePath();
+
+		return true;
+	}
+
+	if (!SettingsManager::getOption(SettingsManager::Browser_AlwaysAskWhereToSaveDownloadOption).toBool())
+	{
+		m_options |= IsQuickTransferOption;
+	}
+
+	if (!m_options.testFlag(IsQuickTransferOption) && !m_options.testFlag(CanAskForPathOption))
+	{
+		return true;
+	}
+
+	const QString directory(m_options.testFlag(IsQuickTransferOption) ? Utils::normalizePath(SettingsManager::getOption(SettingsManager::Paths_DownloadsOption).toString()) : QString());
+	const QString fileName(m_source.fileName().isEmpty() ? tr("file") : m_source.fileName());
+
+	if (m_options.testFlag(IsQuickTransferOption) && !m_options.testFlag(CanAskForPathOption))
+	{
+		const QString path(directory + QDir::separator() + fileName);
+
+		if (!QFile::exists(path))
+		{
+			m_target = QDir::toNativeSeparators(path);
+
+			return true;
+		}
+	}
+
+	m_isSelectingPath = true;
+
+	const SaveInformation information(Utils::getSavePath(fileName, directory));
+
+	m_isSelectingPath = false;
+
+	if (!information.canSave)
+	{
+		m_state = CancelledState;
+
+		return false;
+	}
+
+	m_target = QDir::toNativeSeparators(information.path);
+	m_options |= CanOverwriteOption;
+
+	return true;
+}
+
+void Transfer::setEffectiveSpeedLimit(qint64 limit)
+{
+	if (limit == m_effectiveSpeedLimit)
+	{
+		return;
+	}
+
+	m_effectiveSpeedLimit = limit;
+
+	const qint64 readBufferSize(getReadBufferSize());
+
+	if (m_reply)
+	{
+		m_reply->setReadBufferSize(readBufferSize);
+	}
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		if (m_segments.at(i).reply && m_segments.at(i).reply != m_reply)
+		{
+			m_segments.at(i).reply->setReadBufferSize(readBufferSize);
+		}
+	}
+
+	if (limit > 0)
+	{
+		if (m_throttlingTimer == 0 && m_state == RunningState)
+		{
+			m_throttlingTimer = startTimer(ThrottlingInterval);
+		}
+	}
+	else if (m_throttlingTimer != 0)
+	{
+		killTimer(m_throttlingTimer);
+
+		m_throttlingTimer = 0;
+
+		readPendingData();
+	}
+}
+
+void Transfer::readPendingData()
+{
+	if (m_state != RunningState)
+	{
+		return;
+	}
+
+	if (m_segments.isEmpty())
+	{
+		handleDataAvailable();
+
+		return;
+	}
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		QNetworkReply *reply(m_segments.at(i).reply);
+
+		if (!reply)
+		{
+			continue;
+		}
+
+		writeSegment(i);
+
+		if (m_state != RunningState)
+		{
+			return;
+		}
+
+		if (i < m_segments.count() && m_segments.at(i).reply == reply && reply->isFinished() && reply->bytesAvailable() == 0)
+		{
+			retrySegment(i);
+		}
+	}
+}
+
+void Transfer::updateHashes(const QByteArray &data, qint64 position)
+{
+	if (m_hashStates.isEmpty() || m_hashedBytes < 0 || data.isEmpty())
+	{
+		return;
+	}
+
+	if (position == 0 && m_hashedBytes > 0)
+	{
+		QHash<QCryptographicHash::Algorithm, QCryptographicHash*>::iterator iterator;
+
+		for (iterator = m_hashStates.begin(); iterator != m_hashStates.end(); ++iterator)
+		{
+			iterator.value()->reset();
+		}
+
+		m_hashedBytes = 0;
+	}
+
+	if (position < m_hashedBytes || (position > m_hashedBytes && !readHashes(m_hashStates.values().toVector(), m_hashedBytes, position)))
+	{
+		m_hashedBytes = -1;
+
+		return;
+	}
+
+	QHash<QCryptographicHash::Algorithm, QCryptographicHash*>::iterator iterator;
+
+	for (iterator = m_hashStates.begin(); iterator != m_hashStates.end(); ++iterator)
+	{
+		iterator.value()->addData(data);
+	}
+
+	m_hashedBytes = (position + data.size());
+}
+
+void Transfer::finishHashes(qint64 size)
+{
+	if (m_hashStates.isEmpty() || m_hashedBytes < 0 || m_hashedBytes >= size)
+	{
+		return;
+	}
+
+	m_hashedBytes = (readHashes(m_hashStates.values().toVector(), m_hashedBytes, size) ? size : -1);
+}
+
+void Transfer::startSegment(int index)
+{
+	Segment &segment(m_segments[index]);
+	QNetworkRequest request(m_segmentsRequest);
+
+	if (request.url().isEmpty())
+	{
+		request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+		request.setUrl(m_source);
+	}
+
+	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+	request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+	request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+	request.setRawHeader(QByteArrayLiteral("Range"), QStringLiteral("bytes=%1-%2").arg(segment.position).arg(segment.end - 1).toLatin1());
+
+	segment.reply = (m_segmentsManager ? m_segmentsManager.data() : NetworkManagerFactory::getNetworkManager(m_options.testFlag(IsPrivateOption)))->get(request);
+	segment.reply->setReadBufferSize(getReadBufferSize());
+
+	connect(segment.reply, &QNetworkReply::readyRead, this, &Transfer::handleSegmentDataAvailable);
+	connect(segment.reply, &QNetworkReply::finished, this, &Transfer::handleSegmentFinished);
+}
+
+void Transfer::writeSegment(int index)
+{
+	Segment &segment(m_segments[index]);
+
+	if (!segment.reply || !m_device)
+	{
+		return;
+	}
+
+	const QByteArray data(segment.reply->read(takeReadAllowance(qMin((segment.end - segment.position), segment.reply->bytesAvailable()))));
+
+	if (!data.isEmpty())
+	{
+		if (segment.start <= m_hashedBytes)
+		{
+			updateHashes(data, segment.position);
+		}
+
+		m_device->seek(segment.position);
+
+		const qint64 bytesWritten(m_device->write(data));
+
+		if (bytesWritten < 0)
+		{
+			handleDownloadError(QNetworkReply::UnknownContentError);
+
+			return;
+		}
+
+		segment.position += bytesWritten;
+
+		m_bytesReceived += bytesWritten;
+		m_bytesReceivedDifference += bytesWritten;
+
+		emit progressChanged(m_bytesReceived, m_bytesTotal);
+	}
+
+	if (!segment.isFinished())
+	{
+		return;
+	}
+
+	QNetworkReply *reply(segment.reply);
+
+	segment.reply = nullptr;
+
+	disconnect(reply, nullptr, this, nullptr);
+
+	if (!reply->isFinished())
+	{
+		reply->abort();
+	}
+
+	reply->deleteLater();
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		if (!m_segments.at(i).isFinished())
+		{
+			return;
+		}
+	}
+
+	finishSegments();
+}
+
+void Transfer::retrySegment(int index)
+{
+	Segment &segment(m_segments[index]);
+
+	if (segment.reply)
+	{
+		disconnect(segment.reply, nullptr, this, nullptr);
+
+		segment.reply->deleteLater();
+		segment.reply = nullptr;
+	}
+
+	++segment.attempts;
+
+	if (segment.attempts > MaximumSegmentAttempts)
+	{
+		handleDownloadError(QNetworkReply::UnknownNetworkError);
+
+		return;
+	}
+
+	QTimer::singleShot((segment.attempts * 1000), this, [=]()
+	{
+		if (m_state == RunningState && index < m_segments.count() && !m_segments.at(index).reply && !m_segments.at(index).isFinished())
+		{
+			startSegment(index);
+		}
+	});
+}
+
+void Transfer::rejectSegmentRange()
+{
+	QNetworkReply *reply(m_segments.isEmpty() ? nullptr : m_segments.at(0).reply.data());
+
+	if (!reply || reply != m_reply || reply->request().hasRawHeader(QByteArrayLiteral("Range")) || reply->error() != QNetworkReply::NoError)
+	{
+		abortSegments();
+
+		m_segments.clear();
+
+		handleDownloadError(QNetworkReply::ProtocolFailure);
+
+		return;
+	}
+
+	for (int i = 1; i < m_segments.count(); ++i)
+	{
+		QNetworkReply *segmentReply(m_segments.at(i).reply);
+
+		if (segmentReply)
+		{
+			disconnect(segmentReply, nullptr, this, nullptr);
+
+			segmentReply->abort();
+			segmentReply->deleteLater();
+		}
+
+		m_bytesReceived -= (m_segments.at(i).position - m_segments.at(i).start);
+	}
+
+	m_segments.resize(1);
+	m_segments[0].end = m_bytesTotal;
+
+	emit progressChanged(m_bytesReceived, m_bytesTotal);
+}
+
+void Transfer::abortSegments()
+{
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		QNetworkReply *reply(m_segments.at(i).reply);
+
+		if (reply)
+		{
+			disconnect(reply, nullptr, this, nullptr);
+
+			reply->abort();
+			reply->deleteLater();
+
+			m_segments[i].reply = nullptr;
+		}
+	}
+}
+
+void Transfer::finishSegments()
+{
+	if (m_updateTimer != 0)
+	{
+		killTimer(m_updateTimer);
+
+		m_updateTimer = 0;
+	}
+
+	if (m_throttlingTimer != 0)
+	{
+		killTimer(m_throttlingTimer);
+
+		m_throttlingTimer = 0;
+	}
+
+	m_segments.clear();
+
+	finishHashes(m_bytesTotal);
+
+	if (m_device)
+	{
+		m_device->close();
+		m_device->deleteLater();
+		m_device = nullptr;
+	}
+
+	markAsFinished();
+
+	m_bytesReceived = m_bytesTotal;
+	m_state = FinishedState;
+	m_mimeType = QMimeDatabase().mimeTypeForFile(m_target);
+
+	emit finished();
+	emit changed();
+
+	if (m_options.testFlag(HasToOpenAfterFinishOption))
+	{
+		openTarget();
+	}
+
+	if (m_options.testFlag(CanAutoDeleteOption) && !m_isSelectingPath)
+	{
+		deleteLater();
+	}
+}
+
 void Transfer::openTarget() const
 {
 	Utils::runApplication(m_openCommand, QUrl::fromLocalFile(getTarget()));
@@ -331,6 +800,10 @@ void Transfer::cancel()
 {
 	m_state = CancelledState;
 
+	abortSegments();
+
+	m_segments.clear();
+
 	if (m_reply)
 	{
 		m_reply->abort();
@@ -360,6 +833,15 @@ void Transfer::stop()
 		m_updateTimer = 0;
 	}
 
+	if (m_throttlingTimer != 0)
+	{
+		killTimer(m_throttlingTimer);
+
+		m_throttlingTimer = 0;
+	}
+
+	abortSegments();
+
 	if (m_reply)
 	{
 		m_reply->abort();
@@ -374,7 +856,7 @@ void Transfer::stop()
 		m_device = nullptr;
 	}
 
-	if (m_state == RunningState)
+	if (m_state == RunningState || m_state == QueuedState)
 	{
 		m_state = ErrorState;
 
@@ -426,7 +908,11 @@ void Transfer::handleDataAvailable()
 		}
 	}
 
-	m_device->write(m_reply->readAll());
+	const QByteArray data(m_reply->read(takeReadAllowance(m_reply->bytesAvailable())));
+
+	updateHashes(data, m_device->pos());
+
+	m_device->write(data);
 	m_device->seek(m_device->size());
 
 	if (m_state == RunningState && m_reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool() && m_bytesTotal >= 0 && m_device->size() == m_bytesTotal)
@@ -479,9 +965,20 @@ void Transfer::handleDownloadFinished()
 		m_updateTimer = 0;
 	}
 
-	if (m_reply->size() > 0)
+	if (m_throttlingTimer != 0)
+	{
+		killTimer(m_throttlingTimer);
+
+		m_throttlingTimer = 0;
+	}
+
+	if (m_reply->size() > 0 && m_device)
 	{
-		m_device->write(m_reply->readAll());
+		const QByteArray data(m_reply->readAll());
+
+		updateHashes(data, m_device->pos());
+
+		m_device->write(data);
 	}
 
 	disconnect(m_reply, &QNetworkReply::downloadProgress, this, &Transfer::handleDownloadProgress);
@@ -502,6 +999,7 @@ void Transfer::handleDownloadFinished()
 	else
 	{
 		markAsFinished();
+		finishHashes(m_bytesReceived);
 
 		m_state = FinishedState;
 		m_mimeType = QMimeDatabase().mimeTypeForFile(m_target);
@@ -547,6 +1045,51 @@ void Transfer::handleDownloadError(QNetworkReply::NetworkError error)
 	}
 }
 
+void Transfer::handleSegmentDataAvailable()
+{
+	QNetworkReply *reply(qobject_cast<QNetworkReply*>(sender()));
+	const int index(getSegmentIndex(reply));
+
+	if (index < 0)
+	{
+		return;
+	}
+
+	if (reply->request().hasRawHeader(QByteArrayLiteral("Range")) && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206)
+	{
+		rejectSegmentRange();
+
+		return;
+	}
+
+	writeSegment(index);
+}
+
+void Transfer::handleSegmentFinished()
+{
+	QNetworkReply *reply(qobject_cast<QNetworkReply*>(sender()));
+	const int index(getSegmentIndex(reply));
+
+	if (index < 0)
+	{
+		return;
+	}
+
+	if (reply->error() == QNetworkReply::NoError && reply->request().hasRawHeader(QByteArrayLiteral("Range")) && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206)
+	{
+		rejectSegmentRange();
+
+		return;
+	}
+
+	writeSegment(index);
+
+	if (index < m_segments.count() && m_segments.at(index).reply == reply && reply->bytesAvailable() == 0)
+	{
+		retrySegment(index);
+	}
+}
+
 void Transfer::setOpenCommand(const QString &command)
 {
 	m_openCommand = command;
@@ -579,10 +1122,44 @@ void Transfer::setHash(const QByteArray &hash, QCryptographicHash::Algorithm alg
 	if (!hash.isEmpty())
 	{
 		m_hashes[algorithm] = hash;
+
+		if (!m_hashStates.contains(algorithm) && m_state != FinishedState)
+		{
+			QCryptographicHash *state(new QCryptographicHash(algorithm));
+
+			m_hashStates[algorithm] = state;
+
+			if (m_hashedBytes > 0 && !readHashes({state}, 0, m_hashedBytes))
+			{
+				m_hashedBytes = -1;
+			}
+		}
 	}
 	else if (m_hashes.contains(algorithm))
 	{
 		m_hashes.remove(algorithm);
+
+		delete m_hashStates.take(algorithm);
+	}
+}
+
+void Transfer::setPriority(int priority)
+{
+	if (priority != m_priority)
+	{
+		m_priority = priority;
+
+		emit changed();
+	}
+}
+
+void Transfer::setSpeedLimit(qint64 limit)
+{
+	if (limit != m_speedLimit)
+	{
+		m_speedLimit = qMax(static_cast<qint64>(0), limit);
+
+		emit changed();
 	}
 }
 
@@ -701,75 +1278,356 @@ qint64 Transfer::getSpeed() const
 	return m_speed;
 }
 
-qint64 Transfer::getBytesReceived() const
-{
-	return m_bytesReceived;
+qint64 Transfer::getBytesReceived() const
+{
+	return m_bytesReceived;
+}
+
+qint64 Transfer::getBytesTotal() const
+{
+	return m_bytesTotal;
+}
+
+qint64 Transfer::getSpeedLimit() const
+{
+	return m_speedLimit;
+}
+
+Transfer::TransferOptions Transfer::getOptions() const
+{
+	return m_options;
+}
+
+Transfer::TransferState Transfer::getState() const
+{
+	return m_state;
+}
+
+int Transfer::getRemainingTime() const
+{
+	return m_remainingTime;
+}
+
+int Transfer::getPriority() const
+{
+	return m_priority;
+}
+
+bool Transfer::verifyHashes() const
+{
+	if (getState() != FinishedState)
+	{
+		return false;
+	}
+
+	QFile file(getTarget());
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QHash<QCryptographicHash::Algorithm, QByteArray>::const_iterator iterator;
+
+	if (m_hashedBytes >= 0 && m_hashedBytes == file.size())
+	{
+		bool hasAllStates(true);
+
+		for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
+		{
+			const QCryptographicHash *state(m_hashStates.value(iterator.key()));
+
+			if (!state)
+			{
+				hasAllStates = false;
+
+				break;
+			}
+
+			if (state->result() != iterator.value())
+			{
+				return false;
+			}
+		}
+
+		if (hasAllStates)
+		{
+			return true;
+		}
+	}
+
+	QVector<QCryptographicHash*> hashes;
+	hashes.reserve(m_hashes.count());
+
+	for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
+	{
+		hashes.append(new QCryptographicHash(iterator.key()));
+	}
+
+	while (!file.atEnd())
+	{
+		const QByteArray data(file.read(1048576));
+
+		if (data.isEmpty())
+		{
+			break;
+		}
+
+		for (int i = 0; i < hashes.count(); ++i)
+		{
+			hashes.at(i)->addData(data);
+		}
+	}
+
+	file.close();
+
+	bool isValid(true);
+	int index(0);
+
+	for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
+	{
+		if (hashes.at(index)->result() != iterator.value())
+		{
+			isValid = false;
+
+			break;
+		}
+
+		++index;
+	}
+
+	qDeleteAll(hashes);
+
+	return isValid;
+}
+
+QStringList Transfer::getSegments() const
+{
+	QStringList segments;
+	segments.reserve(m_segments.count());
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		const Segment &segment(m_segments.at(i));
+
+		segments.append(QStringLiteral("%1-%2-%3").arg(segment.start).arg(segment.position).arg(segment.end));
+	}
+
+	return segments;
+}
+
+qint64 Transfer::getReadBufferSize() const
+{
+	if (m_effectiveSpeedLimit <= 0)
+	{
+		return 0;
+	}
+
+	return qMax(static_cast<qint64>(MinimumReadBufferSize), ((m_effectiveSpeedLimit * ThrottlingInterval) / 1000));
+}
+
+qint64 Transfer::takeReadAllowance(qint64 amount)
+{
+	if (m_effectiveSpeedLimit <= 0 || m_throttlingTimer == 0)
+	{
+		return amount;
+	}
+
+	const qint64 allowance(qBound(static_cast<qint64>(0), amount, m_readAllowance));
+
+	m_readAllowance -= allowance;
+
+	return allowance;
+}
+
+int Transfer::getSegmentIndex(QNetworkReply *reply) const
+{
+	if (!reply)
+	{
+		return -1;
+	}
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		if (m_segments.at(i).reply == reply)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+bool Transfer::readHashes(const QVector<QCryptographicHash*> &hashes, qint64 from, qint64 to)
+{
+	if (from >= to)
+	{
+		return true;
+	}
+
+	if (m_device)
+	{
+		m_device->flush();
+	}
+
+	QFile file(m_target);
+
+	if (!file.open(QIODevice::ReadOnly) || !file.seek(from))
+	{
+		return false;
+	}
+
+	qint64 remaining(to - from);
+
+	while (remaining > 0)
+	{
+		const QByteArray data(file.read(qMin(remaining, static_cast<qint64>(1048576))));
+
+		if (data.isEmpty())
+		{
+			return false;
+		}
+
+		for (int i = 0; i < hashes.count(); ++i)
+		{
+			hashes.at(i)->addData(data);
+		}
+
+		remaining -= data.size();
+	}
+
+	return true;
 }
 
-qint64 Transfer::getBytesTotal() const
+bool Transfer::isArchived() const
 {
-	return m_bytesTotal;
+	return m_isArchived;
 }
 
-Transfer::TransferOptions Transfer::getOptions() const
+bool Transfer::startSegments()
 {
-	return m_options;
-}
+	const int amount(SettingsManager::getOption(SettingsManager::Network_MaximumTransferSegmentsOption, m_source.host()).toInt());
 
-Transfer::TransferState Transfer::getState() const
-{
-	return m_state;
-}
+	if (amount < 2 || !m_reply || m_reply->isFinished() || m_reply->operation() != QNetworkAccessManager::GetOperation || !m_device || m_device->inherits("QTemporaryFile") || !m_segments.isEmpty())
+	{
+		return false;
+	}
 
-int Transfer::getRemainingTime() const
-{
-	return m_remainingTime;
-}
+	const QString scheme(m_source.scheme());
 
-bool Transfer::verifyHashes() const
-{
-	if (getState() != FinishedState)
+	if ((scheme != QLatin1String("http") && scheme != QLatin1String("https")) || m_reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool() || m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200 || m_reply->rawHeader(QByteArrayLiteral("Accept-Ranges")).trimmed().toLower() != QByteArrayLiteral("bytes") || m_reply->hasRawHeader(QByteArrayLiteral("Content-Encoding")))
 	{
 		return false;
 	}
 
-	QFile file(getTarget());
+	const qint64 bytesTotal(m_reply->header(QNetworkRequest::ContentLengthHeader).toLongLong());
+	const qint64 position(m_device->size());
 
-	if (!file.open(QIODevice::ReadOnly))
+	if (bytesTotal <= 0 || bytesTotal != m_bytesTotal || position >= bytesTotal)
 	{
 		return false;
 	}
 
-	QHash<QCryptographicHash::Algorithm, QByteArray>::const_iterator iterator;
-	bool isValid(true);
+	const int segmentsAmount(static_cast<int>(qMin(static_cast<qint64>(amount), ((bytesTotal - position) / MinimumSegmentSize))));
 
-	for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
+	if (segmentsAmount < 2 || !m_device->resize(bytesTotal))
+	{
+		return false;
+	}
+
+	const qint64 segmentSize((bytesTotal - position) / segmentsAmount);
+
+	m_segments.reserve(segmentsAmount);
+
+	for (int i = 0; i < segmentsAmount; ++i)
 	{
-		QCryptographicHash hash(iterator.key());
-		hash.addData(&file);
+		Segment segment;
+		segment.start = ((i == 0) ? 0 : (position + (i * segmentSize)));
+		segment.position = ((i == 0) ? position : segment.start);
+		segment.end = ((i == (segmentsAmount - 1)) ? bytesTotal : (position + ((i + 1) * segmentSize)));
 
-		if (hash.result() != iterator.value())
-		{
-			isValid = false;
+		m_segments.append(segment);
+	}
 
-			break;
-		}
+	disconnect(m_reply, nullptr, this, nullptr);
+
+	m_segmentsManager = m_reply->manager();
+	m_segmentsRequest = m_reply->request();
+	m_segments[0].reply = m_reply;
+	m_bytesReceived = position;
 
-		file.seek(0);
+	connect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleSegmentDataAvailable);
+	connect(m_reply, &QNetworkReply::finished, this, &Transfer::handleSegmentFinished);
+
+	for (int i = 1; i < m_segments.count(); ++i)
+	{
+		startSegment(i);
 	}
 
-	file.close();
+	writeSegment(0);
 
-	return isValid;
+	return true;
 }
 
-bool Transfer::isArchived() const
+bool Transfer::resumeSegments()
 {
-	return m_isArchived;
+	QFile *file(new QFile(m_target));
+
+	if (file->size() != m_bytesTotal || !file->open(QIODevice::ReadWrite))
+	{
+		file->deleteLater();
+
+		m_segments.clear();
+
+		return false;
+	}
+
+	m_state = RunningState;
+	m_device = file;
+	m_timeStarted = QDateTime::currentDateTimeUtc();
+	m_timeFinished = {};
+	m_bytesReceived = 0;
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		m_segments[i].attempts = 0;
+
+		m_bytesReceived += (m_segments.at(i).position - m_segments.at(i).start);
+	}
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		if (!m_segments.at(i).isFinished())
+		{
+			startSegment(i);
+		}
+	}
+
+	if (m_updateTimer == 0 && m_updateInterval > 0)
+	{
+		m_updateTimer = startTimer(m_updateInterval);
+	}
+
+	if (m_throttlingTimer == 0 && m_effectiveSpeedLimit > 0)
+	{
+		m_throttlingTimer = startTimer(ThrottlingInterval);
+	}
+
+	return true;
 }
 
 bool Transfer::resume()
 {
+	if (m_state == ErrorState && !m_request.url().isEmpty())
+	{
+		m_state = QueuedState;
+		m_isArchived = false;
+
+		emit changed();
+
+		return true;
+	}
+
 	if (m_state != ErrorState || !QFile::exists(m_target))
 	{
 		return false;
@@ -782,6 +1640,11 @@ bool Transfer::resume()
 		return restart();
 	}
 
+	if (!m_segments.isEmpty())
+	{
+		return (resumeSegments() || restart());
+	}
+
 	QFile *file(new QFile(m_target));
 
 	if (!file->open(QIODevice::WriteOnly | QIODevice::Append))
@@ -804,6 +1667,7 @@ bool Transfer::resume()
 	request.setUrl(m_source);
 
 	m_reply = NetworkManagerFactory::getNetworkManager(m_options.testFlag(IsPrivateOption))->get(request);
+	m_reply->setReadBufferSize(getReadBufferSize());
 
 	handleDataAvailable();
 
@@ -817,14 +1681,33 @@ bool Transfer::resume()
 		m_updateTimer = startTimer(m_updateInterval);
 	}
 
+	if (m_throttlingTimer == 0 && m_effectiveSpeedLimit > 0)
+	{
+		m_throttlingTimer = startTimer(ThrottlingInterval);
+	}
+
 	return true;
 }
 
 bool Transfer::restart()
 {
+	if (!m_request.url().isEmpty())
+	{
+		if (m_state != QueuedState)
+		{
+			m_state = QueuedState;
+			m_isArchived = false;
+
+			emit changed();
+		}
+
+		return true;
+	}
+
 	stop();
 
 	m_isArchived = false;
+	m_segments.clear();
 
 	QFile *file(new QFile(m_target));
 
@@ -847,6 +1730,7 @@ bool Transfer::restart()
 	request.setUrl(m_source);
 
 	m_reply = NetworkManagerFactory::getNetworkManager(m_options.testFlag(IsPrivateOption))->get(request);
+	m_reply->setReadBufferSize(getReadBufferSize());
 
 	handleDataAvailable();
 
@@ -860,12 +1744,17 @@ bool Transfer::restart()
 		m_updateTimer = startTimer(m_updateInterval);
 	}
 
+	if (m_throttlingTimer == 0 && m_effectiveSpeedLimit > 0)
+	{
+		m_throttlingTimer = startTimer(ThrottlingInterval);
+	}
+
 	return true;
 }
 
 bool Transfer::setTarget(const QString &target, bool canOverwriteExisting)
 {
-	if (m_target == target)
+	if (m_target == target || (m_state == RunningState && !m_segments.isEmpty()))
 	{
 		return false;
 	}
@@ -898,6 +1787,16 @@ bool Transfer::setTarget(const QString &target, bool canOverwriteExisting)
 		}
 	}
 
+	if (m_state == QueuedState)
+	{
+		m_target = mutableTarget;
+		m_options |= CanOverwriteOption;
+
+		emit changed();
+
+		return true;
+	}
+
 	if (!m_device)
 	{
 		if (m_state != FinishedState)
@@ -956,7 +1855,7 @@ bool Transfer::setTarget(const QString &target, bool canOverwriteExisting)
 	{
 		handleDownloadFinished();
 	}
-	else
+	else if (!startSegments())
 	{
 		connect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
 	}
@@ -965,8 +1864,10 @@ bool Transfer::setTarget(const QString &target, bool canOverwriteExisting)
 }
 
 TransfersManager::TransfersManager(QObject *parent) : QObject(parent),
-	m_saveTimer(0)
+	m_saveTimer(0),
+	m_queueTimer(0)
 {
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &TransfersManager::handleOptionChanged);
 }
 
 void TransfersManager::createInstance()
@@ -987,6 +1888,14 @@ void TransfersManager::timerEvent(QTimerEvent *event)
 
 		save();
 	}
+	else if (event->timerId() == m_queueTimer)
+	{
+		killTimer(m_queueTimer);
+
+		m_queueTimer = 0;
+
+		processQueue();
+	}
 }
 
 void TransfersManager::scheduleSave()
@@ -997,6 +1906,128 @@ void TransfersManager::scheduleSave()
 	}
 }
 
+void TransfersManager::scheduleQueue(int delay)
+{
+	if (m_queueTimer != 0)
+	{
+		killTimer(m_queueTimer);
+	}
+
+	m_queueTimer = startTimer(delay);
+}
+
+void TransfersManager::processQueue()
+{
+	QVector<Transfer*> queuedTransfers;
+	QHash<QString, int> hostTransfers;
+	int runningTransfers(0);
+
+	for (int i = 0; i < m_transfers.count(); ++i)
+	{
+		Transfer *transfer(m_transfers.at(i));
+
+		if (transfer->getState() == Transfer::QueuedState)
+		{
+			queuedTransfers.append(transfer);
+		}
+		else if (transfer->getState() == Transfer::RunningState)
+		{
+			++runningTransfers;
+			++hostTransfers[transfer->getSource().host()];
+		}
+	}
+
+	if (!queuedTransfers.isEmpty())
+	{
+		if (isWithinTimeWindow())
+		{
+			const int transfersLimit(SettingsManager::getOption(SettingsManager::Network_MaximumTransfersOption).toInt());
+			const int hostTransfersLimit(SettingsManager::getOption(SettingsManager::Network_MaximumTransfersPerHostOption).toInt());
+
+			std::stable_sort(queuedTransfers.begin(), queuedTransfers.end(), [&](Transfer *first, Transfer *second)
+			{
+				return (first->getPriority() > second->getPriority());
+			});
+
+			for (int i = 0; i < queuedTransfers.count(); ++i)
+			{
+				if (transfersLimit > 0 && runningTransfers >= transfersLimit)
+				{
+					break;
+				}
+
+				Transfer *transfer(queuedTransfers.at(i));
+				const QString host(transfer->getSource().host());
+
+				if (!m_transfers.contains(transfer) || transfer->getState() != Transfer::QueuedState || (hostTransfersLimit > 0 && hostTransfers.value(host) >= hostTransfersLimit))
+				{
+					continue;
+				}
+
+				const QNetworkRequest request(transfer->m_request);
+				const QString target(transfer->m_target);
+
+				transfer->m_request = {};
+				transfer->start(NetworkManagerFactory::getNetworkManager(transfer->getOptions().testFlag(Transfer::IsPrivateOption))->get(request), target);
+
+				if (transfer->getState() == Transfer::CancelledState)
+				{
+					removeTransfer(transfer);
+
+					continue;
+				}
+
+				if (transfer->getState() == Transfer::RunningState)
+				{
+					++runningTransfers;
+					++hostTransfers[host];
+				}
+
+				emit transferChanged(transfer);
+
+				scheduleSave();
+			}
+		}
+		else
+		{
+			scheduleQueue(60000);
+		}
+	}
+
+	updateSpeedLimits();
+	updateRunningTransfersState();
+}
+
+void TransfersManager::updateSpeedLimits()
+{
+	QVector<Transfer*> runningTransfers;
+
+	for (int i = 0; i < m_transfers.count(); ++i)
+	{
+		if (m_transfers.at(i)->getState() == Transfer::RunningState)
+		{
+			runningTransfers.append(m_transfers.at(i));
+		}
+	}
+
+	const qint64 speedLimit(SettingsManager::getOption(SettingsManager::Network_TransferSpeedLimitOption).toLongLong() * 1024);
+	const qint64 speedLimitShare((speedLimit > 0 && !runningTransfers.isEmpty()) ? qMax(static_cast<qint64>(1), (speedLimit / runningTransfers.count())) : 0);
+
+	for (int i = 0; i < runningTransfers.count(); ++i)
+	{
+		const qint64 transferSpeedLimit(runningTransfers.at(i)->getSpeedLimit());
+
+		if (transferSpeedLimit > 0 && speedLimitShare > 0)
+		{
+			runningTransfers.at(i)->setEffectiveSpeedLimit(qMin(transferSpeedLimit, speedLimitShare));
+		}
+		else
+		{
+			runningTransfers.at(i)->setEffectiveSpeedLimit(qMax(transferSpeedLimit, speedLimitShare));
+		}
+	}
+}
+
 void TransfersManager::updateRunningTransfersState()
 {
 	bool hasRunningTransfers(false);
@@ -1016,7 +2047,7 @@ void TransfersManager::updateRunningTransfersState()
 
 void TransfersManager::addTransfer(Transfer *transfer)
 {
-	if (!transfer)
+	if (!transfer || m_transfers.contains(transfer))
 	{
 		return;
 	}
@@ -1053,6 +2084,8 @@ void TransfersManager::addTransfer(Transfer *transfer)
 			HistoryManager::addEntry(transfer->getSource());
 		}
 	}
+
+	m_instance->scheduleQueue();
 }
 
 void TransfersManager::save()
@@ -1082,6 +2115,21 @@ void TransfersManager::save()
 		history.setValue(QStringLiteral("%1/bytesTotal").arg(entry), m_transfers.at(i)->getBytesTotal());
 		history.setValue(QStringLiteral("%1/bytesReceived").arg(entry), m_transfers.at(i)->getBytesReceived());
 
+		if (m_transfers.at(i)->getState() == Transfer::QueuedState)
+		{
+			history.setValue(QStringLiteral("%1/isQueued").arg(entry), true);
+		}
+
+		if (m_transfers.at(i)->getPriority() != 0)
+		{
+			history.setValue(QStringLiteral("%1/priority").arg(entry), m_transfers.at(i)->getPriority());
+		}
+
+		if (!m_transfers.at(i)->m_segments.isEmpty())
+		{
+			history.setValue(QStringLiteral("%1/segments").arg(entry), m_transfers.at(i)->getSegments());
+		}
+
 		++entry;
 	}
 
@@ -1099,6 +2147,22 @@ void TransfersManager::clearTransfers(int period)
 	}
 }
 
+void TransfersManager::handleOptionChanged(int identifier)
+{
+	switch (identifier)
+	{
+		case SettingsManager::Network_MaximumTransfersOption:
+		case SettingsManager::Network_MaximumTransfersPerHostOption:
+		case SettingsManager::Network_TransferSpeedLimitOption:
+		case SettingsManager::Network_TransferTimeWindowOption:
+			scheduleQueue();
+
+			break;
+		default:
+			break;
+	}
+}
+
 void TransfersManager::handleTransferStarted()
 {
 	Transfer *transfer(qobject_cast<Transfer*>(sender()));
@@ -1113,6 +2177,7 @@ void TransfersManager::handleTransferStarted()
 		emit transferStarted(transfer);
 
 		scheduleSave();
+		scheduleQueue();
 	}
 }
 
@@ -1146,6 +2211,8 @@ void TransfersManager::handleTransferFinished()
 			scheduleSave();
 		}
 	}
+
+	scheduleQueue();
 }
 
 void TransfersManager::handleTransferChanged()
@@ -1155,6 +2222,7 @@ void TransfersManager::handleTransferChanged()
 	if (transfer)
 	{
 		scheduleSave();
+		scheduleQueue();
 		updateRunningTransfersState();
 
 		emit transferChanged(transfer);
@@ -1173,6 +2241,8 @@ void TransfersManager::handleTransferStopped()
 
 		scheduleSave();
 	}
+
+	scheduleQueue();
 }
 
 TransfersManager* TransfersManager::getInstance()
@@ -1188,24 +2258,27 @@ Transfer* TransfersManager::startTransfer(const QUrl &source, const QString &tar
 	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
 	request.setUrl(QUrl(source));
 
+	return startTransfer(request, target, options);
+}
+
+Transfer* TransfersManager::startTransfer(const QNetworkRequest &request, const QString &target, Transfer::TransferOptions options)
+{
 	Transfer *transfer(new Transfer(options, m_instance));
-	transfer->start(NetworkManagerFactory::getNetworkManager(options.testFlag(Transfer::IsPrivateOption))->get(request), target);
 
-	if (transfer->getState() == Transfer::CancelledState)
+	if (!canStartTransfer(request.url()))
 	{
-		transfer->deleteLater();
+		if (!transfer->queue(request, target))
+		{
+			transfer->deleteLater();
 
-		return nullptr;
-	}
+			return nullptr;
+		}
 
-	addTransfer(transfer);
+		addTransfer(transfer);
 
-	return transfer;
-}
+		return transfer;
+	}
 
-Transfer* TransfersManager::startTransfer(const QNetworkRequest &request, const QString &target, Transfer::TransferOptions options)
-{
-	Transfer *transfer(new Transfer(options, m_instance));
 	transfer->start(NetworkManagerFactory::getNetworkManager(options.testFlag(Transfer::IsPrivateOption))->get(request), target);
 
 	if (transfer->getState() == Transfer::CancelledState)
@@ -1291,6 +2364,8 @@ bool TransfersManager::removeTransfer(Transfer *transfer, bool keepFile)
 
 	transfer->deleteLater();
 
+	m_instance->scheduleQueue();
+
 	return true;
 }
 
@@ -1327,6 +2402,64 @@ bool TransfersManager::isDownloading(const QString &source, const QString &targe
 	return false;
 }
 
+bool TransfersManager::canStartTransfer(const QUrl &source)
+{
+	if (!isWithinTimeWindow())
+	{
+		return false;
+	}
+
+	const int transfersLimit(SettingsManager::getOption(SettingsManager::Network_MaximumTransfersOption).toInt());
+	const int hostTransfersLimit(SettingsManager::getOption(SettingsManager::Network_MaximumTransfersPerHostOption).toInt());
+	const QString host(source.host());
+	int runningTransfers(0);
+	int hostTransfers(0);
+
+	for (int i = 0; i < m_transfers.count(); ++i)
+	{
+		const Transfer::TransferState state(m_transfers.at(i)->getState());
+
+		if (state == Transfer::QueuedState && m_transfers.at(i)->getSource().host() == host)
+		{
+			return false;
+		}
+
+		if (state == Transfer::RunningState)
+		{
+			++runningTransfers;
+
+			if (m_transfers.at(i)->getSource().host() == host)
+			{
+				++hostTransfers;
+			}
+		}
+	}
+
+	return ((transfersLimit <= 0 || runningTransfers < transfersLimit) && (hostTransfersLimit <= 0 || hostTransfers < hostTransfersLimit));
+}
+
+bool TransfersManager::isWithinTimeWindow()
+{
+	const QStringList window(SettingsManager::getOption(SettingsManager::Network_TransferTimeWindowOption).toString().split(QLatin1Char('-')));
+
+	if (window.count() != 2)
+	{
+		return true;
+	}
+
+	const QTime from(QTime::fromString(window.at(0).trimmed(), QLatin1String("H:mm")));
+	const QTime to(QTime::fromString(window.at(1).trimmed(), QLatin1String("H:mm")));
+
+	if (!from.isValid() || !to.isValid() || from == to)
+	{
+		return true;
+	}
+
+	const QTime time(QTime::currentTime());
+
+	return ((from < to) ? (time >= from && time < to) : (time >= from || time < to));
+}
+
 bool TransfersManager::hasRunningTransfers()
 {
 	return m_hasRunningTransfers;
@@ -56,6 +56,7 @@ public:
 		UnknownState = 0,
 		ErrorState,
 		CancelledState,
+		QueuedState,
 		RunningState,
 		FinishedState
 	};
@@ -63,6 +64,8 @@ public:
 	~Transfer();
 
 	void setHash(const QByteArray &hash, QCryptographicHash::Algorithm algorithm);
+	void setPriority(int priority);
+	void setSpeedLimit(qint64 limit);
 	virtual void setUpdateInterval(int interval);
 	virtual QUrl getSource() const;
 	virtual QString getSuggestedFileName();
@@ -74,9 +77,11 @@ public:
 	virtual qint64 getSpeed() const;
 	virtual qint64 getBytesReceived() const;
 	virtual qint64 getBytesTotal() const;
+	qint64 getSpeedLimit() const;
 	TransferOptions getOptions() const;
 	virtual TransferState getState() const;
 	virtual int getRemainingTime() const;
+	int getPriority() const;
 	bool verifyHashes() const;
 	bool isArchived() const;
 
@@ -90,11 +95,55 @@ public slots:
 	virtual bool setTarget(const QString &target, bool canOverwriteExisting = false);
 
 protected:
+	enum SegmentationLimit
+	{
+		MinimumSegmentSize = 1048576,
+		MaximumSegmentAttempts = 5
+	};
+
+	enum ThrottlingLimit
+	{
+		ThrottlingInterval = 100,
+		MinimumReadBufferSize = 4096
+	};
+
+	struct Segment final
+	{
+		QPointer<QNetworkReply> reply;
+		qint64 start = 0;
+		qint64 position = 0;
+		qint64 end = 0;
+		int attempts = 0;
+
+		bool isFinished() const
+		{
+			return (position >= end);
+		}
+	};
+
 	explicit Transfer(TransferOptions options = CanAskForPathOption, QObject *parent = nullptr);
 	Transfer(const QSettings &settings, QObject *parent = nullptr);
 
 	void timerEvent(QTimerEvent *event) override;
 	void start(QNetworkReply *reply, const QString &target);
+	bool queue(const QNetworkRequest &request, const QString &target);
+	void setEffectiveSpeedLimit(qint64 limit);
+	void readPendingData();
+	void updateHashes(const QByteArray &data, qint64 position);
+	void finishHashes(qint64 size);
+	void startSegment(int index);
+	void writeSegment(int index);
+	void rejectSegmentRange();
+	void retrySegment(int index);
+	void abortSegments();
+	void finishSegments();
+	QStringList getSegments() const;
+	qint64 getReadBufferSize() const;
+	qint64 takeReadAllowance(qint64 amount);
+	int getSegmentIndex(QNetworkReply *reply) const;
+	bool readHashes(const QVector<QCryptographicHash*> &hashes, qint64 from, qint64 to);
+	bool startSegments();
+	bool resumeSegments();
 
 protected slots:
 	void markAsStarted();
@@ -103,10 +152,15 @@ protected slots:
 	void handleDataAvailable();
 	void handleDownloadFinished();
 	void handleDownloadError(QNetworkReply::NetworkError error);
+	void handleSegmentDataAvailable();
+	void handleSegmentFinished();
 
 private:
 	QPointer<QNetworkReply> m_reply;
+	QPointer<QNetworkAccessManager> m_segmentsManager;
 	QPointer<QFile> m_device;
+	QNetworkRequest m_request;
+	QNetworkRequest m_segmentsRequest;
 	QUrl m_source;
 	QString m_target;
 	QString m_openCommand;
@@ -115,17 +169,25 @@ private:
 	QDateTime m_timeFinished;
 	QMimeType m_mimeType;
 	QHash<QCryptographicHash::Algorithm, QByteArray> m_hashes;
+	QHash<QCryptographicHash::Algorithm, QCryptographicHash*> m_hashStates;
 	QQueue<qint64> m_speeds;
+	QVector<Segment> m_segments;
 	qint64 m_speed;
 	qint64 m_bytesStart;
 	qint64 m_bytesReceivedDifference;
 	qint64 m_bytesReceived;
 	qint64 m_bytesTotal;
+	qint64 m_hashedBytes;
+	qint64 m_speedLimit;
+	qint64 m_effectiveSpeedLimit;
+	qint64 m_readAllowance;
 	TransferOptions m_options;
 	TransferState m_state;
 	int m_updateTimer;
 	int m_updateInterval;
+	int m_throttlingTimer;
 	int m_remainingTime;
+	int m_priority;
 	bool m_isSelectingPath;
 	bool m_isArchived;
 
@@ -161,10 +223,16 @@ protected:
 
 	void timerEvent(QTimerEvent *event) override;
 	void scheduleSave();
+	void scheduleQueue(int delay = 0);
+	void processQueue();
+	void updateSpeedLimits();
 	void updateRunningTransfersState();
+	static bool canStartTransfer(const QUrl &source);
+	static bool isWithinTimeWindow();
 
 protected slots:
 	void save();
+	void handleOptionChanged(int identifier);
 	void handleTransferStarted();
 	void handleTransferFinished();
 	void handleTransferChanged();
@@ -172,6 +240,7 @@ protected slots:
 
 private:
 	int m_saveTimer;
+	int m_queueTimer;
 
 	static TransfersManager *m_instance;
 	static QVector<Transfer*> m_transfers;
@@ -0,0 +1,352 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "UrlCompletionIndex.h"
+#include "Utils.h"
+
+#include <QtCore/QSet>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Otter
+{
+
+void UrlCompletionIndex::setEntry(const QUrl &url, QStandardItem *item, const QString &title, qreal score)
+{
+	const QStringList titleKeys(createTitleKeys(title));
+	QHash<QUrl, Entry>::iterator iterator(m_entries.find(url));
+
+	if (iterator != m_entries.end())
+	{
+		Entry &entry(iterator.value());
+		entry.item = item;
+
+		if (entry.titleKeys != titleKeys)
+		{
+			for (int i = 0; i < entry.titleKeys.count(); ++i)
+			{
+				m_titleKeys.remove(entry.titleKeys.at(i), url);
+			}
+
+			for (int i = 0; i < titleKeys.count(); ++i)
+			{
+				m_titleKeys.insert(titleKeys.at(i), url);
+			}
+
+			entry.titleKeys = titleKeys;
+		}
+
+		if (entry.score != score)
+		{
+			m_scores.remove(entry.score, url);
+			m_scores.insert(score, url);
+
+			entry.score = score;
+		}
+
+		return;
+	}
+
+	Entry entry;
+	entry.url = url;
+	entry.keys = createKeys(url);
+	entry.titleKeys = titleKeys;
+	entry.item = item;
+	entry.score = score;
+
+	for (int i = 1; i < entry.keys.count(); ++i)
+	{
+		m_keys.insert(entry.keys.at(i), url);
+	}
+
+	for (int i = 0; i < titleKeys.count(); ++i)
+	{
+		m_titleKeys.insert(titleKeys.at(i), url);
+	}
+
+	m_scores.insert(score, url);
+	m_entries[url] = entry;
+
+	++m_schemes[url.scheme()];
+}
+
+void UrlCompletionIndex::removeEntry(const QUrl &url)
+{
+	const QHash<QUrl, Entry>::iterator iterator(m_entries.find(url));
+
+	if (iterator == m_entries.end())
+	{
+		return;
+	}
+
+	const Entry &entry(iterator.value());
+
+	for (int i = 1; i < entry.keys.count(); ++i)
+	{
+		m_keys.remove(entry.keys.at(i), url);
+	}
+
+	for (int i = 0; i < entry.titleKeys.count(); ++i)
+	{
+		m_titleKeys.remove(entry.titleKeys.at(i), url);
+	}
+
+	m_scores.remove(entry.score, url);
+
+	const QString scheme(url.scheme());
+
+	if (--m_schemes[scheme] <= 0)
+	{
+		m_schemes.remove(scheme);
+	}
+
+	m_entries.erase(iterator);
+}
+
+void UrlCompletionIndex::clear()
+{
+	m_entries.clear();
+	m_schemes.clear();
+	m_keys.clear();
+	m_titleKeys.clear();
+	m_scores.clear();
+}
+
+QVector<UrlCompletionIndex::Match> UrlCompletionIndex::findEntries(const QString &prefix, int limit) const
+{
+	const QString normalizedPrefix(prefix.toLower());
+	const int schemeSeparator(normalizedPrefix.indexOf(QLatin1String("://")));
+	QString key(normalizedPrefix);
+	bool needsFullScan(normalizedPrefix.isEmpty());
+
+	if (schemeSeparator >= 0)
+	{
+		key = normalizedPrefix.mid(schemeSeparator + 3);
+		needsFullScan = key.isEmpty();
+	}
+	else
+	{
+		QHash<QString, int>::const_iterator iterator;
+
+		for (iterator = m_schemes.constBegin(); iterator != m_schemes.constEnd(); ++iterator)
+		{
+			if (QString(iterator.key() + QLatin1String("://")).startsWith(normalizedPrefix))
+			{
+				needsFullScan = true;
+
+				break;
+			}
+		}
+	}
+
+	QVector<Match> matches;
+	QSet<QUrl> matchedUrls;
+	const auto addMatches([&](QVector<const Entry*> entries, bool isTitleMatch)
+	{
+		std::stable_sort(entries.begin(), entries.end(), [&](const Entry *first, const Entry *second)
+		{
+			return (first->score > second->score);
+		});
+
+		for (int i = 0; i < entries.count(); ++i)
+		{
+			if (limit > 0 && matches.count() >= limit)
+			{
+				break;
+			}
+
+			const Entry *entry(entries.at(i));
+
+			if (matchedUrls.contains(entry->url) || !matchesEntry(*entry, normalizedPrefix, isTitleMatch))
+			{
+				continue;
+			}
+
+			Match match;
+			match.item = entry->item;
+
+			if (!isTitleMatch)
+			{
+				match.match = Utils::matchUrl(entry->url, prefix);
+			}
+
+			matches.append(match);
+			matchedUrls.insert(entry->url);
+		}
+	});
+	QVector<const Entry*> entries;
+
+	if (needsFullScan || !collectEntries(m_keys, key, entries))
+	{
+		entries = findEntriesByScore(normalizedPrefix, false, limit);
+	}
+
+	addMatches(entries, false);
+
+	if (!normalizedPrefix.isEmpty() && (limit <= 0 || matches.count() < limit))
+	{
+		entries.clear();
+
+		if (!collectEntries(m_titleKeys, normalizedPrefix, entries))
+		{
+			entries = findEntriesByScore(normalizedPrefix, true, ((limit > 0) ? (limit + matches.count()) : 0));
+		}
+
+		addMatches(entries, true);
+	}
+
+	return matches;
+}
+
+QVector<const UrlCompletionIndex::Entry*> UrlCompletionIndex::findEntriesByScore(const QString &prefix, bool isTitleMatch, int limit) const
+{
+	QVector<const Entry*> entries;
+	QMultiMap<qreal, QUrl>::const_iterator iterator(m_scores.constEnd());
+
+	while (iterator != m_scores.constBegin())
+	{
+		--iterator;
+
+		const QHash<QUrl, Entry>::const_iterator entryIterator(m_entries.constFind(iterator.value()));
+
+		if (entryIterator != m_entries.constEnd() && matchesEntry(entryIterator.value(), prefix, isTitleMatch))
+		{
+			entries.append(&entryIterator.value());
+
+			if (limit > 0 && entries.count() >= limit)
+			{
+				break;
+			}
+		}
+	}
+
+	return entries;
+}
+
+QStringList UrlCompletionIndex::createKeys(const QUrl &url)
+{
+	const QString key(url.toString(QUrl::RemoveScheme).mid(2).toLower());
+	QStringList keys({url.toString().toLower(), key});
+
+	if (key.startsWith(QLatin1String("www.")) && url.host().count(QLatin1Char('.')) > 1)
+	{
+		keys.append(key.mid(4));
+	}
+
+	return keys;
+}
+
+QStringList UrlCompletionIndex::createTitleKeys(const QString &title)
+{
+	const QString normalizedTitle(title.simplified().toLower());
+	QStringList keys;
+
+	if (normalizedTitle.isEmpty())
+	{
+		return keys;
+	}
+
+	keys.append(normalizedTitle);
+
+	for (int i = 1; i < normalizedTitle.count(); ++i)
+	{
+		if (keys.count() >= MaximumTitleKeysAmount)
+		{
+			break;
+		}
+
+		if (!normalizedTitle.at(i - 1).isLetterOrNumber() && normalizedTitle.at(i).isLetterOrNumber())
+		{
+			keys.append(normalizedTitle.mid(i));
+		}
+	}
+
+	return keys;
+}
+
+qreal UrlCompletionIndex::calculateScore(qreal weight, const QDateTime &timeVisited)
+{
+	return (std::log2(qMax(weight, 1.0)) + getTimeScore(timeVisited));
+}
+
+qreal UrlCompletionIndex::addVisitScore(qreal score, const QDateTime &timeVisited, qreal weight)
+{
+	const qreal visitScore(calculateScore(weight, timeVisited));
+	const qreal maximum(qMax(score, visitScore));
+
+	return (maximum + std::log2(1 + std::exp2(qMin(score, visitScore) - maximum)));
+}
+
+qreal UrlCompletionIndex::getTimeScore(const QDateTime &time)
+{
+	return (time.isValid() ? (time.toMSecsSinceEpoch() / (30.0 * 24 * 3600 * 1000)) : 0);
+}
+
+bool UrlCompletionIndex::collectEntries(const QMultiMap<QString, QUrl> &keys, const QString &prefix, QVector<const Entry*> &entries) const
+{
+	QSet<QUrl> urls;
+	QMultiMap<QString, QUrl>::const_iterator iterator(keys.lowerBound(prefix));
+	int amount(0);
+
+	while (iterator != keys.constEnd() && iterator.key().startsWith(prefix))
+	{
+		++amount;
+
+		if (amount > 1000)
+		{
+			entries.clear();
+
+			return false;
+		}
+
+		if (!urls.contains(iterator.value()))
+		{
+			const QHash<QUrl, Entry>::const_iterator entryIterator(m_entries.constFind(iterator.value()));
+
+			if (entryIterator != m_entries.constEnd())
+			{
+				entries.append(&entryIterator.value());
+			}
+
+			urls.insert(iterator.value());
+		}
+
+		++iterator;
+	}
+
+	return true;
+}
+
+bool UrlCompletionIndex::matchesEntry(const Entry &entry, const QString &prefix, bool isTitleMatch)
+{
+	const QStringList &keys(isTitleMatch ? entry.titleKeys : entry.keys);
+
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		if (keys.at(i).startsWith(prefix))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+}
@@ -0,0 +1,79 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_URLCOMPLETIONINDEX_H
+#define OTTER_URLCOMPLETIONINDEX_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QMap>
+#include <QtCore/QUrl>
+#include <QtGui/QStandardItem>
+
+namespace Otter
+{
+
+class UrlCompletionIndex final
+{
+public:
+	struct Match final
+	{
+		QStandardItem *item = nullptr;
+		QString match;
+	};
+
+	void setEntry(const QUrl &url, QStandardItem *item, const QString &title, qreal score);
+	void removeEntry(const QUrl &url);
+	void clear();
+	QVector<Match> findEntries(const QString &prefix, int limit = 0) const;
+	static qreal calculateScore(qreal weight, const QDateTime &timeVisited);
+	static qreal addVisitScore(qreal score, const QDateTime &timeVisited, qreal weight = 1);
+
+protected:
+	enum KeysLimit
+	{
+		MaximumTitleKeysAmount = 8
+	};
+
+	struct Entry final
+	{
+		QUrl url;
+		QStringList keys;
+		QStringList titleKeys;
+		QStandardItem *item = nullptr;
+		qreal score = 0;
+	};
+
+	QVector<const Entry*> findEntriesByScore(const QString &prefix, bool isTitleMatch, int limit) const;
+	static QStringList createKeys(const QUrl &url);
+	static QStringList createTitleKeys(const QString &title);
+	static qreal getTimeScore(const QDateTime &time);
+	bool collectEntries(const QMultiMap<QString, QUrl> &keys, const QString &prefix, QVector<const Entry*> &entries) const;
+	static bool matchesEntry(const Entry &entry, const QString &prefix, bool isTitleMatch);
+
+private:
+	QHash<QUrl, Entry> m_entries;
+	QHash<QString, int> m_schemes;
+	QMultiMap<QString, QUrl> m_keys;
+	QMultiMap<QString, QUrl> m_titleKeys;
+	QMultiMap<qreal, QUrl> m_scores;
+};
+
+}
+
+#endif
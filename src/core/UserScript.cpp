@@ -29,9 +29,17 @@
 #include <QtCore/QRegularExpression>
 #include <QtCore/QTextStream>
 
+#include <algorithm>
+
 namespace Otter
 {
 
+QVector<UserScript*> UserScript::m_indexedScripts;
+QVector<int> UserScript::m_unindexedScripts;
+QHash<QString, QVector<int> > UserScript::m_hostIndex;
+QCache<QString, QVector<UserScript*> > UserScript::m_matchesCache;
+bool UserScript::m_isIndexValid(false);
+
 UserScript::UserScript(const QString &path, const QUrl &url, QObject *parent) : QObject(parent),
 	m_iconFetchJob(nullptr),
 	m_path(path),
@@ -42,6 +50,11 @@ UserScript::UserScript(const QString &path, const QUrl &url, QObject *parent) :
 	reload();
 }
 
+UserScript::~UserScript()
+{
+	invalidateIndex();
+}
+
 void UserScript::reload()
 {
 	m_source.clear();
@@ -55,9 +68,14 @@ void UserScript::reload()
 	m_excludeRules.clear();
 	m_includeRules.clear();
 	m_matchRules.clear();
+	m_compiledExcludeRules.clear();
+	m_compiledIncludeRules.clear();
+	m_compiledMatchRules.clear();
 	m_injectionTime = DocumentReadyTime;
 	m_shouldRunOnSubFrames = true;
 
+	invalidateIndex();
+
 	QFile file(m_path);
 
 	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
@@ -192,6 +210,8 @@ void UserScript::reload()
 
 	file.close();
 
+	compileRules();
+
 	if (m_title.isEmpty())
 	{
 		m_title = QFileInfo(file).completeBaseName();
@@ -275,47 +295,108 @@ QString UserScript::getSource()
 	return m_source;
 }
 
-QString UserScript::checkUrlSubString(const QString &rule, const QString &urlSubString, QString generatedUrl, int position) const
+void UserScript::compileRules()
 {
-	if (rule.isEmpty())
-	{
-		return urlSubString;
-	}
+	m_compiledExcludeRules = createRules(m_excludeRules, m_path);
+	m_compiledIncludeRules = createRules(m_includeRules, m_path);
+	m_compiledMatchRules = createRules(m_matchRules, m_path);
+}
+
+void UserScript::invalidateIndex()
+{
+	m_isIndexValid = false;
+
+	m_matchesCache.clear();
+}
+
+void UserScript::updateIndex()
+{
+	const QStringList scriptNames(AddonsManager::getAddons(Addon::UserScriptType));
 
-	for (int i = 0; i < urlSubString.length(); ++i)
+	m_indexedScripts.clear();
+	m_indexedScripts.reserve(scriptNames.count());
+	m_unindexedScripts.clear();
+	m_hostIndex.clear();
+	m_matchesCache.clear();
+	m_matchesCache.setMaxCost(MaximumCachedUrlsAmount);
+
+	for (int i = 0; i < scriptNames.count(); ++i)
 	{
-		const QChar character(urlSubString.at(i));
+		UserScript *script(AddonsManager::getUserScript(scriptNames.at(i)));
+
+		if (!script)
+		{
+			continue;
+		}
+
+		const QStringList rules(script->m_includeRules + script->m_matchRules);
+		const int index(m_indexedScripts.count());
+		QStringList hosts;
+		hosts.reserve(rules.count());
 
-		if (rule.at(position) == QLatin1Char('*'))
+		m_indexedScripts.append(script);
+
+		for (int j = 0; j < rules.count(); ++j)
 		{
-			const QString wildcardString(urlSubString.mid(i));
+			const QString host(getRuleHost(rules.at(j)));
 
-			for (int j = 1; j < wildcardString.length(); ++j)
+			if (host.isEmpty())
 			{
-				const QString result(checkUrlSubString(rule, urlSubString.right(wildcardString.length() - j), generatedUrl + wildcardString.left(j), (position + 1)));
+				hosts.clear();
 
-				if (!result.isEmpty())
-				{
-					return result;
-				}
+				break;
 			}
+
+			hosts.append(host);
 		}
-		else if (rule.at(position) != character)
+
+		if (hosts.isEmpty())
 		{
-			return {};
-		}
+			m_unindexedScripts.append(index);
 
-		++position;
+			continue;
+		}
 
-		generatedUrl += character;
+		hosts.removeDuplicates();
 
-		if (position == rule.length())
+		for (int j = 0; j < hosts.count(); ++j)
 		{
-			return generatedUrl;
+			m_hostIndex[hosts.at(j)].append(index);
 		}
 	}
 
-	return {};
+	m_isIndexValid = true;
+}
+
+QString UserScript::getRuleHost(const QString &rule)
+{
+	if (rule.startsWith(QLatin1Char('/')) && rule.endsWith(QLatin1Char('/')))
+	{
+		return {};
+	}
+
+	const int schemeEnd(rule.indexOf(QLatin1String("://")));
+
+	if (schemeEnd < 0)
+	{
+		return {};
+	}
+
+	const int hostStart(schemeEnd + 3);
+	const int hostEnd(rule.indexOf(QLatin1Char('/'), hostStart));
+	QString host(rule.mid(hostStart, ((hostEnd < 0) ? -1 : (hostEnd - hostStart))).toLower());
+
+	if (host.startsWith(QLatin1String("*.")))
+	{
+		host = host.mid(2);
+	}
+
+	if (host.contains(QLatin1Char('*')) || host.contains(QLatin1Char(':')) || host.contains(QLatin1Char('@')) || host.contains(QLatin1String(".tld")))
+	{
+		return {};
+	}
+
+	return host;
 }
 
 QUrl UserScript::getHomePage() const
@@ -348,16 +429,108 @@ QStringList UserScript::getMatchRules() const
 	return m_matchRules;
 }
 
+QVector<UserScript::UrlRule> UserScript::createRules(const QStringList &rules, const QString &path)
+{
+	QVector<UrlRule> compiledRules;
+	compiledRules.reserve(rules.count());
+
+	for (int i = 0; i < rules.count(); ++i)
+	{
+		const QString rule(rules.at(i));
+		UrlRule compiledRule;
+
+		if (rule.length() > 1 && rule.startsWith(QLatin1Char('/')) && rule.endsWith(QLatin1Char('/')))
+		{
+			compiledRule.type = RegularExpressionRule;
+			compiledRule.expression = QRegularExpression(rule.mid(1, (rule.length() - 2)));
+
+			if (!compiledRule.expression.isValid())
+			{
+				Console::addMessage(QCoreApplication::translate("main", "Invalid regular expression in User Script rule: %1").arg(rule), Console::OtherCategory, Console::ErrorLevel, path);
+
+				continue;
+			}
+
+			compiledRule.expression.optimize();
+		}
+		else
+		{
+			compiledRule.pattern = rule;
+			compiledRule.hasTopLevelDomain = rule.contains(QLatin1String(".tld"), Qt::CaseInsensitive);
+		}
+
+		compiledRules.append(compiledRule);
+	}
+
+	return compiledRules;
+}
+
+QVector<UserScript*> UserScript::getMatchingUserScripts(const QUrl &url)
+{
+	if (!m_isIndexValid)
+	{
+		updateIndex();
+	}
+
+	const QString key(url.toString());
+
+	if (m_matchesCache.contains(key))
+	{
+		return *m_matchesCache.object(key);
+	}
+
+	QVector<int> candidates(m_unindexedScripts);
+	QString host(url.host().toLower());
+
+	while (!host.isEmpty())
+	{
+		if (m_hostIndex.contains(host))
+		{
+			candidates.append(m_hostIndex[host]);
+		}
+
+		const int position(host.indexOf(QLatin1Char('.')));
+
+		if (position < 0)
+		{
+			break;
+		}
+
+		host = host.mid(position + 1);
+	}
+
+	std::sort(candidates.begin(), candidates.end());
+
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+	QVector<UserScript*> scripts;
+
+	for (int i = 0; i < candidates.count(); ++i)
+	{
+		UserScript *script(m_indexedScripts.at(candidates.at(i)));
+
+		if (script->isEnabledForUrl(url))
+		{
+			scripts.append(script);
+		}
+	}
+
+	m_matchesCache.insert(key, new QVector<UserScript*>(scripts));
+
+	return scripts;
+}
+
 QVector<UserScript*> UserScript::getUserScriptsForUrl(const QUrl &url, UserScript::InjectionTime injectionTime, bool isSubFrame)
 {
-	const QStringList scriptNames(AddonsManager::getAddons(Addon::UserScriptType));
+	const QVector<UserScript*> matchingScripts(getMatchingUserScripts(url));
 	QVector<UserScript*> scripts;
+	scripts.reserve(matchingScripts.count());
 
-	for (int i = 0; i < scriptNames.count(); ++i)
+	for (int i = 0; i < matchingScripts.count(); ++i)
 	{
-		UserScript *script(AddonsManager::getUserScript(scriptNames.at(i)));
+		UserScript *script(matchingScripts.at(i));
 
-		if (script->isEnabled() && (injectionTime == AnyTime || script->getInjectionTime() == injectionTime) && (!isSubFrame || script->shouldRunOnSubFrames()) && script->isEnabledForUrl(url))
+		if (script->isEnabled() && (injectionTime == AnyTime || script->getInjectionTime() == injectionTime) && (!isSubFrame || script->shouldRunOnSubFrames()))
 		{
 			scripts.append(script);
 		}
@@ -385,17 +558,17 @@ bool UserScript::isEnabledForUrl(const QUrl &url)
 
 	bool isEnabled(!(m_includeRules.length() > 0 || m_matchRules.length() > 0));
 
-	if (checkUrl(url, m_matchRules))
+	if (checkUrl(url, m_compiledMatchRules))
 	{
 		isEnabled = true;
 	}
 
-	if (!isEnabled && checkUrl(url, m_includeRules))
+	if (!isEnabled && checkUrl(url, m_compiledIncludeRules))
 	{
 		isEnabled = true;
 	}
 
-	if (isEnabled && checkUrl(url, m_excludeRules))
+	if (isEnabled && checkUrl(url, m_compiledExcludeRules))
 	{
 		isEnabled = false;
 	}
@@ -408,39 +581,78 @@ bool UserScript::canRemove() const
 	return true;
 }
 
-bool UserScript::checkUrl(const QUrl &url, const QStringList &rules) const
+bool UserScript::checkUrl(const QUrl &url, const QVector<UrlRule> &rules) const
 {
+	const QString urlString(url.url());
+
 	for (int i = 0; i < rules.count(); ++i)
 	{
-		QString rule(rules.at(i));
+		const UrlRule &rule(rules.at(i));
 
-		if (rule.startsWith(QLatin1Char('/')) && rule.endsWith(QLatin1Char('/')))
+		if (rule.type == RegularExpressionRule)
 		{
-			return QRegularExpression(rule.mid(1, rule.length() - 2)).match(url.url()).hasMatch();
+			if (rule.expression.match(urlString).hasMatch())
+			{
+				return true;
+			}
 		}
+		else if (rule.hasTopLevelDomain)
+		{
+			QString pattern(rule.pattern);
+			pattern.replace(QLatin1String(".tld"), url.topLevelDomain(), Qt::CaseInsensitive);
 
-		if (rule.contains(QLatin1String(".tld"), Qt::CaseInsensitive))
+			if (matchWildcard(pattern, urlString))
+			{
+				return true;
+			}
+		}
+		else if (matchWildcard(rule.pattern, urlString))
 		{
-			rule.replace(QLatin1String(".tld"), url.topLevelDomain(), Qt::CaseInsensitive);
+			return true;
 		}
+	}
 
-		bool useExactMatch(true);
+	return false;
+}
 
-		if (rule.endsWith(QLatin1Char('*')))
-		{
-			useExactMatch = false;
-			rule = rule.left(rule.length() - 1);
-		}
+bool UserScript::matchWildcard(const QString &pattern, const QString &text)
+{
+	int patternPosition(0);
+	int textPosition(0);
+	int wildcardPosition(-1);
+	int wildcardTextPosition(0);
 
-		const QString result(checkUrlSubString(rule, url.url(), {}));
+	while (textPosition < text.length())
+	{
+		if (patternPosition < pattern.length() && pattern.at(patternPosition) == QLatin1Char('*'))
+		{
+			wildcardPosition = patternPosition;
+			wildcardTextPosition = textPosition;
 
-		if (!result.isEmpty() && ((useExactMatch && url.url() == result) || (!useExactMatch && url.url().startsWith(result))))
+			++patternPosition;
+		}
+		else if (patternPosition < pattern.length() && pattern.at(patternPosition) == text.at(textPosition))
 		{
-			return true;
+			++patternPosition;
+			++textPosition;
+		}
+		else if (wildcardPosition >= 0)
+		{
+			patternPosition = (wildcardPosition + 1);
+			textPosition = ++wildcardTextPosition;
+		}
+		else
+		{
+			return false;
 		}
 	}
 
-	return false;
+	while (patternPosition < pattern.length() && pattern.at(patternPosition) == QLatin1Char('*'))
+	{
+		++patternPosition;
+	}
+
+	return (patternPosition == pattern.length());
 }
 
 bool UserScript::shouldRunOnSubFrames() const
@@ -23,6 +23,9 @@
 
 #include "AddonsManager.h"
 
+#include <QtCore/QCache>
+#include <QtCore/QRegularExpression>
+
 namespace Otter
 {
 
@@ -42,6 +45,7 @@ public:
 	};
 
 	explicit UserScript(const QString &path, const QUrl &url = {}, QObject *parent = nullptr);
+	~UserScript();
 
 	QString getName() const override;
 	QString getTitle() const override;
@@ -67,8 +71,33 @@ public slots:
 	void reload();
 
 protected:
-	QString checkUrlSubString(const QString &rule, const QString &urlSubString, QString generatedUrl, int position = 0) const;
-	bool checkUrl(const QUrl &url, const QStringList &rules) const;
+	enum RuleType
+	{
+		WildcardRule = 0,
+		RegularExpressionRule
+	};
+
+	enum MatchCacheLimit
+	{
+		MaximumCachedUrlsAmount = 100
+	};
+
+	struct UrlRule final
+	{
+		QString pattern;
+		QRegularExpression expression;
+		RuleType type = WildcardRule;
+		bool hasTopLevelDomain = false;
+	};
+
+	void compileRules();
+	static void invalidateIndex();
+	static void updateIndex();
+	static QString getRuleHost(const QString &rule);
+	static QVector<UrlRule> createRules(const QStringList &rules, const QString &path);
+	static QVector<UserScript*> getMatchingUserScripts(const QUrl &url);
+	bool checkUrl(const QUrl &url, const QVector<UrlRule> &rules) const;
+	static bool matchWildcard(const QString &pattern, const QString &text);
 
 private:
 	IconFetchJob *m_iconFetchJob;
@@ -85,9 +114,18 @@ private:
 	QStringList m_excludeRules;
 	QStringList m_includeRules;
 	QStringList m_matchRules;
+	QVector<UrlRule> m_compiledExcludeRules;
+	QVector<UrlRule> m_compiledIncludeRules;
+	QVector<UrlRule> m_compiledMatchRules;
 	InjectionTime m_injectionTime;
 	bool m_shouldRunOnSubFrames;
 
+	static QVector<UserScript*> m_indexedScripts;
+	static QVector<int> m_unindexedScripts;
+	static QHash<QString, QVector<int> > m_hostIndex;
+	static QCache<QString, QVector<UserScript*> > m_matchesCache;
+	static bool m_isIndexValid;
+
 signals:
 	void metaDataChanged();
 };
@@ -701,6 +701,34 @@ SaveInformation getSavePath(const QString &fileName, const QString &directory, Q
 	return information;
 }
 
+qint64 getProcessMemoryUsage(qint64 processIdentifier)
+{
+#ifdef Q_OS_LINUX
+	QFile file(QLatin1String("/proc/") + ((processIdentifier > 0) ? QString::number(processIdentifier) : QLatin1String("self")) + QLatin1String("/status"));
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return -1;
+	}
+
+	while (!file.atEnd())
+	{
+		const QByteArray line(file.readLine());
+
+		if (line.startsWith("VmRSS:"))
+		{
+			const QList<QByteArray> fields(line.mid(6).simplified().split(' '));
+
+			return (fields.isEmpty() ? -1 : (fields.first().toLongLong() * 1024));
+		}
+	}
+#else
+	Q_UNUSED(processIdentifier)
+#endif
+
+	return -1;
+}
+
 qreal calculatePercent(qint64 amount, qint64 total, int multiplier)
 {
 	return ((static_cast<qreal>(amount) / static_cast<qreal>(total)) * multiplier);
@@ -114,6 +114,7 @@ SaveInformation getSavePath(const QString &fileName, const QString &directory =
 QStringList getOpenPaths(const QStringList &fileNames = {}, QStringList filters = {}, bool selectMultiple = false);
 QVector<QUrl> extractUrls(const QMimeData *mimeData);
 QVector<ApplicationInformation> getApplicationsForMimeType(const QMimeType &mimeType);
+qint64 getProcessMemoryUsage(qint64 processIdentifier = 0);
 qreal calculatePercent(qint64 amount, qint64 total, int multiplier = 100);
 int calculateCharacterWidth(QChar character, const QFontMetrics &fontMetrics);
 int calculateTextWidth(const QString &text, const QFontMetrics &fontMetrics);
@@ -28,6 +28,11 @@ WebPageThumbnailJob::WebPageThumbnailJob(const QUrl &url, const QSize &size, QOb
 	Q_UNUSED(size)
 }
 
+QImage WebPageThumbnailJob::getThumbnailImage() const
+{
+	return getThumbnail().toImage();
+}
+
 WebBackend::WebBackend(QObject *parent) : QObject(parent)
 {
 }
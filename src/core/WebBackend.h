@@ -40,6 +40,7 @@ public:
 
 	virtual QString getTitle() const = 0;
 	virtual QPixmap getThumbnail() const = 0;
+	virtual QImage getThumbnailImage() const;
 };
 
 class WebBackend : public QObject, public Addon
@@ -170,15 +170,15 @@ void QtWebEnginePage::handleLoadFinished()
 		if (m_widget)
 		{
 			const QUrl url(m_widget->getUrl());
-			const ContentFiltersManager::CosmeticFiltersResult cosmeticFilters(ContentFiltersManager::getCosmeticFilters(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), url));
+			const ContentFiltersManager::CosmeticFiltersStyleSheet styleSheet(ContentFiltersManager::getCosmeticFiltersStyleSheet(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), url));
 
-			if (!cosmeticFilters.rules.isEmpty() || !cosmeticFilters.exceptions.isEmpty())
+			if (!styleSheet.genericStyleSheet.isEmpty() || !styleSheet.domainStyleSheet.isEmpty())
 			{
 				QFile file(QLatin1String(":/modules/backends/web/qtwebengine/resources/hideElements.js"));
 
 				if (file.open(QIODevice::ReadOnly))
 				{
-					runJavaScript(QString::fromLatin1(file.readAll()).arg(createJavaScriptList(cosmeticFilters.exceptions), createJavaScriptList(cosmeticFilters.rules)));
+					runJavaScript(QString::fromLatin1(file.readAll()).arg(createJavaScriptString(styleSheet.genericStyleSheet), createJavaScriptString(styleSheet.domainStyleSheet)));
 
 					file.close();
 				}
@@ -354,6 +354,19 @@ QString QtWebEnginePage::createJavaScriptList(const QStringList &rules) const
 	return QLatin1Char('\'') + parsedRules.join(QLatin1String("','")) + QLatin1Char('\'');
 }
 
+QString QtWebEnginePage::createJavaScriptString(const QString &string) const
+{
+	QString escapedString(string);
+	escapedString.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+	escapedString.replace(QLatin1Char('\''), QLatin1String("\\'"));
+	escapedString.replace(QLatin1Char('\n'), QLatin1String("\\n"));
+	escapedString.replace(QLatin1Char('\r'), QLatin1String("\\r"));
+	escapedString.replace(QChar(0x2028), QLatin1String("\\u2028"));
+	escapedString.replace(QChar(0x2029), QLatin1String("\\u2029"));
+
+	return escapedString;
+}
+
 QString QtWebEnginePage::createScriptSource(const QString &path, const QStringList &parameters) const
 {
 	QFile file(QLatin1String(":/modules/backends/web/qtwebengine/resources/") + path + QLatin1String(".js"));
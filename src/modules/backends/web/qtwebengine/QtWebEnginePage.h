@@ -72,6 +72,7 @@ protected:
 	QWebEnginePage* createWindow(WebWindowType type) override;
 	QtWebEngineWebWidget* createWidget(SessionsManager::OpenHints hints);
 	QString createJavaScriptList(const QStringList &rules) const;
+	QString createJavaScriptString(const QString &string) const;
 	QStringList chooseFiles(FileSelectionMode mode, const QStringList &oldFiles, const QStringList &acceptedMimeTypes) override;
 	bool acceptNavigationRequest(const QUrl &url, NavigationType type, bool isMainFrame) override;
 #if QTWEBENGINECORE_VERSION >= 0x050E00
@@ -98,9 +98,9 @@ void QtWebEngineUrlRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo
 
 		if (result.isBlocked)
 		{
-			const ContentFiltersProfile *profile(ContentFiltersManager::getProfile(result.profile));
+			const QString profileTitle(ContentFiltersManager::getProfileTitle(result.profile));
 
-			Console::addMessage(QCoreApplication::translate("main", "Request blocked by rule from profile %1:\n%2").arg(profile ? profile->getTitle() : QCoreApplication::translate("main", "(Unknown)"), result.rule), Console::NetworkCategory, Console::LogLevel, request.requestUrl().toString(), -1);
+			Console::addMessage(QCoreApplication::translate("main", "Request blocked by rule from profile %1:\n%2").arg((profileTitle.isEmpty() ? QCoreApplication::translate("main", "(Unknown)") : profileTitle), result.rule), Console::NetworkCategory, Console::LogLevel, request.requestUrl().toString(), -1);
 
 			if (storeBlockedUrl && !m_blockedElements.contains(request.requestUrl().url()))
 			{
@@ -331,9 +331,9 @@ void QtWebEngineUrlRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo
 
 		if (result.isBlocked)
 		{
-			const ContentFiltersProfile *profile(ContentFiltersManager::getProfile(result.profile));
+			const QString profileTitle(ContentFiltersManager::getProfileTitle(result.profile));
 
-			Console::addMessage(QCoreApplication::translate("main", "Request blocked by rule from profile %1:\n%2").arg((profile ? profile->getTitle() : QCoreApplication::translate("main", "(Unknown)")), result.rule), Console::NetworkCategory, Console::LogLevel, request.requestUrl().toString(), -1);
+			Console::addMessage(QCoreApplication::translate("main", "Request blocked by rule from profile %1:\n%2").arg((profileTitle.isEmpty() ? QCoreApplication::translate("main", "(Unknown)") : profileTitle), result.rule), Console::NetworkCategory, Console::LogLevel, request.requestUrl().toString(), -1);
 
 			if (storeBlockedUrl && !m_blockedElements.value(request.firstPartyUrl().host()).contains(request.requestUrl().url()))
 			{
@@ -1780,6 +1780,15 @@ WebWidget::LoadingState QtWebEngineWebWidget::getLoadingState() const
 	return m_loadingState;
 }
 
+#if QTWEBENGINECORE_VERSION >= 0x050F00
+qint64 QtWebEngineWebWidget::getProcessIdentifier() const
+{
+	const qint64 processIdentifier(m_page->renderProcessPid());
+
+	return ((processIdentifier > 0) ? processIdentifier : WebWidget::getProcessIdentifier());
+}
+#endif
+
 int QtWebEngineWebWidget::getZoom() const
 {
 	return static_cast<int>(m_page->zoomFactor() * 100);
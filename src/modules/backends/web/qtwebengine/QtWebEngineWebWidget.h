@@ -94,6 +94,9 @@ public:
 #endif
 	QMultiMap<QString, QString> getMetaData() const override;
 	LoadingState getLoadingState() const override;
+#if QTWEBENGINECORE_VERSION >= 0x050F00
+	qint64 getProcessIdentifier() const override;
+#endif
 	int getZoom() const override;
 	bool hasSelection() const override;
 	bool hasWatchedChanges(ChangeWatcher watcher) const override;
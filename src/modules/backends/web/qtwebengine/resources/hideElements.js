@@ -1,41 +1,12 @@
-let whitelist = [%1];
-let blacklist = [%2];
-let ignoredElements = [];
+let styleSheets = ['%1', '%2'];
 
-for (let i = 0; i < whitelist.length; ++i)
+for (let i = 0; i < styleSheets.length; ++i)
 {
-	try
+	if (styleSheets[i].length > 0)
 	{
-		ignoredElements = ignoredElements.concat(Array.from(document.querySelectorAll(whitelist[i])));
-	}
-	catch (e)
-	{
-		console.error('Invalid selector: ' + whitelist[i]);
-
-		continue;
-	}
-}
-
-for (let i = 0; i < blacklist.length; ++i)
-{
-	let elements = [];
+		let element = document.createElement('style');
+		element.textContent = styleSheets[i];
 
-	try
-	{
-		elements = document.querySelectorAll(blacklist[i]);
-	}
-	catch (e)
-	{
-		console.error('Invalid selector: ' + blacklist[i]);
-
-		continue;
-	}
-
-	for (let j = 0; j < elements.length; ++j)
-	{
-		if (ignoredElements.indexOf(elements[j]) < 0)
-		{
-			elements[j].style.cssText = 'display:none !important';
-		}
+		(document.head || document.documentElement).appendChild(element);
 	}
 }
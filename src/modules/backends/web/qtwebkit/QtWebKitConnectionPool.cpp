@@ -0,0 +1,461 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "QtWebKitConnectionPool.h"
+#include "QtWebKitNetworkManager.h"
+#include "../../../../core/NetworkCache.h"
+#include "../../../../core/NetworkManagerFactory.h"
+#include "../../../../core/SettingsManager.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+#include <QtNetwork/QNetworkProxyFactory>
+
+namespace Otter
+{
+
+QtWebKitQueuedNetworkReply::QtWebKitQueuedNetworkReply(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QIODevice *outgoingData, QObject *parent) : QNetworkReply(parent),
+	m_outgoingData(outgoingData),
+	m_readBufferSize(0),
+	m_hasSslConfiguration(false),
+	m_ignoresSslErrors(false)
+{
+	setOperation(operation);
+	setRequest(request);
+	setUrl(request.url());
+	open(ReadOnly | Unbuffered);
+}
+
+void QtWebKitQueuedNetworkReply::abort()
+{
+	if (m_reply)
+	{
+		m_reply->abort();
+
+		return;
+	}
+
+	if (isFinished())
+	{
+		return;
+	}
+
+	setError(OperationCanceledError, tr("Operation canceled"));
+	setFinished(true);
+
+	QTimer::singleShot(0, this, [&]()
+	{
+		emit error(OperationCanceledError);
+		emit finished();
+	});
+}
+
+void QtWebKitQueuedNetworkReply::ignoreSslErrors()
+{
+	m_ignoresSslErrors = true;
+
+	if (m_reply)
+	{
+		m_reply->ignoreSslErrors();
+	}
+}
+
+void QtWebKitQueuedNetworkReply::ignoreSslErrorsImplementation(const QList<QSslError> &errors)
+{
+	m_ignoredSslErrors = errors;
+
+	if (m_reply)
+	{
+		m_reply->ignoreSslErrors(errors);
+	}
+}
+
+void QtWebKitQueuedNetworkReply::setSslConfigurationImplementation(const QSslConfiguration &configuration)
+{
+	m_sslConfiguration = configuration;
+	m_hasSslConfiguration = true;
+
+	if (m_reply)
+	{
+		m_reply->setSslConfiguration(configuration);
+	}
+}
+
+void QtWebKitQueuedNetworkReply::sslConfigurationImplementation(QSslConfiguration &configuration) const
+{
+	configuration = (m_reply ? m_reply->sslConfiguration() : m_sslConfiguration);
+}
+
+void QtWebKitQueuedNetworkReply::handleError(QNetworkReply::NetworkError code)
+{
+	if (m_reply)
+	{
+		setError(code, m_reply->errorString());
+	}
+
+	emit error(code);
+}
+
+void QtWebKitQueuedNetworkReply::handleFinished()
+{
+	updateMetaData();
+	setFinished(true);
+
+	emit finished();
+}
+
+void QtWebKitQueuedNetworkReply::updateMetaData()
+{
+	if (!m_reply)
+	{
+		return;
+	}
+
+	const QList<QNetworkReply::RawHeaderPair> headers(m_reply->rawHeaderPairs());
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		setRawHeader(headers.at(i).first, headers.at(i).second);
+	}
+
+	const QVector<QNetworkRequest::Attribute> attributes({QNetworkRequest::HttpStatusCodeAttribute, QNetworkRequest::HttpReasonPhraseAttribute, QNetworkRequest::RedirectionTargetAttribute, QNetworkRequest::ConnectionEncryptedAttribute, QNetworkRequest::SourceIsFromCacheAttribute, QNetworkRequest::HttpPipeliningWasUsedAttribute, QNetworkRequest::SpdyWasUsedAttribute
+#if QT_VERSION >= 0x050900
+	, QNetworkRequest::HTTP2WasUsedAttribute
+#endif
+	});
+
+	for (int i = 0; i < attributes.count(); ++i)
+	{
+		const QVariant value(m_reply->attribute(attributes.at(i)));
+
+		if (!value.isNull())
+		{
+			setAttribute(attributes.at(i), value);
+		}
+	}
+
+	setUrl(m_reply->url());
+}
+
+void QtWebKitQueuedNetworkReply::setReadBufferSize(qint64 size)
+{
+	QNetworkReply::setReadBufferSize(size);
+
+	m_readBufferSize = size;
+
+	if (m_reply)
+	{
+		m_reply->setReadBufferSize(size);
+	}
+}
+
+void QtWebKitQueuedNetworkReply::setReply(QNetworkReply *reply)
+{
+	m_reply = reply;
+
+	if (m_readBufferSize > 0)
+	{
+		reply->setReadBufferSize(m_readBufferSize);
+	}
+
+	if (m_hasSslConfiguration)
+	{
+		reply->setSslConfiguration(m_sslConfiguration);
+	}
+
+	if (m_ignoresSslErrors)
+	{
+		reply->ignoreSslErrors();
+	}
+	else if (!m_ignoredSslErrors.isEmpty())
+	{
+		reply->ignoreSslErrors(m_ignoredSslErrors);
+	}
+
+	connect(reply, &QNetworkReply::metaDataChanged, this, [&]()
+	{
+		updateMetaData();
+
+		emit metaDataChanged();
+	});
+	connect(reply, &QNetworkReply::readyRead, this, &QtWebKitQueuedNetworkReply::readyRead);
+	connect(reply, &QNetworkReply::downloadProgress, this, &QtWebKitQueuedNetworkReply::downloadProgress);
+	connect(reply, &QNetworkReply::uploadProgress, this, &QtWebKitQueuedNetworkReply::uploadProgress);
+	connect(reply, &QNetworkReply::encrypted, this, &QtWebKitQueuedNetworkReply::encrypted);
+	connect(reply, &QNetworkReply::sslErrors, this, &QtWebKitQueuedNetworkReply::sslErrors);
+	connect(reply, static_cast<void(QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), this, &QtWebKitQueuedNetworkReply::handleError);
+	connect(reply, &QNetworkReply::finished, this, &QtWebKitQueuedNetworkReply::handleFinished);
+}
+
+QIODevice* QtWebKitQueuedNetworkReply::getOutgoingData() const
+{
+	return m_outgoingData;
+}
+
+qint64 QtWebKitQueuedNetworkReply::bytesAvailable() const
+{
+	return (QNetworkReply::bytesAvailable() + (m_reply ? m_reply->bytesAvailable() : 0));
+}
+
+qint64 QtWebKitQueuedNetworkReply::readData(char *data, qint64 maxSize)
+{
+	if (m_reply)
+	{
+		return m_reply->read(data, maxSize);
+	}
+
+	return (isFinished() ? -1 : 0);
+}
+
+bool QtWebKitQueuedNetworkReply::isSequential() const
+{
+	return true;
+}
+
+QtWebKitConnectionPool* QtWebKitConnectionPool::m_instance(nullptr);
+QtWebKitConnectionPool* QtWebKitConnectionPool::m_privateInstance(nullptr);
+
+QtWebKitConnectionPool::QtWebKitConnectionPool(bool isPrivate, QObject *parent) : QNetworkAccessManager(parent)
+{
+	NetworkManagerFactory::initialize();
+
+	if (!isPrivate)
+	{
+		QNetworkDiskCache *cache(NetworkManagerFactory::getCache());
+
+		setCache(cache);
+
+		cache->setParent(QCoreApplication::instance());
+	}
+
+	connect(this, &QtWebKitConnectionPool::authenticationRequired, this, &QtWebKitConnectionPool::handleAuthenticationRequired);
+	connect(this, &QtWebKitConnectionPool::proxyAuthenticationRequired, this, &QtWebKitConnectionPool::handleProxyAuthenticationRequired);
+	connect(this, &QtWebKitConnectionPool::sslErrors, this, &QtWebKitConnectionPool::handleSslErrors);
+	connect(NetworkManagerFactory::getInstance(), &NetworkManagerFactory::onlineStateChanged, this, &QtWebKitConnectionPool::handleOnlineStateChanged);
+}
+
+void QtWebKitConnectionPool::startQueuedRequests(const QString &host)
+{
+	QHash<QString, QQueue<QueuedRequest> >::iterator iterator(m_queuedRequests.find(host));
+
+	if (iterator == m_queuedRequests.end())
+	{
+		return;
+	}
+
+	while (!iterator.value().isEmpty())
+	{
+		const QueuedRequest &request(iterator.value().head());
+
+		if (request.reply && !request.reply->isFinished() && m_activeReplies.value(host) >= getRequestsLimit(request.reply->url()))
+		{
+			break;
+		}
+
+		const QueuedRequest queuedRequest(iterator.value().dequeue());
+
+		if (queuedRequest.reply && !queuedRequest.reply->isFinished())
+		{
+			startRequest(queuedRequest.manager, queuedRequest.reply->operation(), queuedRequest.reply->request(), queuedRequest.reply->getOutgoingData(), queuedRequest.reply);
+		}
+	}
+
+	if (iterator.value().isEmpty())
+	{
+		m_queuedRequests.erase(iterator);
+	}
+}
+
+void QtWebKitConnectionPool::releaseReply(QNetworkReply *reply)
+{
+	const QHash<QNetworkReply*, ReplyInformation>::iterator iterator(m_replies.find(reply));
+
+	if (iterator == m_replies.end())
+	{
+		return;
+	}
+
+	const QString host(iterator.value().host);
+
+	m_replies.erase(iterator);
+
+	if (--m_activeReplies[host] <= 0)
+	{
+		m_activeReplies.remove(host);
+	}
+
+	startQueuedRequests(host);
+}
+
+void QtWebKitConnectionPool::handleReplyFinished()
+{
+	releaseReply(qobject_cast<QNetworkReply*>(sender()));
+}
+
+void QtWebKitConnectionPool::handleReplyDestroyed(QObject *object)
+{
+	releaseReply(static_cast<QNetworkReply*>(object));
+}
+
+void QtWebKitConnectionPool::handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator)
+{
+	const ReplyInformation information(m_replies.value(reply));
+
+	if (information.manager)
+	{
+		information.manager->handleAuthenticationRequired(reply, authenticator);
+	}
+}
+
+void QtWebKitConnectionPool::handleProxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator)
+{
+	QtWebKitNetworkManager *manager(nullptr);
+	QHash<QNetworkReply*, ReplyInformation>::const_iterator iterator;
+
+	for (iterator = m_replies.constBegin(); iterator != m_replies.constEnd(); ++iterator)
+	{
+		const ReplyInformation &information(iterator.value());
+
+		if (!information.manager || !information.reply || information.reply->isFinished())
+		{
+			continue;
+		}
+
+		const QList<QNetworkProxy> proxies(QNetworkProxyFactory::proxyForQuery(QNetworkProxyQuery(information.reply->url())));
+
+		for (int i = 0; i < proxies.count(); ++i)
+		{
+			if (proxies.at(i).hostName() == proxy.hostName() && proxies.at(i).port() == proxy.port())
+			{
+				information.manager->handleProxyAuthenticationRequired(proxy, authenticator);
+
+				return;
+			}
+		}
+
+		if (!manager)
+		{
+			manager = information.manager;
+		}
+	}
+
+	if (manager)
+	{
+		manager->handleProxyAuthenticationRequired(proxy, authenticator);
+	}
+}
+
+void QtWebKitConnectionPool::handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors)
+{
+	const ReplyInformation information(m_replies.value(reply));
+
+	if (information.manager && information.reply)
+	{
+		information.manager->handleSslErrors(information.reply, errors);
+	}
+}
+
+void QtWebKitConnectionPool::handleOnlineStateChanged(bool isOnline)
+{
+	if (isOnline)
+	{
+		setNetworkAccessible(Accessible);
+	}
+}
+
+QtWebKitConnectionPool* QtWebKitConnectionPool::getInstance(bool isPrivate)
+{
+	if (isPrivate)
+	{
+		if (!m_privateInstance)
+		{
+			m_privateInstance = new QtWebKitConnectionPool(true, QCoreApplication::instance());
+		}
+
+		return m_privateInstance;
+	}
+
+	if (!m_instance)
+	{
+		m_instance = new QtWebKitConnectionPool(false, QCoreApplication::instance());
+	}
+
+	return m_instance;
+}
+
+QNetworkReply* QtWebKitConnectionPool::createReply(QtWebKitNetworkManager *manager, Operation operation, const QNetworkRequest &request, QIODevice *outgoingData)
+{
+	const QString host(getHost(request.url()));
+	bool isMultiplexed(false);
+
+#if QT_VERSION >= 0x050900
+	isMultiplexed = request.attribute(QNetworkRequest::HTTP2AllowedAttribute).toBool();
+#endif
+
+	if (isMultiplexed || (m_activeReplies.value(host) < getRequestsLimit(request.url()) && !m_queuedRequests.contains(host)))
+	{
+		return startRequest(manager, operation, request, outgoingData);
+	}
+
+	QtWebKitQueuedNetworkReply *reply(new QtWebKitQueuedNetworkReply(operation, request, outgoingData, this));
+	QueuedRequest queuedRequest;
+	queuedRequest.manager = manager;
+	queuedRequest.reply = reply;
+
+	m_queuedRequests[host].enqueue(queuedRequest);
+
+	return reply;
+}
+
+QNetworkReply* QtWebKitConnectionPool::startRequest(QtWebKitNetworkManager *manager, Operation operation, const QNetworkRequest &request, QIODevice *outgoingData, QtWebKitQueuedNetworkReply *queuedReply)
+{
+	QNetworkReply *reply(QNetworkAccessManager::createRequest(operation, request, outgoingData));
+	ReplyInformation information;
+	information.manager = manager;
+	information.reply = (queuedReply ? static_cast<QNetworkReply*>(queuedReply) : reply);
+	information.host = getHost(request.url());
+
+	m_replies[reply] = information;
+
+	++m_activeReplies[information.host];
+
+	if (queuedReply)
+	{
+		queuedReply->setReply(reply);
+
+		connect(queuedReply, &QtWebKitQueuedNetworkReply::destroyed, reply, &QNetworkReply::deleteLater);
+	}
+
+	connect(reply, &QNetworkReply::finished, this, &QtWebKitConnectionPool::handleReplyFinished);
+	connect(reply, &QNetworkReply::destroyed, this, &QtWebKitConnectionPool::handleReplyDestroyed);
+
+	return reply;
+}
+
+QString QtWebKitConnectionPool::getHost(const QUrl &url)
+{
+	return QStringLiteral("%1://%2:%3").arg(url.scheme(), url.host().toLower()).arg(url.port((url.scheme() == QLatin1String("https")) ? 443 : 80));
+}
+
+int QtWebKitConnectionPool::getRequestsLimit(const QUrl &url)
+{
+	return qMax(1, SettingsManager::getOption(SettingsManager::Network_MaximumConnectionsPerHostOption, url.host()).toInt());
+}
+
+}
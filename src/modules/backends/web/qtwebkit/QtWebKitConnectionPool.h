@@ -0,0 +1,122 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2020 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_QTWEBKITCONNECTIONPOOL_H
+#define OTTER_QTWEBKITCONNECTIONPOOL_H
+
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QSslConfiguration>
+#include <QtNetwork/QSslError>
+
+namespace Otter
+{
+
+class QtWebKitNetworkManager;
+
+class QtWebKitQueuedNetworkReply final : public QNetworkReply
+{
+	Q_OBJECT
+
+public:
+	explicit QtWebKitQueuedNetworkReply(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QIODevice *outgoingData, QObject *parent);
+
+	void setReadBufferSize(qint64 size) override;
+	void setReply(QNetworkReply *reply);
+	QIODevice* getOutgoingData() const;
+	qint64 bytesAvailable() const override;
+	bool isSequential() const override;
+
+public slots:
+	void abort() override;
+	void ignoreSslErrors() override;
+
+protected:
+	void ignoreSslErrorsImplementation(const QList<QSslError> &errors) override;
+	void setSslConfigurationImplementation(const QSslConfiguration &configuration) override;
+	void sslConfigurationImplementation(QSslConfiguration &configuration) const override;
+	void updateMetaData();
+	qint64 readData(char *data, qint64 maxSize) override;
+
+protected slots:
+	void handleError(QNetworkReply::NetworkError code);
+	void handleFinished();
+
+private:
+	QPointer<QNetworkReply> m_reply;
+	QIODevice *m_outgoingData;
+	QSslConfiguration m_sslConfiguration;
+	QList<QSslError> m_ignoredSslErrors;
+	qint64 m_readBufferSize;
+	bool m_hasSslConfiguration;
+	bool m_ignoresSslErrors;
+};
+
+class QtWebKitConnectionPool final : public QNetworkAccessManager
+{
+	Q_OBJECT
+
+public:
+	static QtWebKitConnectionPool* getInstance(bool isPrivate);
+	QNetworkReply* createReply(QtWebKitNetworkManager *manager, Operation operation, const QNetworkRequest &request, QIODevice *outgoingData);
+
+protected:
+	struct ReplyInformation final
+	{
+		QPointer<QtWebKitNetworkManager> manager;
+		QPointer<QNetworkReply> reply;
+		QString host;
+	};
+
+	struct QueuedRequest final
+	{
+		QPointer<QtWebKitNetworkManager> manager;
+		QPointer<QtWebKitQueuedNetworkReply> reply;
+	};
+
+	explicit QtWebKitConnectionPool(bool isPrivate, QObject *parent);
+
+	void startQueuedRequests(const QString &host);
+	void releaseReply(QNetworkReply *reply);
+	QNetworkReply* startRequest(QtWebKitNetworkManager *manager, Operation operation, const QNetworkRequest &request, QIODevice *outgoingData, QtWebKitQueuedNetworkReply *queuedReply = nullptr);
+	static QString getHost(const QUrl &url);
+	static int getRequestsLimit(const QUrl &url);
+
+protected slots:
+	void handleReplyFinished();
+	void handleReplyDestroyed(QObject *object);
+	void handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator);
+	void handleProxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
+	void handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors);
+	void handleOnlineStateChanged(bool isOnline);
+
+private:
+	QHash<QNetworkReply*, ReplyInformation> m_replies;
+	QHash<QString, QQueue<QueuedRequest> > m_queuedRequests;
+	QHash<QString, int> m_activeReplies;
+
+	static QtWebKitConnectionPool *m_instance;
+	static QtWebKitConnectionPool *m_privateInstance;
+};
+
+}
+
+#endif
@@ -20,6 +20,7 @@
 **************************************************************************/
 
 #include "QtWebKitNetworkManager.h"
+#include "QtWebKitConnectionPool.h"
 #include "QtWebKitCookieJar.h"
 #include "QtWebKitFtpListingNetworkReply.h"
 #include "QtWebKitPage.h"
@@ -44,6 +45,7 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QMimeDatabase>
+#include <QtNetwork/QNetworkCookie>
 #include <QtNetwork/QNetworkProxy>
 #include <QtNetwork/QNetworkReply>
 
@@ -51,6 +53,7 @@ namespace Otter
 {
 
 WebBackend* QtWebKitNetworkManager::m_backend(nullptr);
+QHash<QString, QDateTime> QtWebKitNetworkManager::m_http2IncompatibleHosts;
 
 QtWebKitNetworkManager::QtWebKitNetworkManager(bool isPrivate, QtWebKitCookieJar *cookieJarProxy, QtWebKitWebWidget *parent) : QNetworkAccessManager(parent),
 	m_widget(parent),
@@ -134,7 +137,7 @@ void QtWebKitNetworkManager::resetStatistics()
 	m_blockedRequests.clear();
 	m_replies.clear();
 	m_headers.clear();
-	m_pageInformation = {{WebWidget::DocumentBytesReceivedInformation, quint64(0)}, {WebWidget::DocumentBytesTotalInformation, quint64(0)}, {WebWidget::TotalBytesReceivedInformation, quint64(0)}, {WebWidget::TotalBytesTotalInformation, quint64(0)}, {WebWidget::RequestsFinishedInformation, 0}, {WebWidget::RequestsStartedInformation, 0}};
+	m_pageInformation = {{WebWidget::DocumentBytesReceivedInformation, quint64(0)}, {WebWidget::DocumentBytesTotalInformation, quint64(0)}, {WebWidget::TotalBytesReceivedInformation, quint64(0)}, {WebWidget::TotalBytesTotalInformation, quint64(0)}, {WebWidget::RequestsFinishedInformation, 0}, {WebWidget::RequestsMultiplexedInformation, 0}, {WebWidget::RequestsStartedInformation, 0}};
 	m_baseReply = nullptr;
 	m_contentState = WebWidget::UnknownContentState;
 	m_isSecureValue = UnknownValue;
@@ -226,8 +229,35 @@ void QtWebKitNetworkManager::handleRequestFinished(QNetworkReply *reply)
 
 	setPageInformation(WebWidget::RequestsFinishedInformation, (m_pageInformation[WebWidget::RequestsFinishedInformation].toInt() + 1));
 
+	const bool isHttp(url.scheme() == QLatin1String("http") || url.scheme() == QLatin1String("https"));
+	bool isMultiplexed(false);
+
+#if QT_VERSION >= 0x050900
+	isMultiplexed = reply->attribute(QNetworkRequest::HTTP2WasUsedAttribute).toBool();
+
+	if (isMultiplexed)
+	{
+		setPageInformation(WebWidget::RequestsMultiplexedInformation, (m_pageInformation[WebWidget::RequestsMultiplexedInformation].toInt() + 1));
+	}
+
+	if (reply->request().attribute(QNetworkRequest::HTTP2AllowedAttribute).toBool())
+	{
+		if (reply->error() == QNetworkReply::ProtocolFailure && !isHttp2Incompatible(url.host()))
+		{
+			m_http2IncompatibleHosts[url.host()] = QDateTime::currentDateTimeUtc().addSecs(1800);
+
+			Console::addMessage(QCoreApplication::translate("main", "HTTP/2 request to %1 failed, falling back to HTTP/1.1 for this host").arg(url.host()), Console::NetworkCategory, Console::WarningLevel, url.toString(), -1, (m_widget ? m_widget->getWindowIdentifier() : 0));
+		}
+	}
+#endif
+
 	if (reply == m_baseReply)
 	{
+		if (isHttp && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid() && !reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool())
+		{
+			setPageInformation(WebWidget::DocumentProtocolInformation, (isMultiplexed ? QLatin1String("HTTP/2") : QLatin1String("HTTP/1.1")));
+		}
+
 		if (reply->sslConfiguration().isNull())
 		{
 			m_sslInformation.certificates = {};
@@ -715,7 +745,7 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(Operation operation, const
 	mutableRequest.setRawHeader(QByteArrayLiteral("Accept-Language"), (m_acceptLanguage.isEmpty() ? NetworkManagerFactory::getAcceptLanguage().toLatin1() : m_acceptLanguage.toLatin1()));
 	mutableRequest.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
 #if QT_VERSION >= 0x050900
-	mutableRequest.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, false);
+	mutableRequest.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, (request.url().scheme() == QLatin1String("https") && !isHttp2Incompatible(request.url().host()) && getOption(SettingsManager::Network_EnableHttp2Option, request.url()).toBool()));
 #endif
 
 	setPageInformation(WebWidget::LoadingMessageInformation, tr("Sending request to %1…").arg(request.url().host()));
@@ -758,6 +788,43 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(Operation operation, const
 			}
 		}
 	}
+	else if (!m_proxyFactory && (request.url().scheme() == QLatin1String("http") || request.url().scheme() == QLatin1String("https")))
+	{
+		const bool needsCookiesSaving(request.attribute(QNetworkRequest::CookieSaveControlAttribute, QNetworkRequest::Automatic).toInt() == QNetworkRequest::Automatic);
+
+		if (request.attribute(QNetworkRequest::CookieLoadControlAttribute, QNetworkRequest::Automatic).toInt() == QNetworkRequest::Automatic && mutableRequest.header(QNetworkRequest::CookieHeader).isNull())
+		{
+			const QList<QNetworkCookie> cookies(m_cookieJarProxy->cookiesForUrl(request.url()));
+
+			if (!cookies.isEmpty())
+			{
+				mutableRequest.setHeader(QNetworkRequest::CookieHeader, QVariant::fromValue(cookies));
+			}
+		}
+
+		mutableRequest.setAttribute(QNetworkRequest::CookieLoadControlAttribute, QNetworkRequest::Manual);
+		mutableRequest.setAttribute(QNetworkRequest::CookieSaveControlAttribute, QNetworkRequest::Manual);
+
+		reply = QtWebKitConnectionPool::getInstance(cache() == nullptr)->createReply(this, operation, mutableRequest, outgoingData);
+
+		if (needsCookiesSaving)
+		{
+			connect(reply, &QNetworkReply::metaDataChanged, this, [=]()
+			{
+				const QList<QNetworkCookie> cookies(reply->header(QNetworkRequest::SetCookieHeader).value<QList<QNetworkCookie> >());
+
+				if (!cookies.isEmpty())
+				{
+					m_cookieJarProxy->setCookiesFromUrl(cookies, reply->url());
+				}
+			});
+		}
+
+		connect(reply, &QNetworkReply::finished, this, [=]()
+		{
+			handleRequestFinished(reply);
+		});
+	}
 	else
 	{
 		reply = QNetworkAccessManager::createRequest(operation, mutableRequest, outgoingData);
@@ -851,4 +918,23 @@ WebWidget::ContentStates QtWebKitNetworkManager::getContentState() const
 	return m_contentState;
 }
 
+bool QtWebKitNetworkManager::isHttp2Incompatible(const QString &host)
+{
+	const QHash<QString, QDateTime>::iterator iterator(m_http2IncompatibleHosts.find(host));
+
+	if (iterator == m_http2IncompatibleHosts.end())
+	{
+		return false;
+	}
+
+	if (iterator.value() > QDateTime::currentDateTimeUtc())
+	{
+		return true;
+	}
+
+	m_http2IncompatibleHosts.erase(iterator);
+
+	return false;
+}
+
 }
@@ -65,6 +65,7 @@ protected:
 	QNetworkReply* createRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData) override;
 	QString getUserAgent() const;
 	QVariant getOption(int identifier, const QUrl &url) const;
+	static bool isHttp2Incompatible(const QString &host);
 
 protected slots:
 	void handleDownloadProgress(qint64 bytesReceived, qint64 bytesTotal);
@@ -105,12 +106,14 @@ private:
 	bool m_canSendReferrer;
 
 	static WebBackend *m_backend;
+	static QHash<QString, QDateTime> m_http2IncompatibleHosts;
 
 signals:
 	void pageInformationChanged(WebWidget::PageInformation, const QVariant &value);
 	void requestBlocked(const NetworkManager::ResourceInformation &request);
 	void contentStateChanged(WebWidget::ContentStates state);
 
+friend class QtWebKitConnectionPool;
 friend class QtWebKitPage;
 friend class QtWebKitWebWidget;
 };
@@ -63,20 +63,22 @@ void QtWebKitFrame::runUserScripts(const QUrl &url) const
 	}
 }
 
-void QtWebKitFrame::applyContentBlockingRules(const QStringList &rules, bool isHiding)
+void QtWebKitFrame::applyContentBlockingStyleSheet(const QString &styleSheet)
 {
-	const QString value(isHiding ? QLatin1String("none !important") : QString());
-	const QWebElementCollection elements(m_frame->documentElement().findAll(rules.join(QLatin1Char(','))));
-
-	for (int i = 0; i < elements.count(); ++i)
+	if (styleSheet.isEmpty())
 	{
-		QWebElement element(elements.at(i));
+		return;
+	}
 
-		if (!element.isNull())
-		{
-			element.setStyleProperty(QLatin1String("display"), value);
-		}
+	QWebElement element(m_frame->findFirstElement(QLatin1String("head")));
+
+	if (element.isNull())
+	{
+		element = m_frame->documentElement();
 	}
+
+	element.appendInside(QLatin1String("<style></style>"));
+	element.lastChild().setPlainText(styleSheet);
 }
 
 void QtWebKitFrame::handleIsDisplayingErrorPageChanged(QWebFrame *frame, bool isDisplayingErrorPage)
@@ -126,10 +128,10 @@ void QtWebKitFrame::handleLoadFinished()
 		return;
 	}
 
-	const ContentFiltersManager::CosmeticFiltersResult cosmeticFilters(ContentFiltersManager::getCosmeticFilters(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), m_widget->getUrl()));
+	const ContentFiltersManager::CosmeticFiltersStyleSheet styleSheet(ContentFiltersManager::getCosmeticFiltersStyleSheet(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), m_widget->getUrl()));
 
-	applyContentBlockingRules(cosmeticFilters.rules, true);
-	applyContentBlockingRules(cosmeticFilters.exceptions, false);
+	applyContentBlockingStyleSheet(styleSheet.genericStyleSheet);
+	applyContentBlockingStyleSheet(styleSheet.domainStyleSheet);
 
 	const QStringList blockedRequests(m_widget->getBlockedElements());
 
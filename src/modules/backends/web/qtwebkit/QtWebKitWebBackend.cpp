@@ -532,19 +532,14 @@ void QtWebKitWebPageThumbnailJob::handlePageLoadFinished(bool result)
 
 		if (!contentsSize.isNull())
 		{
-			m_pixmap = QPixmap(contentsSize);
-			m_pixmap.fill(Qt::white);
+			m_image = QImage(contentsSize, QImage::Format_RGB32);
+			m_image.fill(Qt::white);
 
-			QPainter painter(&m_pixmap);
+			QPainter painter(&m_image);
 
 			m_page->mainFrame()->render(&painter, QWebFrame::ContentsLayer, QRegion(QRect(QPoint(0, 0), contentsSize)));
 
 			painter.end();
-
-			if (m_pixmap.size() != m_size)
-			{
-				m_pixmap = m_pixmap.scaled(m_size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-			}
 		}
 	}
 
@@ -562,7 +557,17 @@ QString QtWebKitWebPageThumbnailJob::getTitle() const
 
 QPixmap QtWebKitWebPageThumbnailJob::getThumbnail() const
 {
-	return m_pixmap;
+	if (m_image.isNull() || m_size.isNull() || m_image.size() == m_size)
+	{
+		return QPixmap::fromImage(m_image);
+	}
+
+	return QPixmap::fromImage(m_image.scaled(m_size, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+}
+
+QImage QtWebKitWebPageThumbnailJob::getThumbnailImage() const
+{
+	return m_image;
 }
 
 bool QtWebKitWebPageThumbnailJob::isRunning() const
@@ -117,6 +117,7 @@ public:
 
 	QString getTitle() const override;
 	QPixmap getThumbnail() const override;
+	QImage getThumbnailImage() const override;
 	bool isRunning() const override;
 
 public slots:
@@ -131,7 +132,7 @@ private:
 	QString m_title;
 	QUrl m_url;
 	QSize m_size;
-	QPixmap m_pixmap;
+	QImage m_image;
 };
 
 }
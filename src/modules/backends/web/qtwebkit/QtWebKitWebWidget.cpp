@@ -30,6 +30,7 @@
 #include "../../../../core/ContentFiltersManager.h"
 #include "../../../../core/GesturesManager.h"
 #include "../../../../core/HistoryManager.h"
+#include "../../../../core/HostLookupManager.h"
 #include "../../../../core/JsonSettings.h"
 #include "../../../../core/NetworkCache.h"
 #include "../../../../core/NetworkManager.h"
@@ -102,6 +103,7 @@ QtWebKitWebWidget::QtWebKitWebWidget(const QVariantMap &parameters, WebBackend *
 	m_loadingState(FinishedLoadingState),
 	m_amountOfDeferredPlugins(0),
 	m_transfersTimer(0),
+	m_thumbnailRevision(0),
 	m_canLoadPlugins(false),
 	m_isAudioMuted(false),
 	m_isFullScreen(false),
@@ -153,6 +155,13 @@ QtWebKitWebWidget::QtWebKitWebWidget(const QVariantMap &parameters, WebBackend *
 	connect(m_page, &QtWebKitPage::downloadRequested, this, &QtWebKitWebWidget::handleDownloadRequested);
 	connect(m_page, &QtWebKitPage::unsupportedContent, this, &QtWebKitWebWidget::handleUnsupportedContent);
 	connect(m_page, &QtWebKitPage::linkHovered, this, &QtWebKitWebWidget::setStatusMessageOverride);
+	connect(m_page, &QtWebKitPage::linkHovered, [&](const QString &link)
+	{
+		if (!link.isEmpty() && getOption(SettingsManager::Network_EnableDnsPrefetchOption).toBool())
+		{
+			HostLookupManager::prefetchHost(QUrl(link));
+		}
+	});
 	connect(m_page, &QtWebKitPage::microFocusChanged, [&]()
 	{
 		emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::EditingCategory});
@@ -166,6 +175,14 @@ QtWebKitWebWidget::QtWebKitWebWidget(const QVariantMap &parameters, WebBackend *
 	connect(m_page, &QtWebKitPage::loadProgress, this, &QtWebKitWebWidget::handleLoadProgress);
 	connect(m_page, &QtWebKitPage::loadFinished, this, &QtWebKitWebWidget::handleLoadFinished);
 	connect(m_page, &QtWebKitPage::recentlyAudibleChanged, this, &QtWebKitWebWidget::isAudibleChanged);
+	connect(m_page, &QtWebKitPage::repaintRequested, this, [&]()
+	{
+		++m_thumbnailRevision;
+	});
+	connect(m_page, &QtWebKitPage::scrollRequested, this, [&]()
+	{
+		++m_thumbnailRevision;
+	});
 	connect(m_page->mainFrame(), &QWebFrame::titleChanged, this, &QtWebKitWebWidget::notifyTitleChanged);
 	connect(m_page->mainFrame(), &QWebFrame::urlChanged, this, &QtWebKitWebWidget::notifyUrlChanged);
 	connect(m_page->mainFrame(), &QWebFrame::iconChanged, this, &QtWebKitWebWidget::notifyIconChanged);
@@ -1421,7 +1438,7 @@ void QtWebKitWebWidget::handleLoadStarted()
 		return;
 	}
 
-	m_thumbnail = {};
+	m_thumbnails.clear();
 	m_messageToken = QUuid::createUuid().toString();
 	m_canLoadPlugins = (getOption(SettingsManager::Permissions_EnablePluginsOption, getUrl()).toString() == QLatin1String("enabled"));
 	m_loadingState = OngoingLoadingState;
@@ -1453,7 +1470,8 @@ void QtWebKitWebWidget::handleLoadFinished(bool result)
 
 	m_networkManager->handleLoadFinished(result);
 
-	m_thumbnail = {};
+	++m_thumbnailRevision;
+
 	m_loadingState = FinishedLoadingState;
 
 	updateAmountOfDeferredPlugins();
@@ -2122,55 +2140,82 @@ QIcon QtWebKitWebWidget::getIcon() const
 
 QPixmap QtWebKitWebWidget::createThumbnail(const QSize &size)
 {
-	if ((size.isNull() || size == m_thumbnail.size()) && ((!m_thumbnail.isNull() && qFuzzyCompare(m_thumbnail.devicePixelRatio(), devicePixelRatio())) || m_loadingState == OngoingLoadingState))
+	const QSize thumbnailSize(size.isValid() ? size : QSize(DefaultThumbnailWidth, DefaultThumbnailHeight));
+	int index(-1);
+
+	for (int i = 0; i < m_thumbnails.count(); ++i)
 	{
-		return m_thumbnail;
+		if (m_thumbnails.at(i).size == thumbnailSize && qFuzzyCompare(m_thumbnails.at(i).pixmap.devicePixelRatio(), devicePixelRatio()))
+		{
+			index = i;
+
+			break;
+		}
 	}
 
-	const QSize thumbnailSize(size.isValid() ? size : QSize(260, 170));
-	const QSize oldViewportSize(m_page->viewportSize());
-	const QPoint position(m_page->mainFrame()->scrollPosition());
-	const qreal zoom(m_page->mainFrame()->zoomFactor());
-	QSize contentsSize(m_page->mainFrame()->contentsSize());
-	QWidget *newView(new QWidget());
-	QWidget *oldView(m_page->view());
+	if (index >= 0 && (m_loadingState == OngoingLoadingState || m_thumbnails.at(index).revision == m_thumbnailRevision || m_thumbnails.at(index).updateTime.elapsed() < ThumbnailUpdateInterval))
+	{
+		return m_thumbnails.at(index).pixmap;
+	}
 
-	m_page->setView(newView);
-	m_page->setViewportSize(contentsSize);
-	m_page->mainFrame()->setZoomFactor(1);
+	if (m_loadingState == OngoingLoadingState)
+	{
+		return {};
+	}
+
+	const QSize viewportSize(m_page->viewportSize().isEmpty() ? m_webView->size() : m_page->viewportSize());
+	const QPixmap pixmap(renderThumbnail(thumbnailSize, viewportSize));
 
-	if (contentsSize.width() > 2000)
+	if (pixmap.isNull())
 	{
-		contentsSize.setWidth(2000);
+		return ((index >= 0) ? m_thumbnails.at(index).pixmap : QPixmap());
 	}
 
-	contentsSize.setHeight(qRound(thumbnailSize.height() * (static_cast<qreal>(contentsSize.width()) / thumbnailSize.width())));
+	if (index < 0)
+	{
+		if (m_thumbnails.count() >= MaximumThumbnailsAmount)
+		{
+			m_thumbnails.removeFirst();
+		}
+
+		ThumbnailInformation thumbnail;
+		thumbnail.size = thumbnailSize;
+
+		m_thumbnails.append(thumbnail);
+
+		index = (m_thumbnails.count() - 1);
+	}
+
+	ThumbnailInformation &thumbnail(m_thumbnails[index]);
+	thumbnail.pixmap = pixmap;
+	thumbnail.revision = m_thumbnailRevision;
+	thumbnail.updateTime.start();
 
-	m_page->setViewportSize(contentsSize);
+	return pixmap;
+}
+
+QPixmap QtWebKitWebWidget::renderThumbnail(const QSize &thumbnailSize, const QSize &viewportSize) const
+{
+	if (viewportSize.isEmpty())
+	{
+		return {};
+	}
 
-	QPixmap pixmap(contentsSize);
+	const qreal scale((thumbnailSize.width() * devicePixelRatio()) / viewportSize.width());
+	const QSize sourceSize(viewportSize.width(), qMin(viewportSize.height(), qRound(thumbnailSize.height() * (static_cast<qreal>(viewportSize.width()) / thumbnailSize.width()))));
+	QPixmap pixmap((QSizeF(sourceSize) * scale).toSize());
 	pixmap.fill(Qt::white);
 
 	QPainter painter(&pixmap);
+	painter.setRenderHint(QPainter::SmoothPixmapTransform);
+	painter.scale(scale, scale);
 
-	m_page->mainFrame()->render(&painter, QWebFrame::ContentsLayer, QRegion(QRect(QPoint(0, 0), contentsSize)));
-	m_page->mainFrame()->setZoomFactor(zoom);
-	m_page->setView(oldView);
-	m_page->setViewportSize(oldViewportSize);
-	m_page->mainFrame()->setScrollPosition(position);
+	m_page->mainFrame()->render(&painter, QWebFrame::ContentsLayer, QRegion(QRect(QPoint(0, 0), sourceSize)));
 
 	painter.end();
 
-	pixmap = pixmap.scaled((thumbnailSize * devicePixelRatio()), Qt::KeepAspectRatio, Qt::SmoothTransformation);
 	pixmap.setDevicePixelRatio(devicePixelRatio());
 
-	newView->deleteLater();
-
-	if (size.isNull())
-	{
-		m_thumbnail = pixmap;
-	}
-
 	return pixmap;
 }
 
@@ -2577,6 +2622,14 @@ WebWidget::LoadingState QtWebKitWebWidget::getLoadingState() const
 	return m_loadingState;
 }
 
+qint64 QtWebKitWebWidget::getMemoryUsage() const
+{
+// Heuristic only, QtWebKit does not expose per page memory usage, so received bytes and viewport backing store are used as a proxy
+	const QSize viewportSize(m_page->viewportSize());
+
+	return (m_networkManager->getPageInformation(TotalBytesReceivedInformation).toLongLong() + (static_cast<qint64>(viewportSize.width()) * viewportSize.height() * 4));
+}
+
 int QtWebKitWebWidget::getZoom() const
 {
 	return static_cast<int>(m_page->mainFrame()->zoomFactor() * 100);
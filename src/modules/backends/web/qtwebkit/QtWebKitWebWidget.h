@@ -23,6 +23,7 @@
 
 #include "../../../../ui/WebWidget.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QQueue>
 #include <QtNetwork/QNetworkReply>
 #include <QtWebKitWidgets/QWebInspector>
@@ -87,6 +88,7 @@ public:
 	QMultiMap<QString, QString> getMetaData() const override;
 	ContentStates getContentState() const override;
 	LoadingState getLoadingState() const override;
+	qint64 getMemoryUsage() const override;
 	int getZoom() const override;
 	bool hasSelection() const override;
 	bool hasWatchedChanges(ChangeWatcher watcher) const override;
@@ -118,6 +120,22 @@ protected:
 		VisitTimeEntryData
 	};
 
+	enum ThumbnailLimit
+	{
+		ThumbnailUpdateInterval = 1000,
+		DefaultThumbnailWidth = 260,
+		DefaultThumbnailHeight = 170,
+		MaximumThumbnailsAmount = 4
+	};
+
+	struct ThumbnailInformation final
+	{
+		QPixmap pixmap;
+		QSize size;
+		QElapsedTimer updateTime;
+		int revision = -1;
+	};
+
 	explicit QtWebKitWebWidget(const QVariantMap &parameters, WebBackend *backend, QtWebKitNetworkManager *networkManager = nullptr, ContentsWidget *parent = nullptr);
 
 	void timerEvent(QTimerEvent *event) override;
@@ -137,6 +155,7 @@ protected:
 	QtWebKitPage* getPage() const;
 	QString getMessageToken() const;
 	QString getPluginToken() const;
+	QPixmap renderThumbnail(const QSize &thumbnailSize, const QSize &viewportSize) const;
 	QUrl resolveUrl(QWebFrame *frame, const QUrl &url) const;
 	QVector<LinkUrl> getLinks(const QString &query) const;
 	int getAmountOfDeferredPlugins() const override;
@@ -184,7 +203,7 @@ private:
 	QtWebKitNetworkManager *m_networkManager;
 	QString m_messageToken;
 	QString m_pluginToken;
-	QPixmap m_thumbnail;
+	QVector<ThumbnailInformation> m_thumbnails;
 	QNetworkRequest m_formRequest;
 	QByteArray m_formRequestBody;
 	QQueue<Transfer*> m_transfers;
@@ -193,6 +212,7 @@ private:
 	LoadingState m_loadingState;
 	int m_amountOfDeferredPlugins;
 	int m_transfersTimer;
+	int m_thumbnailRevision;
 	bool m_canLoadPlugins;
 	bool m_isAudioMuted;
 	bool m_isFullScreen;
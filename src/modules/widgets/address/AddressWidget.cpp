@@ -27,6 +27,7 @@
 #include "../../../core/FeedsManager.h"
 #include "../../../core/InputInterpreter.h"
 #include "../../../core/HistoryManager.h"
+#include "../../../core/HostLookupManager.h"
 #include "../../../core/SearchEnginesManager.h"
 #include "../../../core/ThemesManager.h"
 #include "../../../core/Utils.h"
@@ -945,40 +946,45 @@ void AddressWidget::handleUserInput(const QString &text, SessionsManager::OpenHi
 		hints = SessionsManager::calculateOpenHints(SessionsManager::CurrentTabOpen);
 	}
 
-	if (!text.isEmpty())
+	if (text.isEmpty())
 	{
-		const InputInterpreter::InterpreterResult result(InputInterpreter::interpret(text));
+		return;
+	}
 
-		if (result.isValid())
+	InputInterpreter::interpret(text, InputInterpreter::NoFlags, this, [=](const InputInterpreter::InterpreterResult &result)
+	{
+		if (!result.isValid())
 		{
-			MainWindow *mainWindow(m_window ? MainWindow::findMainWindow(m_window) : MainWindow::findMainWindow(this));
-			ActionExecutor::Object executor(mainWindow, mainWindow);
+			return;
+		}
 
-			switch (result.type)
-			{
-				case InputInterpreter::InterpreterResult::BookmarkType:
-					if (executor.isValid())
-					{
-						executor.triggerAction(ActionsManager::OpenBookmarkAction, {{QLatin1String("bookmark"), result.bookmark->getIdentifier()}, {QLatin1String("hints"), QVariant(hints)}});
-					}
+		MainWindow *mainWindow(m_window ? MainWindow::findMainWindow(m_window) : MainWindow::findMainWindow(this));
+		ActionExecutor::Object executor(mainWindow, mainWindow);
 
-					break;
-				case InputInterpreter::InterpreterResult::UrlType:
-					if (executor.isValid())
-					{
-						executor.triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), result.url}, {QLatin1String("hints"), QVariant(hints)}});
-					}
+		switch (result.type)
+		{
+			case InputInterpreter::InterpreterResult::BookmarkType:
+				if (executor.isValid())
+				{
+					executor.triggerAction(ActionsManager::OpenBookmarkAction, {{QLatin1String("bookmark"), result.bookmark->getIdentifier()}, {QLatin1String("hints"), QVariant(hints)}});
+				}
 
-					break;
-				case InputInterpreter::InterpreterResult::SearchType:
-					emit requestedSearch(result.searchQuery, result.searchEngine, hints);
+				break;
+			case InputInterpreter::InterpreterResult::UrlType:
+				if (executor.isValid())
+				{
+					executor.triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), result.url}, {QLatin1String("hints"), QVariant(hints)}});
+				}
 
-					break;
-				default:
-					break;
-			}
+				break;
+			case InputInterpreter::InterpreterResult::SearchType:
+				emit requestedSearch(result.searchQuery, result.searchEngine, hints);
+
+				break;
+			default:
+				break;
 		}
-	}
+	});
 }
 
 void AddressWidget::updateGeometries()
@@ -1274,6 +1280,11 @@ void AddressWidget::setCompletion(const QString &filter)
 		return;
 	}
 
+	for (int i = 0; i < qMin(m_completionModel->rowCount(), 5); ++i)
+	{
+		HostLookupManager::prefetchHost(m_completionModel->index(i).data(AddressCompletionModel::UrlRole).toUrl());
+	}
+
 	if (m_completionModes.testFlag(PopupCompletionMode))
 	{
 		showCompletion(false);
@@ -1285,7 +1296,7 @@ void AddressWidget::setCompletion(const QString &filter)
 		{
 			const QString matchedText(m_completionModel->index(i).data(AddressCompletionModel::MatchRole).toString());
 
-			if (!matchedText.isEmpty())
+			if (matchedText.startsWith(filter, Qt::CaseInsensitive))
 			{
 				LineEditWidget::setCompletion(matchedText);
 
@@ -285,9 +285,19 @@ void TransferActionWidget::updateState()
 	m_detailsLabel->setText(QLatin1String("<small>") + details + QLatin1String("</small>"));
 	m_iconLabel->setPixmap(QIcon::fromTheme(iconName, QFileIconProvider().icon(iconName)).pixmap(32, 32));
 	m_progressBar->setHasError(hasError);
-	m_progressBar->setRange(0, ((isIndeterminate && !hasError) ? 0 : 100));
-	m_progressBar->setValue(isIndeterminate ? (hasError ? 0 : -1) : ((m_transfer->getBytesTotal() > 0) ? qFloor(Utils::calculatePercent(m_transfer->getBytesReceived(), m_transfer->getBytesTotal())) : -1));
-	m_progressBar->setFormat(isIndeterminate ? tr("Unknown") : QLatin1String("%p%"));
+
+	if (m_transfer->getState() == Transfer::QueuedState)
+	{
+		m_progressBar->setRange(0, 100);
+		m_progressBar->setValue(0);
+		m_progressBar->setFormat(tr("Queued"));
+	}
+	else
+	{
+		m_progressBar->setRange(0, ((isIndeterminate && !hasError) ? 0 : 100));
+		m_progressBar->setValue(isIndeterminate ? (hasError ? 0 : -1) : ((m_transfer->getBytesTotal() > 0) ? qFloor(Utils::calculatePercent(m_transfer->getBytesReceived(), m_transfer->getBytesTotal())) : -1));
+		m_progressBar->setFormat(isIndeterminate ? tr("Unknown") : QLatin1String("%p%"));
+	}
 
 	switch (m_transfer->getState())
 	{
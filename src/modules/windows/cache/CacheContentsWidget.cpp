@@ -19,7 +19,6 @@
 
 #include "CacheContentsWidget.h"
 #include "../../../core/HistoryManager.h"
-#include "../../../core/NetworkCache.h"
 #include "../../../core/NetworkManagerFactory.h"
 #include "../../../core/ThemesManager.h"
 #include "../../../core/Utils.h"
@@ -117,18 +116,36 @@ void CacheContentsWidget::populateCache()
 	m_model->setHeaderData(2, Qt::Horizontal, 150, HeaderViewWidget::WidthRole);
 	m_model->setSortRole(Qt::DisplayRole);
 
-	const NetworkCache *cache(NetworkManagerFactory::getCache());
-	const QVector<QUrl> entries(cache->getEntries());
+	m_pendingEntries = NetworkManagerFactory::getCache()->getEntries();
 
-	for (int i = 0; i < entries.count(); ++i)
+	populateEntries();
+}
+
+void CacheContentsWidget::populateEntries()
+{
+	const int amount(qMax(0, (m_pendingEntries.count() - 500)));
+
+	for (int i = (m_pendingEntries.count() - 1); i >= amount; --i)
+	{
+		addEntry(m_pendingEntries.at(i), false);
+	}
+
+	m_pendingEntries.resize(amount);
+
+	if (!m_pendingEntries.isEmpty())
 	{
-		handleEntryAdded(entries.at(i));
+		QTimer::singleShot(0, this, &CacheContentsWidget::populateEntries);
+
+		return;
 	}
 
+	m_pendingEntries.squeeze();
 	m_model->sort(0);
 
 	if (m_isLoading)
 	{
+		const NetworkCache *cache(NetworkManagerFactory::getCache());
+
 		m_ui->cacheViewWidget->setModel(m_model);
 		m_ui->cacheViewWidget->setLayoutDirection(Qt::LeftToRight);
 		m_ui->cacheViewWidget->setFilterRoles({Qt::DisplayRole, Qt::UserRole});
@@ -220,16 +237,16 @@ void CacheContentsWidget::copyEntryLink()
 	}
 }
 
-void CacheContentsWidget::handleEntryAdded(const QUrl &entry)
+void CacheContentsWidget::addEntry(const NetworkCache::Entry &entry, bool isIncremental)
 {
-	const QString domain(entry.host());
+	const QString domain(entry.url.host());
 	QStandardItem *domainItem(findDomain(domain));
 
 	if (domainItem)
 	{
-		for (int i = 0; i < domainItem->rowCount(); ++i)
+		for (int i = 0; (isIncremental && i < domainItem->rowCount()); ++i)
 		{
-			if (ItemModel::getItemData(domainItem->child(i, 0), Qt::UserRole).toUrl() == entry)
+			if (ItemModel::getItemData(domainItem->child(i, 0), Qt::UserRole).toUrl() == entry.url)
 			{
 				return;
 			}
@@ -243,62 +260,72 @@ void CacheContentsWidget::handleEntryAdded(const QUrl &entry)
 		m_model->appendRow(domainItem);
 		m_model->setItem(domainItem->row(), 2, new QStandardItem());
 
-		if (sender())
+		if (isIncremental)
 		{
 			m_model->sort(0);
 		}
 	}
 
-	NetworkCache *cache(NetworkManagerFactory::getCache());
-	QIODevice *device(cache->data(entry));
-	const QNetworkCacheMetaData metaData(cache->metaData(entry));
-	const QList<QPair<QByteArray, QByteArray> > headers(metaData.rawHeaders());
-	QString type;
-
-	for (int i = 0; i < headers.count(); ++i)
-	{
-		if (headers.at(i).first == QByteArrayLiteral("Content-Type"))
-		{
-			type = QString::fromLatin1(headers.at(i).second);
-
-			break;
-		}
-	}
-
-	const QMimeType mimeType((type.isEmpty() && device) ? QMimeDatabase().mimeTypeForData(device) : QMimeDatabase().mimeTypeForName(type));
-	QList<QStandardItem*> entryItems({new QStandardItem(entry.path()), new QStandardItem(mimeType.name()), new QStandardItem(device ? Utils::formatUnit(device->size()) : QString()), new QStandardItem(Utils::formatDateTime(metaData.lastModified())), new QStandardItem(Utils::formatDateTime(metaData.expirationDate()))});
-	entryItems[0]->setData(entry, Qt::UserRole);
+	const QString type(entry.contentType.section(QLatin1Char(';'), 0, 0).trimmed());
+	const QMimeType mimeType(type.isEmpty() ? QMimeDatabase().mimeTypeForUrl(entry.url) : QMimeDatabase().mimeTypeForName(type));
+	QList<QStandardItem*> entryItems({new QStandardItem(entry.url.path()), new QStandardItem(mimeType.name()), new QStandardItem(Utils::formatUnit(entry.size)), new QStandardItem(Utils::formatDateTime(entry.lastModified)), new QStandardItem(Utils::formatDateTime(entry.expirationDate))});
+	entryItems[0]->setData(entry.url, Qt::UserRole);
 	entryItems[0]->setFlags(entryItems[0]->flags() | Qt::ItemNeverHasChildren);
 	entryItems[1]->setFlags(entryItems[1]->flags() | Qt::ItemNeverHasChildren);
-	entryItems[2]->setData((device ? device->size() : 0), Qt::UserRole);
+	entryItems[2]->setData(entry.size, Qt::UserRole);
 	entryItems[2]->setFlags(entryItems[2]->flags() | Qt::ItemNeverHasChildren);
 	entryItems[3]->setFlags(entryItems[3]->flags() | Qt::ItemNeverHasChildren);
 	entryItems[4]->setFlags(entryItems[4]->flags() | Qt::ItemNeverHasChildren);
 
-	if (device)
+	if (entry.size > 0)
 	{
 		QStandardItem *sizeItem(m_model->item(domainItem->row(), 2));
 
 		if (sizeItem)
 		{
-			sizeItem->setData((sizeItem->data(Qt::UserRole).toLongLong() + device->size()), Qt::UserRole);
+			sizeItem->setData((sizeItem->data(Qt::UserRole).toLongLong() + entry.size), Qt::UserRole);
 			sizeItem->setText(Utils::formatUnit(sizeItem->data(Qt::UserRole).toLongLong()));
 		}
-
-		device->deleteLater();
 	}
 
 	domainItem->appendRow(entryItems);
 	domainItem->setText(QStringLiteral("%1 (%2)").arg(domain).arg(domainItem->rowCount()));
 
-	if (sender())
+	if (isIncremental)
 	{
 		domainItem->sortChildren(0, Qt::DescendingOrder);
 	}
 }
 
+void CacheContentsWidget::removePendingEntry(const QUrl &entry)
+{
+	for (int i = 0; i < m_pendingEntries.count(); ++i)
+	{
+		if (m_pendingEntries.at(i).url == entry)
+		{
+			m_pendingEntries.remove(i);
+
+			break;
+		}
+	}
+}
+
+void CacheContentsWidget::handleEntryAdded(const QUrl &entry)
+{
+	removePendingEntry(entry);
+
+	const NetworkCache::Entry cacheEntry(NetworkManagerFactory::getCache()->getEntry(entry));
+
+	if (cacheEntry.isValid())
+	{
+		addEntry(cacheEntry, true);
+	}
+}
+
 void CacheContentsWidget::handleEntryRemoved(const QUrl &entry)
 {
+	removePendingEntry(entry);
+
 	QStandardItem *domainItem(findDomain(Utils::extractHost(entry)));
 
 	if (!domainItem)
@@ -20,6 +20,7 @@
 #ifndef OTTER_CacheContentsWidget_H
 #define OTTER_CacheContentsWidget_H
 
+#include "../../../core/NetworkCache.h"
 #include "../../../ui/ContentsWidget.h"
 
 #include <QtGui/QStandardItemModel>
@@ -56,11 +57,14 @@ public slots:
 
 protected:
 	void changeEvent(QEvent *event) override;
+	void addEntry(const NetworkCache::Entry &entry, bool isIncremental);
+	void removePendingEntry(const QUrl &entry);
 	QStandardItem* findDomain(const QString &domain);
 	QUrl getEntry(const QModelIndex &index) const;
 
 protected slots:
 	void populateCache();
+	void populateEntries();
 	void removeEntry();
 	void removeDomainEntries();
 	void removeDomainEntriesOrEntry();
@@ -73,6 +77,7 @@ protected slots:
 
 private:
 	QStandardItemModel *m_model;
+	QVector<NetworkCache::Entry> m_pendingEntries;
 	bool m_isLoading;
 	Ui::CacheContentsWidget *m_ui;
 };
@@ -30,6 +30,7 @@
 #include <QtGui/QClipboard>
 #include <QtGui/QMouseEvent>
 #include <QtWidgets/QMenu>
+#include <QtWidgets/QScrollBar>
 
 namespace Otter
 {
@@ -72,9 +73,11 @@ HistoryContentsWidget::HistoryContentsWidget(const QVariantMap &parameters, Wind
 	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::entryModified, this, &HistoryContentsWidget::handleEntryModified);
 	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::entryRemoved, this, &HistoryContentsWidget::handleEntryRemoved);
 	connect(HistoryManager::getInstance(), &HistoryManager::dayChanged, this, &HistoryContentsWidget::populateEntries);
+	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, this, &HistoryContentsWidget::fetchAllEntries);
 	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, m_ui->historyViewWidget, &ItemViewWidget::setFilterString);
 	connect(m_ui->historyViewWidget, &ItemViewWidget::doubleClicked, this, &HistoryContentsWidget::openEntry);
 	connect(m_ui->historyViewWidget, &ItemViewWidget::customContextMenuRequested, this, &HistoryContentsWidget::showContextMenu);
+	connect(m_ui->historyViewWidget->verticalScrollBar(), &QScrollBar::valueChanged, this, &HistoryContentsWidget::fetchMoreEntries);
 }
 
 HistoryContentsWidget::~HistoryContentsWidget()
@@ -168,6 +171,32 @@ void HistoryContentsWidget::populateEntries()
 	emit loadingStateChanged(WebWidget::FinishedLoadingState);
 }
 
+void HistoryContentsWidget::fetchMoreEntries()
+{
+	const QScrollBar *scrollBar(m_ui->historyViewWidget->verticalScrollBar());
+	HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+
+	if (scrollBar->value() >= (scrollBar->maximum() - scrollBar->pageStep()) && model->canFetchMore({}))
+	{
+		model->fetchMore({});
+	}
+}
+
+void HistoryContentsWidget::fetchAllEntries()
+{
+	HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+
+	if (m_ui->filterLineEditWidget->text().isEmpty())
+	{
+		return;
+	}
+
+	while (model->canFetchMore({}))
+	{
+		model->fetchMore({});
+	}
+}
+
 void HistoryContentsWidget::removeEntry()
 {
 	const quint64 entry(getEntry(m_ui->historyViewWidget->currentIndex()));
@@ -68,6 +68,8 @@ protected:
 
 protected slots:
 	void populateEntries();
+	void fetchMoreEntries();
+	void fetchAllEntries();
 	void removeEntry();
 	void removeDomainEntries();
 	void openEntry();
@@ -180,6 +180,7 @@ void PageInformationContentsWidget::updateSections()
 					if (!m_window || m_window->getUrl().scheme() != QLatin1String("about"))
 					{
 						addEntry(sectionItem, tr("MIME type"), (canGetPageInformation ? m_window->getWebWidget()->getPageInformation(WebWidget::DocumentMimeTypeInformation).toString() : QString()));
+						addEntry(sectionItem, tr("Protocol"), (canGetPageInformation ? m_window->getWebWidget()->getPageInformation(WebWidget::DocumentProtocolInformation).toString() : QString()));
 						addEntry(sectionItem, tr("Document size"), (canGetPageInformation ? Utils::formatUnit(m_window->getWebWidget()->getPageInformation(WebWidget::DocumentBytesTotalInformation).toLongLong(), false, 1, true) : QString()));
 						addEntry(sectionItem, tr("Total size"), (canGetPageInformation ? Utils::formatUnit(m_window->getWebWidget()->getPageInformation(WebWidget::TotalBytesTotalInformation).toLongLong(), false, 1, true) : QString()));
 
@@ -192,6 +193,11 @@ void PageInformationContentsWidget::updateSections()
 							addEntry(sectionItem, tr("Number of requests"), (canGetPageInformation ? QString::number(m_window->getWebWidget()->getPageInformation(WebWidget::RequestsFinishedInformation).toInt()) : QString()));
 						}
 
+						if (canGetPageInformation && m_window->getWebWidget()->getPageInformation(WebWidget::RequestsMultiplexedInformation).toInt() > 0)
+						{
+							addEntry(sectionItem, tr("Requests over HTTP/2"), QString::number(m_window->getWebWidget()->getPageInformation(WebWidget::RequestsMultiplexedInformation).toInt()));
+						}
+
 						addEntry(sectionItem, tr("Downloaded"), (canGetPageInformation ? Utils::formatDateTime(m_window->getWebWidget()->getPageInformation(WebWidget::LoadingFinishedInformation).toDateTime(), {}, false) : QString()));
 					}
 				}
@@ -52,6 +52,16 @@ void ProgressBarDelegate::setEditorData(QWidget *editor, const QModelIndex &inde
 		const bool hasError(state == Transfer::UnknownState || state == Transfer::ErrorState);
 
 		progressBar->setHasError(hasError);
+
+		if (state == Transfer::QueuedState)
+		{
+			progressBar->setRange(0, 100);
+			progressBar->setValue(0);
+			progressBar->setFormat(tr("Queued"));
+
+			return;
+		}
+
 		progressBar->setRange(0, ((isIndeterminate && !hasError) ? 0 : 100));
 		progressBar->setValue(isIndeterminate ? (hasError ? 0 : -1) : index.data(TransfersContentsWidget::ProgressRole).toInt());
 		progressBar->setFormat(isIndeterminate ? tr("Unknown") : QLatin1String("%p%"));
@@ -189,7 +199,7 @@ void TransfersContentsWidget::stopResumeTransfer()
 
 	if (transfer)
 	{
-		if (transfer->getState() == Transfer::RunningState)
+		if (transfer->getState() == Transfer::RunningState || transfer->getState() == Transfer::QueuedState)
 		{
 			transfer->stop();
 		}
@@ -261,6 +271,10 @@ void TransfersContentsWidget::handleTransferChanged(Transfer *transfer)
 
 	switch (transfer->getState())
 	{
+		case Transfer::QueuedState:
+			icon = ThemesManager::createIcon(QLatin1String("media-playback-pause"));
+
+			break;
 		case Transfer::RunningState:
 			icon = ThemesManager::createIcon(QLatin1String("task-ongoing"));
 
@@ -399,7 +413,7 @@ void TransfersContentsWidget::showContextMenu(const QPoint &position)
 		menu.addMenu(openWithMenu);
 		menu.addAction(tr("Open Folder"), this, &TransfersContentsWidget::openTransferFolder)->setEnabled(canOpen || QFileInfo(transfer->getTarget()).dir().exists());
 		menu.addSeparator();
-		menu.addAction(((transfer->getState() == Transfer::ErrorState) ? tr("Resume") : tr("Stop")), this, &TransfersContentsWidget::stopResumeTransfer)->setEnabled(transfer->getState() == Transfer::RunningState || transfer->getState() == Transfer::ErrorState);
+		menu.addAction(((transfer->getState() == Transfer::ErrorState) ? tr("Resume") : tr("Stop")), this, &TransfersContentsWidget::stopResumeTransfer)->setEnabled(transfer->getState() == Transfer::RunningState || transfer->getState() == Transfer::QueuedState || transfer->getState() == Transfer::ErrorState);
 		menu.addAction(tr("Redownload"), this, &TransfersContentsWidget::redownloadTransfer);
 		menu.addSeparator();
 		menu.addAction(tr("Copy Transfer Information"), this, &TransfersContentsWidget::copyTransferInformation);
@@ -438,7 +452,7 @@ void TransfersContentsWidget::updateActions()
 		m_ui->stopResumeButton->setIcon(ThemesManager::createIcon(QLatin1String("task-reject")));
 	}
 
-	m_ui->stopResumeButton->setEnabled(transfer && (transfer->getState() == Transfer::RunningState || transfer->getState() == Transfer::ErrorState));
+	m_ui->stopResumeButton->setEnabled(transfer && (transfer->getState() == Transfer::RunningState || transfer->getState() == Transfer::QueuedState || transfer->getState() == Transfer::ErrorState));
 	m_ui->redownloadButton->setEnabled(transfer);
 
 	if (transfer)
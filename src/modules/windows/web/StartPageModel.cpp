@@ -24,17 +24,40 @@
 #include "../../../core/SettingsManager.h"
 #include "../../../core/WebBackend.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QMimeData>
+#include <QtCore/QSettings>
+#include <QtCore/QTimerEvent>
 #include <QtGui/QPainter>
 
 namespace Otter
 {
 
 StartPageModel::StartPageModel(QObject *parent) : QStandardItemModel(parent),
-	m_bookmark(nullptr)
+	m_bookmark(nullptr),
+	m_runningThumbnailJobs(0),
+	m_thumbnailJobsTimer(0)
 {
+	QSettings settings(getThumbnailsInformationPath(), QSettings::IniFormat);
+	const QStringList identifiers(settings.childGroups());
+
+	for (int i = 0; i < identifiers.count(); ++i)
+	{
+		settings.beginGroup(identifiers.at(i));
+
+		ThumbnailInformation information;
+		information.url = settings.value(QLatin1String("url")).toUrl();
+		information.size = settings.value(QLatin1String("size")).toSize();
+		information.timeCreated = settings.value(QLatin1String("timeCreated")).toDateTime();
+
+		m_thumbnails[identifiers.at(i).toULongLong()] = information;
+
+		settings.endGroup();
+	}
+
 	handleOptionChanged(SettingsManager::Backends_WebOption);
 	reloadModel();
 
@@ -80,7 +103,7 @@ void StartPageModel::reloadModel()
 					item->setData(true, IsEmptyRole);
 				}
 
-				if (url.isValid() && !QFile::exists(getThumbnailPath(identifier)))
+				if (url.isValid() && !isThumbnailValid(identifier, url))
 				{
 					requestThumbnail(url, identifier);
 				}
@@ -153,6 +176,107 @@ void StartPageModel::addTile(const QUrl &url)
 	}
 }
 
+void StartPageModel::setVisibleTiles(const QVector<quint64> &identifiers)
+{
+	m_visibleTiles.clear();
+
+	for (int i = 0; i < identifiers.count(); ++i)
+	{
+		m_visibleTiles.insert(identifiers.at(i));
+	}
+}
+
+void StartPageModel::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_thumbnailJobsTimer)
+	{
+		killTimer(m_thumbnailJobsTimer);
+
+		m_thumbnailJobsTimer = 0;
+
+		startThumbnailJobs();
+	}
+}
+
+void StartPageModel::startThumbnailJobs()
+{
+	while (m_runningThumbnailJobs < MaximumThumbnailJobsAmount && !m_thumbnailRequests.isEmpty())
+	{
+		int index(0);
+
+		for (int i = 0; i < m_thumbnailRequests.count(); ++i)
+		{
+			if (m_visibleTiles.contains(m_thumbnailRequests.at(i).identifier))
+			{
+				index = i;
+
+				break;
+			}
+		}
+
+		const ThumbnailRequest request(m_thumbnailRequests.takeAt(index));
+
+		++m_runningThumbnailJobs;
+
+		request.job->start();
+	}
+}
+
+void StartPageModel::finishThumbnail(quint64 identifier, const QString &title)
+{
+	if (!m_reloads.contains(identifier))
+	{
+		return;
+	}
+
+	const bool needsTitleUpdate(m_reloads.take(identifier));
+	BookmarksModel::Bookmark *bookmark(BookmarksManager::getModel()->getBookmark(identifier));
+
+	if (bookmark)
+	{
+		if (needsTitleUpdate)
+		{
+			bookmark->setData(title, BookmarksModel::TitleRole);
+		}
+
+		emit isReloadingTileChanged(index(bookmark->index().row(), bookmark->index().column()));
+	}
+}
+
+void StartPageModel::updateThumbnailInformation(quint64 identifier, const QUrl &url, const QSize &size)
+{
+	ThumbnailInformation information;
+	information.url = url;
+	information.size = size;
+	information.timeCreated = QDateTime::currentDateTimeUtc();
+
+	m_thumbnails[identifier] = information;
+
+	QSettings settings(getThumbnailsInformationPath(), QSettings::IniFormat);
+	settings.beginGroup(QString::number(identifier));
+	settings.setValue(QLatin1String("url"), information.url);
+	settings.setValue(QLatin1String("size"), information.size);
+	settings.setValue(QLatin1String("timeCreated"), information.timeCreated);
+	settings.endGroup();
+}
+
+void StartPageModel::removeThumbnail(quint64 identifier)
+{
+	const QString path(getThumbnailPath(identifier));
+
+	if (QFile::exists(path))
+	{
+		QFile::remove(path);
+	}
+
+	if (m_thumbnails.contains(identifier))
+	{
+		m_thumbnails.remove(identifier);
+
+		QSettings(getThumbnailsInformationPath(), QSettings::IniFormat).remove(QString::number(identifier));
+	}
+}
+
 void StartPageModel::handleOptionChanged(int identifier)
 {
 	switch (identifier)
@@ -208,12 +332,7 @@ void StartPageModel::handleBookmarkMoved(BookmarksModel::Bookmark *bookmark, Boo
 	{
 		if (bookmark->parent() != m_bookmark)
 		{
-			const QString path(getThumbnailPath(bookmark->getIdentifier()));
-
-			if (QFile::exists(path))
-			{
-				QFile::remove(path);
-			}
+			removeThumbnail(bookmark->getIdentifier());
 		}
 
 		if (bookmark == m_bookmark || previousParent == m_bookmark || m_bookmark->isAncestorOf(bookmark) || m_bookmark->isAncestorOf(previousParent))
@@ -227,45 +346,47 @@ void StartPageModel::handleBookmarkRemoved(BookmarksModel::Bookmark *bookmark, B
 {
 	if (m_bookmark && (bookmark == m_bookmark || previousParent == m_bookmark || m_bookmark->isAncestorOf(previousParent)))
 	{
-		const QString path(getThumbnailPath(bookmark->getIdentifier()));
-
-		if (QFile::exists(path))
-		{
-			QFile::remove(path);
-		}
+		removeThumbnail(bookmark->getIdentifier());
 
 		reloadModel();
 	}
 }
 
-void StartPageModel::handleThumbnailCreated(quint64 identifier, const QPixmap &thumbnail, const QString &title)
+void StartPageModel::handleThumbnailCreated(quint64 identifier, const QImage &thumbnail, const QString &title)
 {
 	if (!m_reloads.contains(identifier))
 	{
 		return;
 	}
 
-	const bool needsTitleUpdate(m_reloads[identifier]);
-	BookmarksModel::Bookmark *bookmark(BookmarksManager::getModel()->getBookmark(identifier));
+	const BookmarksModel::Bookmark *bookmark(BookmarksManager::getModel()->getBookmark(identifier));
 
-	m_reloads.remove(identifier);
-
-	if (!SessionsManager::isReadOnly() && !thumbnail.isNull() && bookmark)
+	if (SessionsManager::isReadOnly() || thumbnail.isNull() || !bookmark)
 	{
-		QDir().mkpath(SessionsManager::getWritableDataPath(QLatin1String("thumbnails/")));
+		finishThumbnail(identifier, title);
 
-		thumbnail.save(getThumbnailPath(identifier), "png");
+		return;
 	}
 
-	if (bookmark)
+	QDir().mkpath(SessionsManager::getWritableDataPath(QLatin1String("thumbnails/")));
+
+	const QUrl url(bookmark->getUrl());
+	const QSize size(getThumbnailSize());
+	QFutureWatcher<bool> *watcher(new QFutureWatcher<bool>(this));
+
+	connect(watcher, &QFutureWatcher<bool>::finished, this, [=]()
 	{
-		if (needsTitleUpdate)
+		if (watcher->result())
 		{
-			bookmark->setData(title, BookmarksModel::TitleRole);
+			updateThumbnailInformation(identifier, url, size);
 		}
 
-		emit isReloadingTileChanged(index(bookmark->index().row(), bookmark->index().column()));
-	}
+		finishThumbnail(identifier, title);
+
+		watcher->deleteLater();
+	});
+
+	watcher->setFuture(QtConcurrent::run(&StartPageModel::saveThumbnail, thumbnail, getThumbnailPath(identifier), size));
 }
 
 QMimeData* StartPageModel::mimeData(const QModelIndexList &indexes) const
@@ -306,6 +427,16 @@ QString StartPageModel::getThumbnailPath(quint64 identifier)
 	return SessionsManager::getWritableDataPath(QLatin1String("thumbnails/")) + QString::number(identifier) + QLatin1String(".png");
 }
 
+QString StartPageModel::getThumbnailsInformationPath()
+{
+	return SessionsManager::getWritableDataPath(QLatin1String("thumbnails/thumbnails.ini"));
+}
+
+QSize StartPageModel::getThumbnailSize()
+{
+	return {SettingsManager::getOption(SettingsManager::StartPage_TileWidthOption).toInt(), SettingsManager::getOption(SettingsManager::StartPage_TileHeightOption).toInt()};
+}
+
 QVariant StartPageModel::data(const QModelIndex &index, int role) const
 {
 	if (role == IsReloadingRole)
@@ -328,26 +459,52 @@ bool StartPageModel::requestThumbnail(const QUrl &url, quint64 identifier, bool
 		return false;
 	}
 
-	WebPageThumbnailJob *job(AddonsManager::getWebBackend()->createPageThumbnailJob(url, QSize(SettingsManager::getOption(SettingsManager::StartPage_TileWidthOption).toInt(), SettingsManager::getOption(SettingsManager::StartPage_TileHeightOption).toInt())));
+	if (m_reloads.contains(identifier))
+	{
+		if (needsTitleUpdate)
+		{
+			m_reloads[identifier] = true;
+		}
+
+		return true;
+	}
+
+	WebPageThumbnailJob *job(AddonsManager::getWebBackend()->createPageThumbnailJob(url, getThumbnailSize()));
+
+	if (!job)
+	{
+		return false;
+	}
 
-	if (job)
+	connect(job, &WebPageThumbnailJob::jobFinished, this, [=]()
 	{
-		connect(job, &WebPageThumbnailJob::jobFinished, this, [=]()
+		--m_runningThumbnailJobs;
+
+		handleThumbnailCreated(identifier, job->getThumbnailImage(), job->getTitle());
+
+		if (m_thumbnailJobsTimer == 0 && !m_thumbnailRequests.isEmpty())
 		{
-			handleThumbnailCreated(identifier, job->getThumbnail(), job->getTitle());
-		});
+			m_thumbnailJobsTimer = startTimer(0);
+		}
+	});
 
-		m_reloads[identifier] = needsTitleUpdate;
+	ThumbnailRequest request;
+	request.job = job;
+	request.identifier = identifier;
 
-		job->start();
+	m_thumbnailRequests.append(request);
 
-		return true;
+	m_reloads[identifier] = needsTitleUpdate;
+
+	if (m_thumbnailJobsTimer == 0)
+	{
+		m_thumbnailJobsTimer = startTimer(0);
 	}
 
-	return false;
+	return true;
 }
 
-bool StartPageModel::reloadTile(const QModelIndex &index, bool needsTitleUpdate)
+bool StartPageModel::reloadTile(const QModelIndex &index, bool needsTitleUpdate, bool isForced)
 {
 	if (static_cast<BookmarksModel::BookmarkType>(index.data(BookmarksModel::TypeRole).toInt()) != BookmarksModel::UrlBookmark)
 	{
@@ -363,6 +520,11 @@ bool StartPageModel::reloadTile(const QModelIndex &index, bool needsTitleUpdate)
 
 	const quint64 identifier(index.data(BookmarksModel::IdentifierRole).toULongLong());
 
+	if (!isForced && !needsTitleUpdate && isThumbnailValid(identifier, url, true))
+	{
+		return false;
+	}
+
 	if (url.scheme() == QLatin1String("about"))
 	{
 		const AddonsManager::SpecialPageInformation information(AddonsManager::getSpecialPage(url.path()));
@@ -374,14 +536,16 @@ bool StartPageModel::reloadTile(const QModelIndex &index, bool needsTitleUpdate)
 			return false;
 		}
 
-		const QSize size(SettingsManager::getOption(SettingsManager::StartPage_TileWidthOption).toInt(), SettingsManager::getOption(SettingsManager::StartPage_TileHeightOption).toInt());
-		QPixmap thumbnail(size);
+		const QSize size(getThumbnailSize());
+		QImage thumbnail(size, QImage::Format_ARGB32_Premultiplied);
 		thumbnail.fill(Qt::white);
 
 		QPainter painter(&thumbnail);
 
 		information.icon.paint(&painter, QRect(QPoint(0, 0), size));
 
+		painter.end();
+
 		m_reloads[identifier] = needsTitleUpdate;
 
 		handleThumbnailCreated(identifier, thumbnail, information.getTitle());
@@ -392,6 +556,38 @@ bool StartPageModel::reloadTile(const QModelIndex &index, bool needsTitleUpdate)
 	return requestThumbnail(url, identifier, needsTitleUpdate);
 }
 
+bool StartPageModel::isThumbnailValid(quint64 identifier, const QUrl &url, bool needsRecent) const
+{
+	if (!QFile::exists(getThumbnailPath(identifier)))
+	{
+		return false;
+	}
+
+	if (!m_thumbnails.contains(identifier))
+	{
+		return !needsRecent;
+	}
+
+	const ThumbnailInformation information(m_thumbnails.value(identifier));
+
+	if (information.url != url || information.size != getThumbnailSize())
+	{
+		return false;
+	}
+
+	return (!needsRecent || (information.timeCreated.isValid() && information.timeCreated.secsTo(QDateTime::currentDateTimeUtc()) < ThumbnailTimeToLive));
+}
+
+bool StartPageModel::saveThumbnail(const QImage &image, const QString &path, const QSize &size)
+{
+	if (!size.isEmpty() && image.size() != size)
+	{
+		return image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation).save(path, "png");
+	}
+
+	return image.save(path, "png");
+}
+
 bool StartPageModel::dropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent)
 {
 	Q_UNUSED(action)
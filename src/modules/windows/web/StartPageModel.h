@@ -22,9 +22,14 @@
 
 #include "../../../core/BookmarksModel.h"
 
+#include <QtCore/QDateTime>
+#include <QtCore/QSet>
+
 namespace Otter
 {
 
+class WebPageThumbnailJob;
+
 class StartPageModel final : public QStandardItemModel
 {
 	Q_OBJECT
@@ -43,16 +48,45 @@ public:
 	static QString getThumbnailPath(quint64 identifier);
 	QVariant data(const QModelIndex &index, int role) const override;
 	QStringList mimeTypes() const override;
-	bool reloadTile(const QModelIndex &index, bool needsTitleUpdate = false);
+	bool reloadTile(const QModelIndex &index, bool needsTitleUpdate = false, bool isForced = true);
 	bool dropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) override;
 	bool event(QEvent *event) override;
 
 public slots:
 	void reloadModel();
 	void addTile(const QUrl &url);
+	void setVisibleTiles(const QVector<quint64> &identifiers);
 
 protected:
+	enum ThumbnailLimit
+	{
+		MaximumThumbnailJobsAmount = 3,
+		ThumbnailTimeToLive = 3600
+	};
+
+	struct ThumbnailRequest final
+	{
+		WebPageThumbnailJob *job = nullptr;
+		quint64 identifier = 0;
+	};
+
+	struct ThumbnailInformation final
+	{
+		QUrl url;
+		QSize size;
+		QDateTime timeCreated;
+	};
+
+	void timerEvent(QTimerEvent *event) override;
+	void startThumbnailJobs();
+	void finishThumbnail(quint64 identifier, const QString &title);
+	void updateThumbnailInformation(quint64 identifier, const QUrl &url, const QSize &size);
+	void removeThumbnail(quint64 identifier);
+	static QString getThumbnailsInformationPath();
+	static QSize getThumbnailSize();
 	bool requestThumbnail(const QUrl &url, quint64 identifier, bool needsTitleUpdate = false);
+	bool isThumbnailValid(quint64 identifier, const QUrl &url, bool needsRecent = false) const;
+	static bool saveThumbnail(const QImage &image, const QString &path, const QSize &size);
 
 protected slots:
 	void handleOptionChanged(int identifier);
@@ -60,11 +94,16 @@ protected slots:
 	void handleBookmarkModified(BookmarksModel::Bookmark *bookmark);
 	void handleBookmarkMoved(BookmarksModel::Bookmark *bookmark, BookmarksModel::Bookmark *previousParent);
 	void handleBookmarkRemoved(BookmarksModel::Bookmark *bookmark, BookmarksModel::Bookmark *previousParent);
-	void handleThumbnailCreated(quint64 identifier, const QPixmap &thumbnail, const QString &title);
+	void handleThumbnailCreated(quint64 identifier, const QImage &thumbnail, const QString &title);
 
 private:
 	BookmarksModel::Bookmark *m_bookmark;
+	QList<ThumbnailRequest> m_thumbnailRequests;
+	QSet<quint64> m_visibleTiles;
+	QHash<quint64, ThumbnailInformation> m_thumbnails;
 	QHash<quint64, bool> m_reloads;
+	int m_runningThumbnailJobs;
+	int m_thumbnailJobsTimer;
 
 signals:
 	void modelModified();
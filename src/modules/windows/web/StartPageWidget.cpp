@@ -532,6 +532,8 @@ StartPageWidget::StartPageWidget(Window *parent) : QScrollArea(parent),
 	}
 
 	connect(m_model, &StartPageModel::modelModified, this, &StartPageWidget::updateSize);
+	connect(horizontalScrollBar(), &QScrollBar::valueChanged, this, &StartPageWidget::updateVisibleTiles);
+	connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &StartPageWidget::updateVisibleTiles);
 	connect(m_model, &StartPageModel::isReloadingTileChanged, this, &StartPageWidget::handleIsReloadingTileChanged);
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &StartPageWidget::handleOptionChanged);
 }
@@ -695,7 +697,7 @@ void StartPageWidget::triggerAction(int identifier, const QVariantMap &parameter
 
 				for (int i = 0; i < m_model->rowCount(); ++i)
 				{
-					if (m_model->reloadTile(m_model->index(i, 0)))
+					if (m_model->reloadTile(m_model->index(i, 0), false, false))
 					{
 						isReloading = true;
 					}
@@ -1030,6 +1032,27 @@ void StartPageWidget::updateSize()
 	m_tileDelegate->setPixmapCachePrefix(m_contentsWidget->getPixmapCachePrefix());
 
 	m_thumbnail = {};
+
+	updateVisibleTiles();
+}
+
+void StartPageWidget::updateVisibleTiles()
+{
+	const QRect viewportRectangle(viewport()->rect());
+	QVector<quint64> identifiers;
+
+	for (int i = 0; i < m_model->rowCount(); ++i)
+	{
+		const QModelIndex index(m_model->index(i, 0));
+		const QRect rectangle(m_listView->visualRect(index));
+
+		if (!rectangle.isEmpty() && viewportRectangle.intersects(QRect(m_listView->viewport()->mapTo(viewport(), rectangle.topLeft()), rectangle.size())))
+		{
+			identifiers.append(index.data(BookmarksModel::IdentifierRole).toULongLong());
+		}
+	}
+
+	m_model->setVisibleTiles(identifiers);
 }
 
 void StartPageWidget::showContextMenu(const QPoint &position)
@@ -138,6 +138,7 @@ protected slots:
 	void handleOptionChanged(int identifier, const QVariant &value);
 	void handleIsReloadingTileChanged(const QModelIndex &index);
 	void updateSize();
+	void updateVisibleTiles();
 	void showContextMenu(const QPoint &position = {});
 
 private:
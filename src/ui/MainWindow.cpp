@@ -611,36 +611,35 @@ void MainWindow::triggerAction(int identifier, const QVariantMap &parameters, Ac
 				{
 					if (parameters.value(QLatin1String("needsInterpretation"), false).toBool())
 					{
-						const InputInterpreter::InterpreterResult result(InputInterpreter::interpret(parameters[QLatin1String("url")].toString(), InputInterpreter::NoBookmarkKeywordsFlag));
-
-						if (!result.isValid())
+						InputInterpreter::interpret(parameters[QLatin1String("url")].toString(), InputInterpreter::NoBookmarkKeywordsFlag, this, [=](const InputInterpreter::InterpreterResult &result)
 						{
-							return;
-						}
+							QVariantMap mutableParameters(parameters);
+							mutableParameters.remove(QLatin1String("needsInterpretation"));
 
-						switch (result.type)
-						{
-							case InputInterpreter::InterpreterResult::BookmarkType:
-								{
-									QVariantMap mutableParameters(parameters);
-									mutableParameters.remove(QLatin1String("needsInterpretation"));
+							switch (result.type)
+							{
+								case InputInterpreter::InterpreterResult::BookmarkType:
 									mutableParameters[QLatin1String("bookmark")] = result.bookmark->getIdentifier();
 
 									triggerAction(ActionsManager::OpenBookmarkAction, mutableParameters, trigger);
-								}
 
-								return;
-							case InputInterpreter::InterpreterResult::UrlType:
-								url = result.url;
+									break;
+								case InputInterpreter::InterpreterResult::UrlType:
+									mutableParameters[QLatin1String("url")] = result.url;
 
-								break;
-							case InputInterpreter::InterpreterResult::SearchType:
-								search(result.searchQuery, result.searchEngine, SessionsManager::calculateOpenHints(parameters, (trigger == ActionsManager::KeyboardTrigger || trigger == ActionsManager::MouseTrigger)));
+									triggerAction(ActionsManager::OpenUrlAction, mutableParameters, trigger);
 
-								return;
-							default:
-								return;
-						}
+									break;
+								case InputInterpreter::InterpreterResult::SearchType:
+									search(result.searchQuery, result.searchEngine, SessionsManager::calculateOpenHints(parameters, (trigger == ActionsManager::KeyboardTrigger || trigger == ActionsManager::MouseTrigger)));
+
+									break;
+								default:
+									break;
+							}
+						});
+
+						return;
 					}
 					else
 					{
@@ -32,7 +32,8 @@ namespace Otter
 OpenAddressDialog::OpenAddressDialog(const ActionExecutor::Object &executor, QWidget *parent) : Dialog(parent),
 	m_addressWidget(nullptr),
 	m_executor(executor),
-	m_ui(new Ui::OpenAddressDialog)
+	m_ui(new Ui::OpenAddressDialog),
+	m_isInterpreting(false)
 {
 	m_ui->setupUi(this);
 
@@ -41,8 +42,6 @@ OpenAddressDialog::OpenAddressDialog(const ActionExecutor::Object &executor, QWi
 
 	m_ui->verticalLayout->insertWidget(1, m_addressWidget);
 	m_ui->label->setBuddy(m_addressWidget);
-
-	connect(this, &OpenAddressDialog::accepted, this, &OpenAddressDialog::handleUserInput);
 }
 
 OpenAddressDialog::~OpenAddressDialog()
@@ -74,33 +73,54 @@ void OpenAddressDialog::keyPressEvent(QKeyEvent *event)
 	}
 }
 
-void OpenAddressDialog::handleUserInput()
+void OpenAddressDialog::accept()
 {
+	if (m_isInterpreting)
+	{
+		return;
+	}
+
 	const QString text(m_addressWidget->text().trimmed());
 
-	if (!text.isEmpty())
+	if (text.isEmpty())
+	{
+		Dialog::accept();
+
+		return;
+	}
+
+	m_isInterpreting = true;
+
+	InputInterpreter::interpret(text, InputInterpreter::NoBookmarkKeywordsFlag, this, [=](const InputInterpreter::InterpreterResult &result)
 	{
-		m_result = InputInterpreter::interpret(text, InputInterpreter::NoBookmarkKeywordsFlag);
+		m_isInterpreting = false;
+
+		handleUserInput(result);
+	});
+}
+
+void OpenAddressDialog::handleUserInput(const InputInterpreter::InterpreterResult &result)
+{
+	m_result = result;
 
-		if (m_result.isValid() && m_executor.isValid())
+	if (m_result.isValid() && m_executor.isValid())
+	{
+		switch (m_result.type)
 		{
-			switch (m_result.type)
-			{
-				case InputInterpreter::InterpreterResult::BookmarkType:
-					m_executor.triggerAction(ActionsManager::OpenBookmarkAction, {{QLatin1String("bookmark"), m_result.bookmark->getIdentifier()}, {QLatin1String("hints"), QVariant(SessionsManager::calculateOpenHints(SessionsManager::CurrentTabOpen))}});
-
-					break;
-				case InputInterpreter::InterpreterResult::UrlType:
-					m_executor.triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), m_result.url}, {QLatin1String("hints"), QVariant(SessionsManager::calculateOpenHints(SessionsManager::CurrentTabOpen))}});
-
-					break;
-				default:
-					break;
-			}
+			case InputInterpreter::InterpreterResult::BookmarkType:
+				m_executor.triggerAction(ActionsManager::OpenBookmarkAction, {{QLatin1String("bookmark"), m_result.bookmark->getIdentifier()}, {QLatin1String("hints"), QVariant(SessionsManager::calculateOpenHints(SessionsManager::CurrentTabOpen))}});
+
+				break;
+			case InputInterpreter::InterpreterResult::UrlType:
+				m_executor.triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), m_result.url}, {QLatin1String("hints"), QVariant(SessionsManager::calculateOpenHints(SessionsManager::CurrentTabOpen))}});
+
+				break;
+			default:
+				break;
 		}
 	}
 
-	close();
+	Dialog::accept();
 }
 
 void OpenAddressDialog::setText(const QString &text)
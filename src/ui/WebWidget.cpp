@@ -1611,6 +1611,16 @@ SessionsManager::OpenHints WebWidget::mapOpenActionToOpenHints(int identifier)
 	return SessionsManager::DefaultOpen;
 }
 
+qint64 WebWidget::getMemoryUsage() const
+{
+	return -1;
+}
+
+qint64 WebWidget::getProcessIdentifier() const
+{
+	return QCoreApplication::applicationPid();
+}
+
 quint64 WebWidget::getWindowIdentifier() const
 {
 	return m_windowIdentifier;
@@ -130,11 +130,13 @@ public:
 		DocumentBytesTotalInformation,
 		DocumentLoadingProgressInformation,
 		DocumentMimeTypeInformation,
+		DocumentProtocolInformation,
 		TotalBytesReceivedInformation,
 		TotalBytesTotalInformation,
 		TotalLoadingProgressInformation,
 		RequestsBlockedInformation,
 		RequestsFinishedInformation,
+		RequestsMultiplexedInformation,
 		RequestsStartedInformation,
 		LoadingSpeedInformation,
 		LoadingFinishedInformation,
@@ -242,6 +244,8 @@ public:
 	virtual QMultiMap<QString, QString> getMetaData() const;
 	virtual WebWidget::ContentStates getContentState() const;
 	virtual WebWidget::LoadingState getLoadingState() const = 0;
+	virtual qint64 getMemoryUsage() const;
+	virtual qint64 getProcessIdentifier() const;
 	quint64 getWindowIdentifier() const;
 	virtual int getZoom() const = 0;
 	bool hasOption(int identifier) const;